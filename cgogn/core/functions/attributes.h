@@ -59,6 +59,18 @@ add_attribute(MESH& m, const std::string& name)
 	return m.attribute_containers_[CELL::ORBIT].template add_attribute<T>(name);
 }
 
+///////////////////
+// FrozenSurface //
+///////////////////
+
+template <typename T, typename CELL>
+typename mesh_traits<FrozenSurface>::template Attribute<T>*
+add_attribute(FrozenSurface& m, const std::string& name)
+{
+	static_assert(is_in_tuple<CELL, typename mesh_traits<FrozenSurface>::Cells>::value, "CELL not supported in this MESH");
+	return m.attribute_containers_[CELL::DIM].template add_attribute<T>(name);
+}
+
 /*****************************************************************************/
 
 // template <typename T, typename CELL, typename MESH>
@@ -79,6 +91,18 @@ get_attribute(const MESH& m, const std::string& name)
 	return m.attribute_containers_[CELL::ORBIT].template get_attribute<T>(name);
 }
 
+///////////////////
+// FrozenSurface //
+///////////////////
+
+template <typename T, typename CELL>
+typename mesh_traits<FrozenSurface>::template Attribute<T>*
+get_attribute(const FrozenSurface& m, const std::string& name)
+{
+	static_assert(is_in_tuple<CELL, typename mesh_traits<FrozenSurface>::Cells>::value, "CELL not supported in this MESH");
+	return m.attribute_containers_[CELL::DIM].template get_attribute<T>(name);
+}
+
 /*****************************************************************************/
 
 // template <typename CELL, typename MESH>
@@ -99,6 +123,18 @@ index_of(const MESH& m, CELL c)
 	return m.embedding(c);
 }
 
+///////////////////
+// FrozenSurface //
+///////////////////
+
+template <typename CELL>
+uint32
+index_of(const FrozenSurface&, CELL c)
+{
+	static_assert(is_in_tuple<CELL, typename mesh_traits<FrozenSurface>::Cells>::value, "CELL not supported in this MESH");
+	return c.index;
+}
+
 //////////////
 // MESHVIEW //
 //////////////
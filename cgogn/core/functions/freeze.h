@@ -0,0 +1,165 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_FUNCTIONS_FREEZE_H_
+#define CGOGN_CORE_FUNCTIONS_FREEZE_H_
+
+#include <cgogn/core/types/mesh_traits.h>
+#include <cgogn/core/functions/attributes.h>
+#include <cgogn/core/functions/traversals/global.h>
+
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/unique_ptr.h>
+
+#include <numeric>
+#include <algorithm>
+
+namespace cgogn
+{
+
+/*****************************************************************************/
+
+// std::unique_ptr<FrozenSurface> freeze(const MESH& m);
+
+/*****************************************************************************/
+
+///////////
+// CMap2 //
+///////////
+
+/**
+ * \brief builds an immutable compact snapshot of the topology of a surface.
+ * Vertices of the snapshot keep the index of their embedding in the map so that
+ * the vertex attributes of the map can directly be used on the snapshot.
+ * The vertices of the map must be embedded.
+ */
+inline std::unique_ptr<FrozenSurface> freeze(const CMap2& m)
+{
+	cgogn_message_assert(m.is_embedded<CMap2::Vertex>(), "freeze: vertices of the map must be embedded");
+
+	std::unique_ptr<FrozenSurface> result = make_unique<FrozenSurface>();
+	FrozenSurface& fs = *result;
+
+	// faces and half-edges
+
+	std::vector<Dart> faces;
+	foreach_cell(m, [&] (CMap2::Face f) -> bool { faces.push_back(f.dart); return true; });
+	const uint32 nb_faces = uint32(faces.size());
+
+	fs.face_offsets_.assign(nb_faces + 1u, 0u);
+	parallel_for(nb_faces, [&] (uint32 i)
+	{
+		uint32 nb = 0u;
+		m.foreach_dart_of_PHI1(faces[i], [&] (Dart) -> bool { ++nb; return true; });
+		fs.face_offsets_[i + 1u] = nb;
+	});
+	std::partial_sum(fs.face_offsets_.begin(), fs.face_offsets_.end(), fs.face_offsets_.begin());
+	const uint32 nb_halfedges = fs.face_offsets_.back();
+
+	std::vector<Dart> halfedge_dart(nb_halfedges);
+	std::vector<uint32> dart_halfedge(m.topology_.size(), INVALID_INDEX);
+	fs.halfedge_vertex_.resize(nb_halfedges);
+	parallel_for(nb_faces, [&] (uint32 i)
+	{
+		uint32 h = fs.face_offsets_[i];
+		m.foreach_dart_of_PHI1(faces[i], [&] (Dart d) -> bool
+		{
+			fs.halfedge_vertex_[h] = m.embedding(CMap2::Vertex(d));
+			halfedge_dart[h] = d;
+			dart_halfedge[d.index] = h;
+			++h;
+			return true;
+		});
+	});
+
+	fs.face_start_.resize(nb_halfedges);
+	for (uint32 i = 0u; i < nb_faces; ++i)
+		fs.face_start_.words_[fs.face_offsets_[i] / 64u] |= 1ull << (fs.face_offsets_[i] % 64u);
+	fs.face_start_.build_ranks();
+
+	// boundary darts (or phi2 fixed points in open maps) have no half-edge: their twins get INVALID_INDEX
+	fs.halfedge_twin_.resize(nb_halfedges);
+	parallel_for(nb_halfedges, [&] (uint32 h)
+	{
+		Dart d = halfedge_dart[h];
+		Dart d2 = m.phi2(d);
+		fs.halfedge_twin_[h] = d2 == d ? INVALID_INDEX : dart_halfedge[d2.index];
+	});
+
+	// edges: an edge is represented by the half-edge which is either on the boundary
+	// or has a lower index than its twin, and the edges are numbered in half-edge order
+
+	fs.edge_representative_.resize(nb_halfedges);
+	parallel_for(uint32(fs.edge_representative_.words_.size()), [&] (uint32 w)
+	{
+		uint64 bits = 0ull;
+		for (uint32 h = 64u * w, end = std::min(nb_halfedges, h + 64u); h < end; ++h)
+		{
+			if (fs.halfedge_twin_[h] == INVALID_INDEX || h < fs.halfedge_twin_[h])
+				bits |= 1ull << (h % 64u);
+		}
+		fs.edge_representative_.words_[w] = bits;
+	});
+	fs.edge_representative_.build_ranks();
+	const uint32 nb_edges = fs.edge_representative_.ranks_.back();
+
+	fs.edge_halfedge_.resize(nb_edges);
+	parallel_for(nb_halfedges, [&] (uint32 h)
+	{
+		if (fs.edge_representative_.test(h))
+			fs.edge_halfedge_[fs.edge_representative_.rank(h)] = h;
+	});
+
+	// vertices and their outgoing half-edges (counting sort of the half-edges by source vertex)
+
+	uint32 nb_vertex_indices = 0u;
+	for (uint32 vi : fs.halfedge_vertex_)
+		nb_vertex_indices = std::max(nb_vertex_indices, vi + 1u);
+
+	fs.vertex_offsets_.assign(nb_vertex_indices + 1u, 0u);
+	for (uint32 vi : fs.halfedge_vertex_)
+		++fs.vertex_offsets_[vi + 1u];
+	for (uint32 vi = 0u; vi < nb_vertex_indices; ++vi)
+	{
+		if (fs.vertex_offsets_[vi + 1u] > 0u)
+			fs.vertices_.push_back(vi);
+	}
+	std::partial_sum(fs.vertex_offsets_.begin(), fs.vertex_offsets_.end(), fs.vertex_offsets_.begin());
+
+	fs.vertex_halfedges_.resize(nb_halfedges);
+	std::vector<uint32> position(fs.vertex_offsets_.begin(), fs.vertex_offsets_.end() - 1);
+	for (uint32 h = 0u; h < nb_halfedges; ++h)
+		fs.vertex_halfedges_[position[fs.halfedge_vertex_[h]]++] = h;
+
+	// attributes containers
+
+	fs.attribute_containers_[FrozenSurface::Vertex::DIM].add_lines(nb_vertex_indices);
+	fs.attribute_containers_[FrozenSurface::Edge::DIM].add_lines(nb_edges);
+	fs.attribute_containers_[FrozenSurface::Face::DIM].add_lines(nb_faces);
+
+	return result;
+}
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_FUNCTIONS_FREEZE_H_
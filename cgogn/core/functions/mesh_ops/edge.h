@@ -44,7 +44,7 @@ namespace cgogn
 // CMap1 //
 ///////////
 
-CMap1::Vertex
+inline CMap1::Vertex
 cut_edge(CMap1& m, CMap1::Edge e, bool set_indices = true)
 {
 	Dart d = m.add_dart();
@@ -66,7 +66,7 @@ cut_edge(CMap1& m, CMap1::Edge e, bool set_indices = true)
 // CMap2 //
 ///////////
 
-CMap2::Vertex
+inline CMap2::Vertex
 cut_edge(CMap2& m, CMap2::Edge e, bool set_indices = true)
 {
 	Dart d1 = e.dart;
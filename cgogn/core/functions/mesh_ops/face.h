@@ -48,7 +48,7 @@ namespace cgogn
 // CMap1 //
 ///////////
 
-CMap1::Face
+inline CMap1::Face
 add_face(CMap1& m, uint32 size, bool set_indices = true)
 {
 	Dart d = m.add_dart();
@@ -74,7 +74,7 @@ add_face(CMap1& m, uint32 size, bool set_indices = true)
 // CMap2 //
 ///////////
 
-CMap2::Face
+inline CMap2::Face
 add_face(CMap2& m, uint32 size, bool set_indices = true)
 {
 	CMap2::Face f = add_face(static_cast<CMap1&>(m), size, false);
@@ -125,7 +125,7 @@ add_face(MESH& m, uint32 size, bool set_incides = true)
 // CMap2 //
 ///////////
 
-CMap2::Edge
+inline CMap2::Edge
 cut_face(CMap2& m, CMap2::Vertex v1, CMap2::Vertex v2, bool set_indices = true)
 {
 	Dart dd = m.phi_1(v1.dart);
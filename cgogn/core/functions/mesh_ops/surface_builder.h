@@ -0,0 +1,470 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_FUNCTIONS_MESH_OPS_SURFACE_BUILDER_H_
+#define CGOGN_CORE_FUNCTIONS_MESH_OPS_SURFACE_BUILDER_H_
+
+#include <cgogn/core/types/cmap/cmap2.h>
+#include <cgogn/core/functions/mesh_ops/face.h>
+
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/radix_sort.h>
+
+#include <cgogn/core/types/cmap/cmap_ops.h>
+#include <cgogn/core/functions/traversals/global.h>
+#include <cgogn/core/functions/attributes.h>
+
+#include <vector>
+#include <string>
+
+namespace cgogn
+{
+
+/**
+ * \brief summary of the sewing of the faces of a surface
+ *  - nb_sewn_edges: number of pairs of darts that were phi2-sewn
+ *  - nb_boundary_edges: number of darts that remained without opposite dart
+ *  - nb_non_manifold_edges: number of edges shared by more than two faces or by two faces of inconsistent orientations
+ *  - nb_holes: number of boundary faces that were created to close the surface
+ *  - nb_open_holes: number of holes that could not be closed (their darts keep phi2 as a fixed point)
+ */
+struct SewingReport
+{
+	uint32 nb_sewn_edges;
+	uint32 nb_boundary_edges;
+	uint32 nb_non_manifold_edges;
+	uint32 nb_holes;
+	uint32 nb_open_holes;
+};
+
+/*****************************************************************************/
+
+// uint32 close_holes(CMap2& m, uint32* nb_open_holes = nullptr);
+
+/*****************************************************************************/
+
+///////////
+// CMap2 //
+///////////
+
+/**
+ * \brief closes the holes of a surface: each cycle of darts that have no phi2 is filled with a boundary face,
+ * whose darts are marked as boundary (as done by add_face) and get the vertex embeddings of their opposite darts
+ * Each dart is walked at most once: a walk that comes back to a dart of another walk or that finds no free dart
+ * around a vertex (non manifold vertex or inconsistent orientation) leaves its hole open.
+ * If nb_open_holes is given, it receives the number of holes left open.
+ * \returns the number of closed holes
+ */
+inline uint32
+close_holes(CMap2& m, uint32* nb_open_holes = nullptr)
+{
+	uint32 nb_holes = 0u;
+	uint32 nb_open = 0u;
+	std::vector<Dart> hole;
+	DartMarker visited(m);
+	const uint32 nb_darts = m.nb_darts();
+	for (uint32 i = 0u; i < nb_darts; ++i)
+	{
+		const Dart d(i);
+		if (m.phi2(d) != d || m.is_boundary(d) || visited.is_marked(d))
+			continue;
+
+		// the next dart of the hole is the first dart without phi2 found by turning around the end vertex
+		hole.clear();
+		Dart h = d;
+		bool valid = true;
+		do
+		{
+			hole.push_back(h);
+			visited.mark(h);
+			const Dart first = m.phi1(h);
+			Dart n = first;
+			while (m.phi2(n) != n)
+			{
+				n = m.phi1(m.phi2(n));
+				if (n == first)
+				{
+					valid = false;
+					break;
+				}
+			}
+			h = n;
+		} while (valid && h != d && !visited.is_marked(h));
+		if (!valid || h != d)
+		{
+			++nb_open;
+			continue;
+		}
+
+		// boundary face darts b_i (opposite to hole[i]) with phi1(b_i+1) = b_i
+		const uint32 size = uint32(hole.size());
+		CMap1::Face f = add_face(static_cast<CMap1&>(m), size, false);
+		Dart b = f.dart;
+		for (uint32 k = 0u; k < size; ++k)
+		{
+			m.set_boundary(b, true);
+			m.phi2_sew(hole[k], b);
+			if (m.is_embedded<CMap2::Vertex>())
+				m.copy_embedding<CMap2::Vertex>(b, m.phi1(hole[k]));
+			if (m.is_embedded<CMap2::Edge>())
+				m.copy_embedding<CMap2::Edge>(b, hole[k]);
+			if (m.is_embedded<CMap2::Volume>())
+				m.copy_embedding<CMap2::Volume>(b, hole[k]);
+			b = m.phi_1(b);
+		}
+		++nb_holes;
+	}
+	if (nb_open_holes)
+		*nb_open_holes = nb_open;
+	return nb_holes;
+}
+
+/*****************************************************************************/
+
+// SewingReport sew_faces(CMap2& m, bool close = true);
+
+/*****************************************************************************/
+
+///////////
+// CMap2 //
+///////////
+
+/**
+ * \brief phi2-sews the darts without phi2 of a surface whose faces are already built and vertex-embedded.
+ * Each dart going from vertex a to vertex b gets the key (min(a,b), max(a,b)); the keys are sorted with a
+ * parallel radix sort and, within each group of equal keys, a dart a->b is sewn with a dart b->a.
+ * Groups of more than two darts (non-manifold edges) or of two darts of the same direction are reported
+ * and their unmatched darts are left on the boundary. If close is true, the holes are then closed by close_holes
+ * (the holes it cannot close are counted in nb_open_holes).
+ */
+inline SewingReport
+sew_faces(CMap2& m, bool close = true)
+{
+	cgogn_message_assert(m.is_embedded<CMap2::Vertex>(), "sew_faces: the vertices must be embedded");
+
+	SewingReport report = { 0u, 0u, 0u, 0u, 0u };
+	const uint32 nb_darts = m.nb_darts();
+	auto is_free = [&] (Dart d) -> bool { return m.phi2(d) == d && !m.is_boundary(d); };
+
+	// gather the darts to sew (in index order)
+	const uint32 nbc = nb_chunks(nb_darts);
+	std::vector<uint32> chunk_offsets(nbc + 1u, 0u);
+	parallel_foreach_chunk(nb_darts, [&] (uint32 c, uint32 begin, uint32 end)
+	{
+		uint32 count = 0u;
+		for (uint32 i = begin; i < end; ++i)
+			count += is_free(Dart(i)) ? 1u : 0u;
+		chunk_offsets[c + 1u] = count;
+	});
+	for (uint32 c = 0u; c < nbc; ++c)
+		chunk_offsets[c + 1u] += chunk_offsets[c];
+
+	const uint32 nb_free = chunk_offsets[nbc];
+	std::vector<uint64> keys(nb_free);
+	std::vector<uint32> darts(nb_free);
+	uint32 max_vertex = 0u;
+	for (uint32 i : *m.embeddings_[CMap2::Vertex::ORBIT])
+		if (i != INVALID_INDEX && i > max_vertex)
+			max_vertex = i;
+	parallel_foreach_chunk(nb_darts, [&] (uint32 c, uint32 begin, uint32 end)
+	{
+		uint32 k = chunk_offsets[c];
+		for (uint32 i = begin; i < end; ++i)
+		{
+			const Dart d(i);
+			if (!is_free(d))
+				continue;
+			const uint64 a = m.embedding(CMap2::Vertex(d));
+			const uint64 b = m.embedding(CMap2::Vertex(m.phi1(d)));
+			keys[k] = a < b ? (a * (uint64(max_vertex) + 1u) + b) : (b * (uint64(max_vertex) + 1u) + a);
+			darts[k] = i;
+			++k;
+		}
+	});
+
+	uint32 key_bits = 0u;
+	const uint64 max_key = (uint64(max_vertex) + 1u) * (uint64(max_vertex) + 1u);
+	while (key_bits < 64u && (max_key >> key_bits) != 0u)
+		++key_bits;
+	parallel_radix_sort(keys, darts, key_bits);
+
+	// each group of equal keys is processed by the chunk in which it begins
+	struct Counts { uint32 sewn; uint32 non_manifold; };
+	std::vector<Counts> counts(nb_chunks(nb_free), Counts{0u, 0u});
+	parallel_foreach_chunk(nb_free, [&] (uint32 c, uint32 begin, uint32 end)
+	{
+		std::vector<Dart> forward, backward;
+		for (uint32 i = begin; i < end; ++i)
+		{
+			if (i > 0u && keys[i] == keys[i - 1u])
+				continue;
+			uint32 j = i + 1u;
+			while (j < nb_free && keys[j] == keys[i])
+				++j;
+			if (j - i == 1u)
+				continue;
+
+			forward.clear();
+			backward.clear();
+			for (uint32 k = i; k < j; ++k)
+			{
+				const Dart d(darts[k]);
+				const uint32 a = m.embedding(CMap2::Vertex(d));
+				const uint32 b = m.embedding(CMap2::Vertex(m.phi1(d)));
+				if (a == b)
+					continue; // degenerate edge
+				(a < b ? forward : backward).push_back(d);
+			}
+			const std::size_t nb_pairs = std::min(forward.size(), backward.size());
+			for (std::size_t k = 0u; k < nb_pairs; ++k)
+				m.phi2_sew(forward[k], backward[k]);
+			counts[c].sewn += uint32(nb_pairs);
+			if (j - i > 2u || nb_pairs == 0u)
+				++counts[c].non_manifold;
+		}
+	});
+	for (const Counts& c : counts)
+	{
+		report.nb_sewn_edges += c.sewn;
+		report.nb_non_manifold_edges += c.non_manifold;
+	}
+	report.nb_boundary_edges = nb_free - 2u * report.nb_sewn_edges;
+
+	if (close && report.nb_boundary_edges > 0u)
+		report.nb_holes = close_holes(m, &report.nb_open_holes);
+
+	return report;
+}
+
+namespace internal
+{
+
+// applies func on the vertices of the face f, skipping the repeated consecutive vertices
+// (and the last one if it is equal to the first one)
+template <typename FUNC>
+inline void
+foreach_face_vertex(const std::vector<uint32>& face_offsets, const std::vector<uint32>& face_indices, uint32 f, const FUNC& func)
+{
+	const uint32 begin = face_offsets[f];
+	const uint32 end = face_offsets[f + 1u];
+	for (uint32 k = begin; k < end; ++k)
+	{
+		const uint32 v = face_indices[k];
+		if (k > begin && v == face_indices[k - 1u])
+			continue;
+		if (k + 1u == end && k > begin && v == face_indices[begin])
+			continue;
+		func(v);
+	}
+}
+
+/**
+ * adds the darts of a block of indexed faces (see build_faces) whose vertices are already embedded
+ * from vertex_base: the darts are allocated in one block and phi1, phi_1 and the embeddings are set in parallel.
+ * \returns the first dart of the block
+ */
+inline uint32
+add_face_block(
+	CMap2& m,
+	uint32 vertex_base,
+	uint32 nb_vertices,
+	const std::vector<uint32>& face_offsets,
+	const std::vector<uint32>& face_indices,
+	std::vector<uint32>* face_lines = nullptr
+)
+{
+	unused_parameters(nb_vertices); // only checked in debug
+	const uint32 nb_faces = face_offsets.empty() ? 0u : uint32(face_offsets.size() - 1u);
+
+	std::vector<uint32> dart_offsets(nb_faces + 1u);
+	dart_offsets[0] = 0u;
+	parallel_for(nb_faces, [&] (uint32 f)
+	{
+		uint32 size = 0u;
+		foreach_face_vertex(face_offsets, face_indices, f, [&] (uint32) { ++size; });
+		dart_offsets[f + 1u] = size < 3u ? 0u : size;
+	});
+	uint32 nb_kept_faces = 0u;
+	for (uint32 f = 0u; f < nb_faces; ++f)
+	{
+		nb_kept_faces += dart_offsets[f + 1u] > 0u ? 1u : 0u;
+		dart_offsets[f + 1u] += dart_offsets[f];
+	}
+
+	const uint32 dart_base = m.add_darts(dart_offsets[nb_faces]).index;
+
+	const bool face_embedded = m.is_embedded<CMap2::Face>();
+	std::vector<uint32> face_line;
+	if (face_embedded)
+	{
+		face_line.resize(nb_faces);
+		uint32 next = m.attribute_containers_[CMap2::Face::ORBIT].add_lines(nb_kept_faces);
+		for (uint32 f = 0u; f < nb_faces; ++f)
+			face_line[f] = dart_offsets[f + 1u] > dart_offsets[f] ? next++ : INVALID_INDEX;
+	}
+	if (face_lines)
+		*face_lines = face_line;
+
+	parallel_for(nb_faces, [&] (uint32 f)
+	{
+		const uint32 first = dart_base + dart_offsets[f];
+		const uint32 last = dart_base + dart_offsets[f + 1u] - 1u;
+		if (last + 1u == first)
+			return;
+		uint32 d = first;
+		foreach_face_vertex(face_offsets, face_indices, f, [&] (uint32 v)
+		{
+			cgogn_message_assert(v < nb_vertices, "build_faces: invalid vertex index");
+			(*m.phi1_)[d] = Dart(d == last ? first : d + 1u);
+			(*m.phi_1_)[d] = Dart(d == first ? last : d - 1u);
+			m.set_embedding<CMap2::Vertex>(Dart(d), vertex_base + v);
+			if (face_embedded)
+				m.set_embedding<CMap2::Face>(Dart(d), face_line[f]);
+			++d;
+		});
+	});
+
+	return dart_base;
+}
+
+/**
+ * sews the faces built from dart_base by add_face_block with sew_faces and creates the edge
+ * and volume embeddings of the new darts if the map has them
+ */
+inline SewingReport
+sew_face_blocks(CMap2& m, uint32 dart_base)
+{
+	const SewingReport report = sew_faces(m);
+
+	if (m.is_embedded<CMap2::Edge>())
+	{
+		// an edge line for each pair of darts of the new faces and of their boundary faces
+		const uint32 nb_darts = m.nb_darts() - dart_base;
+		const uint32 nbc = nb_chunks(nb_darts);
+		std::vector<uint32> chunk_offsets(nbc + 1u, 0u);
+		auto is_edge_dart = [&] (uint32 i) -> bool { const Dart d(i); return m.phi2(d) == d || d.index < m.phi2(d).index; };
+		parallel_foreach_chunk(nb_darts, [&] (uint32 c, uint32 begin, uint32 end)
+		{
+			uint32 count = 0u;
+			for (uint32 i = begin; i < end; ++i)
+				count += is_edge_dart(dart_base + i) ? 1u : 0u;
+			chunk_offsets[c + 1u] = count;
+		});
+		for (uint32 c = 0u; c < nbc; ++c)
+			chunk_offsets[c + 1u] += chunk_offsets[c];
+		const uint32 edge_base = m.attribute_containers_[CMap2::Edge::ORBIT].add_lines(chunk_offsets[nbc]);
+		parallel_foreach_chunk(nb_darts, [&] (uint32 c, uint32 begin, uint32 end)
+		{
+			uint32 e = edge_base + chunk_offsets[c];
+			for (uint32 i = begin; i < end; ++i)
+			{
+				if (!is_edge_dart(dart_base + i))
+					continue;
+				const Dart d(dart_base + i);
+				m.set_embedding<CMap2::Edge>(d, e);
+				m.set_embedding<CMap2::Edge>(m.phi2(d), e);
+				++e;
+			}
+		});
+	}
+
+	if (m.is_embedded<CMap2::Volume>())
+		create_embeddings<CMap2::Volume>(m);
+
+	return report;
+}
+
+} // namespace internal
+
+/*****************************************************************************/
+
+// SewingReport build_faces(CMap2& m, uint32 nb_vertices, const std::vector<uint32>& face_offsets, const std::vector<uint32>& face_indices, uint32* first_vertex = nullptr, std::vector<uint32>* face_lines = nullptr);
+
+/*****************************************************************************/
+
+///////////
+// CMap2 //
+///////////
+
+/**
+ * \brief builds a surface from indexed faces: the vertices of the face f are
+ * face_indices[face_offsets[f]] ... face_indices[face_offsets[f+1] - 1], as indices in [0, nb_vertices[.
+ * nb_vertices vertex lines are added in one block (vertex i gets the index first_vertex + i) and all the darts
+ * are allocated in one block; phi1, phi_1 and the embeddings are then set in parallel.
+ * The faces are sewn by sew_faces and boundary faces are only created to close the holes.
+ * Repeated consecutive vertices of a face are merged and the faces with less than 3 vertices are skipped.
+ * The vertices are embedded if they were not; edge and face embeddings are created if the map has them
+ * (volume embeddings are created sequentially).
+ * If face_lines is given and the faces are embedded, it receives the embedding index of each face (INVALID_INDEX if skipped).
+ */
+inline SewingReport
+build_faces(
+	CMap2& m,
+	uint32 nb_vertices,
+	const std::vector<uint32>& face_offsets,
+	const std::vector<uint32>& face_indices,
+	uint32* first_vertex = nullptr,
+	std::vector<uint32>* face_lines = nullptr
+)
+{
+	if (!m.is_embedded<CMap2::Vertex>())
+	{
+		m.create_embedding<CMap2::Vertex>();
+		create_embeddings<CMap2::Vertex>(m);
+	}
+
+	const uint32 vertex_base = m.attribute_containers_[CMap2::Vertex::ORBIT].add_lines(nb_vertices);
+	if (first_vertex)
+		*first_vertex = vertex_base;
+	const uint32 dart_base = internal::add_face_block(m, vertex_base, nb_vertices, face_offsets, face_indices, face_lines);
+	return internal::sew_face_blocks(m, dart_base);
+}
+
+/**
+ * \brief builds a surface from vertex positions and indexed faces (see build_faces)
+ * The positions are stored in the vertex attribute of the given name, which is created if needed.
+ */
+template <typename VEC3>
+SewingReport
+build_from_faces(
+	CMap2& m,
+	const std::vector<VEC3>& positions,
+	const std::vector<uint32>& face_offsets,
+	const std::vector<uint32>& face_indices,
+	const std::string& position_attribute_name = "position"
+)
+{
+	Attribute<VEC3>* position = get_attribute<VEC3, CMap2::Vertex>(m, position_attribute_name);
+	if (!position)
+		position = add_attribute<VEC3, CMap2::Vertex>(m, position_attribute_name);
+
+	uint32 first_vertex = 0u;
+	const SewingReport report = build_faces(m, uint32(positions.size()), face_offsets, face_indices, &first_vertex);
+	parallel_for(uint32(positions.size()), [&] (uint32 i) { (*position)[first_vertex + i] = positions[i]; });
+	position->notify_modification();
+	return report;
+}
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_FUNCTIONS_MESH_OPS_SURFACE_BUILDER_H_
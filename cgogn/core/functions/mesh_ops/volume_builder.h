@@ -0,0 +1,532 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_FUNCTIONS_MESH_OPS_VOLUME_BUILDER_H_
+#define CGOGN_CORE_FUNCTIONS_MESH_OPS_VOLUME_BUILDER_H_
+
+#include <cgogn/core/types/cmap/cmap3.h>
+
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/radix_sort.h>
+
+#include <cgogn/core/types/cmap/cmap_ops.h>
+#include <cgogn/core/functions/attributes.h>
+
+#include <vector>
+#include <array>
+#include <algorithm>
+
+namespace cgogn
+{
+
+/**
+ * \brief summary of the sewing of the volumes of a volume mesh
+ *  - nb_sewn_faces: number of pairs of faces that were phi3-sewn
+ *  - nb_boundary_faces: number of faces that remained without opposite face
+ *  - nb_non_manifold_faces: number of faces shared by more than two volumes or by two volumes of inconsistent orientations
+ *  - nb_boundary_volumes: number of boundary volumes that were created to close the mesh
+ */
+struct VolumeSewingReport
+{
+	uint32 nb_sewn_faces;
+	uint32 nb_boundary_faces;
+	uint32 nb_non_manifold_faces;
+	uint32 nb_boundary_volumes;
+};
+
+namespace internal
+{
+
+// returns the darts of the faces without phi3 (the dart of smallest index of each face), in index order
+inline std::vector<Dart> free_faces(CMap3& m)
+{
+	const uint32 nb_darts = m.nb_darts();
+	auto is_face_dart = [&] (Dart d) -> bool
+	{
+		if (m.phi3(d) != d || m.is_boundary(d))
+			return false;
+		for (Dart e = m.phi1(d); e != d; e = m.phi1(e))
+		{
+			if (e.index < d.index)
+				return false;
+		}
+		return true;
+	};
+
+	const uint32 nbc = nb_chunks(nb_darts);
+	std::vector<uint32> chunk_offsets(nbc + 1u, 0u);
+	parallel_foreach_chunk(nb_darts, [&] (uint32 c, uint32 begin, uint32 end)
+	{
+		uint32 count = 0u;
+		for (uint32 i = begin; i < end; ++i)
+			count += is_face_dart(Dart(i)) ? 1u : 0u;
+		chunk_offsets[c + 1u] = count;
+	});
+	for (uint32 c = 0u; c < nbc; ++c)
+		chunk_offsets[c + 1u] += chunk_offsets[c];
+
+	std::vector<Dart> faces(chunk_offsets[nbc]);
+	parallel_foreach_chunk(nb_darts, [&] (uint32 c, uint32 begin, uint32 end)
+	{
+		uint32 k = chunk_offsets[c];
+		for (uint32 i = begin; i < end; ++i)
+		{
+			if (is_face_dart(Dart(i)))
+				faces[k++] = Dart(i);
+		}
+	});
+	return faces;
+}
+
+} // namespace internal
+
+/*****************************************************************************/
+
+// uint32 close_boundary(CMap3& m);
+
+/*****************************************************************************/
+
+///////////
+// CMap3 //
+///////////
+
+/**
+ * \brief closes the boundary of a volume mesh: each face without phi3 gets an opposite boundary face
+ * (whose darts are marked as boundary) and the boundary faces are phi2-sewn along the edges of the boundary
+ * (the opposite of a boundary dart is found by turning around its edge through the volumes).
+ * The boundary darts get the vertex, edge and face embeddings of their opposite darts.
+ * \returns the number of boundary volumes (connected components of boundary faces)
+ */
+inline uint32
+close_boundary(CMap3& m)
+{
+	cgogn_message_assert(m.is_embedded<CMap3::Vertex>(), "close_boundary: the vertices must be embedded");
+
+	const std::vector<Dart> faces = internal::free_faces(m);
+	const uint32 nb_faces = uint32(faces.size());
+	if (nb_faces == 0u)
+		return 0u;
+
+	std::vector<uint32> offsets(nb_faces + 1u);
+	offsets[0] = 0u;
+	parallel_for(nb_faces, [&] (uint32 f)
+	{
+		uint32 size = 0u;
+		Dart d = faces[f];
+		do { ++size; d = m.phi1(d); } while (d != faces[f]);
+		offsets[f + 1u] = size;
+	});
+	for (uint32 f = 0u; f < nb_faces; ++f)
+		offsets[f + 1u] += offsets[f];
+
+	const uint32 base = m.add_darts(offsets[nb_faces]).index;
+	const bool edge_embedded = m.is_embedded<CMap3::Edge>();
+	const bool face_embedded = m.is_embedded<CMap3::Face>();
+	const bool volume_embedded = m.is_embedded<CMap3::Volume>();
+
+	// boundary darts b_k (opposite to d_k = phi1^k(face)) with phi1(b_k+1) = b_k
+	parallel_for(nb_faces, [&] (uint32 f)
+	{
+		const uint32 first = base + offsets[f];
+		const uint32 last = base + offsets[f + 1u] - 1u;
+		Dart d = faces[f];
+		for (uint32 b = first; b <= last; ++b)
+		{
+			(*m.phi1_)[b] = Dart(b == first ? last : b - 1u);
+			(*m.phi_1_)[b] = Dart(b == last ? first : b + 1u);
+			(*m.phi3_)[b] = d;
+			(*m.phi3_)[d.index] = Dart(b);
+			m.set_boundary(Dart(b), true);
+			m.copy_embedding<CMap3::Vertex>(Dart(b), m.phi1(d));
+			if (edge_embedded)
+				m.copy_embedding<CMap3::Edge>(Dart(b), d);
+			if (face_embedded)
+				m.copy_embedding<CMap3::Face>(Dart(b), d);
+			if (volume_embedded)
+				m.set_embedding<CMap3::Volume>(Dart(b), INVALID_INDEX);
+			d = m.phi1(d);
+		}
+	});
+
+	// the opposite of a boundary dart b is the boundary dart found by turning around its edge from phi3(b)
+	const uint32 nb_boundary_darts = offsets[nb_faces];
+	parallel_for(nb_boundary_darts, [&] (uint32 i)
+	{
+		const Dart b(base + i);
+		Dart e = m.phi2(m.phi3(b));
+		for (uint32 k = 0u; !m.is_boundary(m.phi3(e)) && k < nb_boundary_darts; ++k)
+			e = m.phi2(m.phi3(e));
+		(*m.phi2_)[b.index] = m.phi3(e);
+	});
+
+	// connected components of the boundary faces
+	uint32 nb_volumes = 0u;
+	std::vector<uint8> visited(nb_boundary_darts, 0u);
+	std::vector<Dart> stack;
+	for (uint32 i = 0u; i < nb_boundary_darts; ++i)
+	{
+		if (visited[i])
+			continue;
+		++nb_volumes;
+		visited[i] = 1u;
+		stack.push_back(Dart(base + i));
+		while (!stack.empty())
+		{
+			const Dart d = stack.back();
+			stack.pop_back();
+			for (Dart n : { m.phi1(d), m.phi2(d) })
+			{
+				if (n.index >= base && !visited[n.index - base])
+				{
+					visited[n.index - base] = 1u;
+					stack.push_back(n);
+				}
+			}
+		}
+	}
+	return nb_volumes;
+}
+
+/*****************************************************************************/
+
+// VolumeSewingReport sew_volumes(CMap3& m, bool close = true);
+
+/*****************************************************************************/
+
+///////////
+// CMap3 //
+///////////
+
+/**
+ * \brief phi3-sews the faces without phi3 of a volume mesh whose volumes are already built and vertex-embedded.
+ * Each face gets a 64 bits hash of its sorted vertex indices; the hashes are sorted with a parallel radix sort
+ * and, within each group of equal hashes, two faces with the same vertices and opposite orientations are sewn.
+ * Groups of more than two faces (non-manifold faces) or of two faces with inconsistent orientations are reported
+ * and left on the boundary. If close is true, the boundary is then closed by close_boundary.
+ */
+inline VolumeSewingReport
+sew_volumes(CMap3& m, bool close = true)
+{
+	cgogn_message_assert(m.is_embedded<CMap3::Vertex>(), "sew_volumes: the vertices must be embedded");
+
+	VolumeSewingReport report = { 0u, 0u, 0u, 0u };
+	const std::vector<Dart> faces = internal::free_faces(m);
+	const uint32 nb_faces = uint32(faces.size());
+
+	auto sorted_vertices = [&] (Dart f, std::vector<uint32>& vertices)
+	{
+		vertices.clear();
+		Dart d = f;
+		do { vertices.push_back(m.embedding(CMap3::Vertex(d))); d = m.phi1(d); } while (d != f);
+		std::sort(vertices.begin(), vertices.end());
+	};
+
+	std::vector<uint64> keys(nb_faces);
+	std::vector<uint32> face_index(nb_faces);
+	parallel_foreach_chunk(nb_faces, [&] (uint32, uint32 begin, uint32 end)
+	{
+		std::vector<uint32> vertices;
+		for (uint32 f = begin; f < end; ++f)
+		{
+			sorted_vertices(faces[f], vertices);
+			uint64 h = vertices.size();
+			for (uint32 v : vertices)
+			{
+				// splitmix64 finalizer
+				h ^= v + 0x9e3779b97f4a7c15ull + (h << 6u) + (h >> 2u);
+				h = (h ^ (h >> 30u)) * 0xbf58476d1ce4e5b9ull;
+				h = (h ^ (h >> 27u)) * 0x94d049bb133111ebull;
+				h ^= h >> 31u;
+			}
+			keys[f] = h;
+			face_index[f] = f;
+		}
+	});
+	parallel_radix_sort(keys, face_index);
+
+	// phi3-sews f and g if each dart a->b of f has a dart b->a in g
+	auto sew = [&] (Dart f, Dart g) -> bool
+	{
+		std::array<Dart, 16u> opposite;
+		uint32 n = 0u;
+		Dart d = f;
+		do
+		{
+			const uint32 a = m.embedding(CMap3::Vertex(d));
+			const uint32 b = m.embedding(CMap3::Vertex(m.phi1(d)));
+			Dart e = g;
+			while (!(m.embedding(CMap3::Vertex(e)) == b && m.embedding(CMap3::Vertex(m.phi1(e))) == a))
+			{
+				e = m.phi1(e);
+				if (e == g)
+					return false;
+			}
+			if (n == opposite.size())
+				return false;
+			opposite[n++] = e;
+			d = m.phi1(d);
+		} while (d != f);
+		d = f;
+		for (uint32 k = 0u; k < n; ++k, d = m.phi1(d))
+			m.phi3_sew(d, opposite[k]);
+		return true;
+	};
+
+	// each group of equal hashes is processed by the chunk in which it begins
+	struct Counts { uint32 sewn; uint32 non_manifold; };
+	std::vector<Counts> counts(nb_chunks(nb_faces), Counts{0u, 0u});
+	parallel_foreach_chunk(nb_faces, [&] (uint32 c, uint32 begin, uint32 end)
+	{
+		std::vector<uint32> group;
+		std::vector<std::vector<uint32>> vertices;
+		std::vector<uint8> done;
+		for (uint32 i = begin; i < end; ++i)
+		{
+			if (i > 0u && keys[i] == keys[i - 1u])
+				continue;
+			uint32 j = i + 1u;
+			while (j < nb_faces && keys[j] == keys[i])
+				++j;
+			if (j - i == 1u)
+				continue;
+
+			// faces with the same vertices (hash collisions put different faces in the same group)
+			vertices.resize(j - i);
+			for (uint32 k = i; k < j; ++k)
+				sorted_vertices(faces[face_index[k]], vertices[k - i]);
+			done.assign(j - i, 0u);
+			for (uint32 k = 0u; k < j - i; ++k)
+			{
+				if (done[k])
+					continue;
+				group.clear();
+				for (uint32 l = k; l < j - i; ++l)
+				{
+					if (!done[l] && vertices[l] == vertices[k])
+					{
+						group.push_back(face_index[i + l]);
+						done[l] = 1u;
+					}
+				}
+				if (group.size() == 2u && sew(faces[group[0]], faces[group[1]]))
+					++counts[c].sewn;
+				else if (group.size() > 1u)
+					++counts[c].non_manifold;
+			}
+		}
+	});
+	for (const Counts& c : counts)
+	{
+		report.nb_sewn_faces += c.sewn;
+		report.nb_non_manifold_faces += c.non_manifold;
+	}
+	report.nb_boundary_faces = nb_faces - 2u * report.nb_sewn_faces;
+
+	if (close && report.nb_boundary_faces > 0u)
+		report.nb_boundary_volumes = close_boundary(m);
+
+	return report;
+}
+
+namespace internal
+{
+
+/**
+ * dart layout of a volume type, built from its faces given as local vertex indices (outward oriented):
+ * the darts are numbered face by face, dart k goes from vertex dart_vertex[k] to the next vertex of its face
+ */
+struct VolumeTemplate
+{
+	uint32 nb_vertices;
+	std::vector<uint32> dart_vertex;
+	std::vector<uint32> phi1;
+	std::vector<uint32> phi_1;
+	std::vector<uint32> phi2;
+
+	VolumeTemplate(uint32 nbv, const std::vector<std::vector<uint32>>& faces) : nb_vertices(nbv)
+	{
+		for (const std::vector<uint32>& face : faces)
+		{
+			const uint32 first = uint32(dart_vertex.size());
+			const uint32 size = uint32(face.size());
+			for (uint32 i = 0u; i < size; ++i)
+			{
+				dart_vertex.push_back(face[i]);
+				phi1.push_back(first + (i + 1u) % size);
+				phi_1.push_back(first + (i + size - 1u) % size);
+			}
+		}
+		const uint32 nb_darts = uint32(dart_vertex.size());
+		phi2.assign(nb_darts, INVALID_INDEX);
+		for (uint32 d = 0u; d < nb_darts; ++d)
+		{
+			for (uint32 e = 0u; e < nb_darts; ++e)
+			{
+				if (dart_vertex[e] == dart_vertex[phi1[d]] && dart_vertex[phi1[e]] == dart_vertex[d])
+					phi2[d] = e;
+			}
+			cgogn_assert(phi2[d] != INVALID_INDEX);
+		}
+	}
+
+	uint32 nb_darts() const { return uint32(dart_vertex.size()); }
+};
+
+// vertex numbering of the Medit/Gmf format: the faces of positively oriented volumes are given outward
+inline const VolumeTemplate& tetrahedron_template()
+{
+	static const VolumeTemplate t(4u, { {0u, 2u, 1u}, {0u, 1u, 3u}, {1u, 2u, 3u}, {0u, 3u, 2u} });
+	return t;
+}
+
+inline const VolumeTemplate& pyramid_template()
+{
+	static const VolumeTemplate t(5u, { {0u, 3u, 2u, 1u}, {0u, 1u, 4u}, {1u, 2u, 4u}, {2u, 3u, 4u}, {3u, 0u, 4u} });
+	return t;
+}
+
+inline const VolumeTemplate& prism_template()
+{
+	static const VolumeTemplate t(6u, { {0u, 2u, 1u}, {3u, 4u, 5u}, {0u, 1u, 4u, 3u}, {1u, 2u, 5u, 4u}, {2u, 0u, 3u, 5u} });
+	return t;
+}
+
+inline const VolumeTemplate& hexahedron_template()
+{
+	static const VolumeTemplate t(8u, {
+		{0u, 3u, 2u, 1u}, {4u, 5u, 6u, 7u}, {0u, 1u, 5u, 4u}, {1u, 2u, 6u, 5u}, {2u, 3u, 7u, 6u}, {3u, 0u, 4u, 7u}
+	});
+	return t;
+}
+
+} // namespace internal
+
+/*****************************************************************************/
+
+// VolumeSewingReport build_volumes(CMap3& m, uint32 nb_vertices, const std::vector<uint32>& tetrahedra, const std::vector<uint32>& pyramids,
+//	const std::vector<uint32>& prisms, const std::vector<uint32>& hexahedra, uint32* first_vertex = nullptr);
+
+/*****************************************************************************/
+
+///////////
+// CMap3 //
+///////////
+
+/**
+ * \brief builds a volume mesh from indexed volumes: the vertices of the i-th tetrahedron are
+ * tetrahedra[4i] ... tetrahedra[4i+3] (5 vertices per pyramid, 6 per prism, 8 per hexahedron), as indices in [0, nb_vertices[,
+ * numbered and positively oriented as in the Medit format (see internal::tetrahedron_template & co).
+ * nb_vertices vertex lines are added in one block (vertex i gets the index first_vertex + i), the darts of each volume type
+ * are allocated in one block and their relations and embeddings are set in parallel from the template of the type.
+ * The volumes are then sewn by sew_volumes, which closes the boundary. Volume embeddings are created in parallel
+ * if the map has them; edge and face embeddings are created sequentially.
+ */
+inline VolumeSewingReport
+build_volumes(
+	CMap3& m,
+	uint32 nb_vertices,
+	const std::vector<uint32>& tetrahedra,
+	const std::vector<uint32>& pyramids,
+	const std::vector<uint32>& prisms,
+	const std::vector<uint32>& hexahedra,
+	uint32* first_vertex = nullptr
+)
+{
+	if (!m.is_embedded<CMap3::Vertex>())
+	{
+		m.create_embedding<CMap3::Vertex>();
+		create_embeddings<CMap3::Vertex>(m);
+	}
+
+	const uint32 vertex_base = m.attribute_containers_[CMap3::Vertex::ORBIT].add_lines(nb_vertices);
+	if (first_vertex)
+		*first_vertex = vertex_base;
+	const uint32 first_dart = m.nb_darts();
+	const bool edge_embedded = m.is_embedded<CMap3::Edge>();
+	const bool face_embedded = m.is_embedded<CMap3::Face>();
+	const bool volume_embedded = m.is_embedded<CMap3::Volume>();
+
+	const std::array<const std::vector<uint32>*, 4u> volumes = { &tetrahedra, &pyramids, &prisms, &hexahedra };
+	const std::array<const internal::VolumeTemplate*, 4u> templates = {
+		&internal::tetrahedron_template(), &internal::pyramid_template(),
+		&internal::prism_template(), &internal::hexahedron_template()
+	};
+	for (uint32 type = 0u; type < 4u; ++type)
+	{
+		const std::vector<uint32>& indices = *volumes[type];
+		const internal::VolumeTemplate& t = *templates[type];
+		const uint32 nb_volumes = uint32(indices.size() / t.nb_vertices);
+		if (nb_volumes == 0u)
+			continue;
+		const uint32 nb_darts = t.nb_darts();
+		const uint32 dart_base = m.add_darts(nb_volumes * nb_darts).index;
+		const uint32 volume_base = volume_embedded ? m.attribute_containers_[CMap3::Volume::ORBIT].add_lines(nb_volumes) : 0u;
+
+		parallel_for(nb_volumes, [&] (uint32 v)
+		{
+			const uint32 first = dart_base + v * nb_darts;
+			const uint32* vertices = &indices[std::size_t(v) * t.nb_vertices];
+			for (uint32 k = 0u; k < nb_darts; ++k)
+			{
+				const Dart d(first + k);
+				cgogn_message_assert(vertices[t.dart_vertex[k]] < nb_vertices, "build_volumes: invalid vertex index");
+				(*m.phi1_)[d.index] = Dart(first + t.phi1[k]);
+				(*m.phi_1_)[d.index] = Dart(first + t.phi_1[k]);
+				(*m.phi2_)[d.index] = Dart(first + t.phi2[k]);
+				m.set_embedding<CMap3::Vertex>(d, vertex_base + vertices[t.dart_vertex[k]]);
+				if (volume_embedded)
+					m.set_embedding<CMap3::Volume>(d, volume_base + v);
+				if (edge_embedded)
+					m.set_embedding<CMap3::Edge>(d, INVALID_INDEX);
+				if (face_embedded)
+					m.set_embedding<CMap3::Face>(d, INVALID_INDEX);
+			}
+		});
+	}
+
+	const VolumeSewingReport report = sew_volumes(m);
+
+	// the new darts and their boundary darts are the last ones
+	if (edge_embedded)
+	{
+		for (uint32 i = first_dart; i < m.nb_darts(); ++i)
+		{
+			if (m.embedding(CMap3::Edge(Dart(i))) == INVALID_INDEX)
+				create_embedding(m, CMap3::Edge(Dart(i)));
+		}
+	}
+	if (face_embedded)
+	{
+		for (uint32 i = first_dart; i < m.nb_darts(); ++i)
+		{
+			if (m.embedding(CMap3::Face(Dart(i))) == INVALID_INDEX)
+				create_embedding(m, CMap3::Face(Dart(i)));
+		}
+	}
+
+	return report;
+}
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_FUNCTIONS_MESH_OPS_VOLUME_BUILDER_H_
@@ -28,6 +28,8 @@
 
 #include <cgogn/core/types/mesh_traits.h>
 
+#include <cgogn/core/functions/traversals/volume.h>
+
 namespace cgogn
 {
 
@@ -42,7 +44,7 @@ namespace cgogn
 // CMap1 //
 ///////////
 
-std::vector<CMap1::Vertex> incident_edges(const CMap1& m, CMap1::Face f)
+inline std::vector<CMap1::Vertex> incident_edges(const CMap1& m, CMap1::Face f)
 {
 	std::vector<CMap1::Edge> edges;
 	m.foreach_dart_of_orbit(f, [&] (Dart d) -> bool { edges.push_back(CMap1::Edge(d)); return true; });
@@ -53,27 +55,66 @@ std::vector<CMap1::Vertex> incident_edges(const CMap1& m, CMap1::Face f)
 // CMap2 //
 ///////////
 
-std::vector<CMap2::Edge> incident_edges(const CMap2& m, CMap2::Vertex v)
+inline std::vector<CMap2::Edge> incident_edges(const CMap2& m, CMap2::Vertex v)
 {
 	std::vector<CMap2::Edge> edges;
 	m.foreach_dart_of_orbit(v, [&] (Dart d) -> bool { edges.push_back(CMap2::Edge(d)); return true; });
 	return edges;
 }
 
-std::vector<CMap2::Edge> incident_edges(const CMap2& m, CMap2::Face f)
+inline std::vector<CMap2::Edge> incident_edges(const CMap2& m, CMap2::Face f)
 {
 	std::vector<CMap2::Edge> edges;
 	m.foreach_dart_of_orbit(f, [&] (Dart d) -> bool { edges.push_back(CMap2::Edge(d)); return true; });
 	return edges;
 }
 
+///////////
+// CMap3 //
+///////////
+
+template <typename CELL,
+		  typename std::enable_if<is_in_tuple<CELL, CMap3::Cells>::value>::type* = nullptr>
+std::vector<CMap3::Edge> incident_edges(const CMap3& m, CELL c)
+{
+	std::vector<CMap3::Edge> edges;
+	foreach_incident_edge(m, c, [&] (CMap3::Edge e) -> bool { edges.push_back(e); return true; });
+	return edges;
+}
+
+///////////////////
+// FrozenSurface //
+///////////////////
+
+inline std::vector<FrozenSurface::Edge> incident_edges(const FrozenSurface& m, FrozenSurface::Vertex v)
+{
+	std::vector<FrozenSurface::Edge> edges;
+	m.foreach_halfedge_of_vertex(v.index, [&] (uint32 h) -> bool
+	{
+		edges.push_back(FrozenSurface::Edge(m.halfedge_edge(h)));
+		const uint32 p = m.prev(h);
+		if (m.is_boundary_halfedge(p))
+			edges.push_back(FrozenSurface::Edge(m.halfedge_edge(p)));
+		return true;
+	});
+	return edges;
+}
+
+inline std::vector<FrozenSurface::Edge> incident_edges(const FrozenSurface& m, FrozenSurface::Face f)
+{
+	std::vector<FrozenSurface::Edge> edges;
+	edges.reserve(m.face_size(f.index));
+	m.foreach_halfedge_of_face(f.index, [&] (uint32 h) -> bool { edges.push_back(FrozenSurface::Edge(m.halfedge_edge(h))); return true; });
+	return edges;
+}
+
 //////////////
 // MESHVIEW //
 //////////////
 
 template <typename CELL, typename MESH,
 		  typename std::enable_if<is_mesh_view<MESH>::value>::type* = nullptr>
-std::vector<typename mesh_traits<MESH>::Vertex>
+std::vector<typename mesh_traits<MESH>::Edge>
 incident_edges(const MESH& m, CELL c)
 {
 	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
@@ -119,6 +160,88 @@ void foreach_incident_edge(const CMap2& m, CMap2::Face f, const FUNC& func)
 	m.foreach_dart_of_orbit(f, [&] (Dart d) -> bool { return func(CMap2::Edge(d)); });
 }
 
+///////////
+// CMap3 //
+///////////
+
+template <typename FUNC>
+void foreach_incident_edge(const CMap3& m, CMap3::Vertex v, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Edge>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	// the darts of the vertex that belong to a same edge form a phi3.phi2 cycle:
+	// an edge is given by the lowest non boundary dart of this cycle
+	m.foreach_dart_of_orbit(v, [&] (Dart d) -> bool
+	{
+		if (m.is_boundary(d))
+			return true;
+		for (Dart it = m.phi3(m.phi2(d)); it != d; it = m.phi3(m.phi2(it)))
+			if (it.index < d.index && !m.is_boundary(it))
+				return true;
+		return func(CMap3::Edge(d));
+	});
+}
+
+template <typename FUNC>
+void foreach_incident_edge(const CMap3& m, CMap3::Face f, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Edge>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	m.foreach_dart_of_PHI1(f.dart, [&] (Dart d) -> bool { return func(CMap3::Edge(d)); });
+}
+
+template <typename FUNC>
+void foreach_incident_edge(const CMap3& m, CMap3::Volume v, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Edge>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	if (is_tetrahedron(m, v))
+	{
+		const Dart d = v.dart;
+		const Dart d2 = m.phi2(d);
+		const Dart edges[6] = { d, m.phi1(d), m.phi_1(d), m.phi1(d2), m.phi_1(d2), m.phi1(m.phi2(m.phi_1(d))) };
+		for (Dart ed : edges)
+			if (!func(CMap3::Edge(ed)))
+				return;
+		return;
+	}
+	// each edge of the volume holds two darts of the volume: d and phi2(d)
+	m.foreach_dart_of_orbit(v, [&] (Dart d) -> bool
+	{
+		if (d.index < m.phi2(d).index)
+			return func(CMap3::Edge(d));
+		return true;
+	});
+}
+
+///////////////////
+// FrozenSurface //
+///////////////////
+
+template <typename FUNC>
+void foreach_incident_edge(const FrozenSurface& m, FrozenSurface::Vertex v, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, FrozenSurface::Edge>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	m.foreach_halfedge_of_vertex(v.index, [&] (uint32 h) -> bool
+	{
+		if (!func(FrozenSurface::Edge(m.halfedge_edge(h))))
+			return false;
+		const uint32 p = m.prev(h);
+		if (m.is_boundary_halfedge(p))
+			return func(FrozenSurface::Edge(m.halfedge_edge(p)));
+		return true;
+	});
+}
+
+template <typename FUNC>
+void foreach_incident_edge(const FrozenSurface& m, FrozenSurface::Face f, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, FrozenSurface::Edge>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	m.foreach_halfedge_of_face(f.index, [&] (uint32 h) -> bool { return func(FrozenSurface::Edge(m.halfedge_edge(h))); });
+}
+
 //////////////
 // MESHVIEW //
 //////////////
@@ -28,6 +28,8 @@
 
 #include <cgogn/core/types/mesh_traits.h>
 
+#include <cgogn/core/functions/traversals/volume.h>
+
 namespace cgogn
 {
 
@@ -66,13 +68,47 @@ std::vector<CMap2::Face> incident_faces(const CMap2& m, CMap2::Edge e)
 	return faces;
 }
 
+///////////
+// CMap3 //
+///////////
+
+template <typename CELL,
+		  typename std::enable_if<is_in_tuple<CELL, CMap3::Cells>::value>::type* = nullptr>
+std::vector<CMap3::Face> incident_faces(const CMap3& m, CELL c)
+{
+	std::vector<CMap3::Face> faces;
+	foreach_incident_face(m, c, [&] (CMap3::Face f) -> bool { faces.push_back(f); return true; });
+	return faces;
+}
+
+///////////////////
+// FrozenSurface //
+///////////////////
+
+inline std::vector<FrozenSurface::Face> incident_faces(const FrozenSurface& m, FrozenSurface::Vertex v)
+{
+	std::vector<FrozenSurface::Face> faces;
+	m.foreach_halfedge_of_vertex(v.index, [&] (uint32 h) -> bool { faces.push_back(FrozenSurface::Face(m.halfedge_face(h))); return true; });
+	return faces;
+}
+
+inline std::vector<FrozenSurface::Face> incident_faces(const FrozenSurface& m, FrozenSurface::Edge e)
+{
+	std::vector<FrozenSurface::Face> faces;
+	const uint32 h = m.edge_halfedge_[e.index];
+	faces.push_back(FrozenSurface::Face(m.halfedge_face(h)));
+	if (!m.is_boundary_halfedge(h))
+		faces.push_back(FrozenSurface::Face(m.halfedge_face(m.halfedge_twin_[h])));
+	return faces;
+}
+
 //////////////
 // MESHVIEW //
 //////////////
 
 template <typename CELL, typename MESH,
 		  typename std::enable_if<is_mesh_view<MESH>::value>::type* = nullptr>
-std::vector<typename mesh_traits<MESH>::Vertex>
+std::vector<typename mesh_traits<MESH>::Face>
 incident_faces(const MESH& m, CELL c)
 {
 	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
@@ -106,16 +142,99 @@ void foreach_incident_face(const CMap2& m, CMap2::Vertex v, const FUNC& func)
 template <typename FUNC>
 void foreach_incident_face(const CMap2& m, CMap2::Edge e, const FUNC& func)
 {
-	static_assert(is_func_parameter_same<FUNC, CMap2::Vertex>::value, "Wrong function cell parameter type");
+	static_assert(is_func_parameter_same<FUNC, CMap2::Face>::value, "Wrong function cell parameter type");
 	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
 	m.foreach_dart_of_orbit(e, [&] (Dart d) -> bool
 	{
 		if (!m.is_boundary(d))
-			return func(CMap2::Vertex(d));
+			return func(CMap2::Face(d));
+		return true;
+	});
+}
+
+///////////
+// CMap3 //
+///////////
+
+template <typename FUNC>
+void foreach_incident_face(const CMap3& m, CMap3::Vertex v, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Face>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	// a face holds two darts of the vertex: d and phi1(phi3(d)), one on each side
+	// of the face: it is given by the lowest non boundary one
+	m.foreach_dart_of_orbit(v, [&] (Dart d) -> bool
+	{
+		if (m.is_boundary(d))
+			return true;
+		const Dart d31 = m.phi1(m.phi3(d));
+		if (m.is_boundary(d31) || d.index < d31.index)
+			return func(CMap3::Face(d));
 		return true;
 	});
 }
 
+template <typename FUNC>
+void foreach_incident_face(const CMap3& m, CMap3::Edge e, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Face>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	// a face holds two darts of the edge: d and phi3(d)
+	m.foreach_dart_of_orbit(e, [&] (Dart d) -> bool
+	{
+		if (m.is_boundary(d))
+			return true;
+		const Dart d3 = m.phi3(d);
+		if (m.is_boundary(d3) || d.index < d3.index)
+			return func(CMap3::Face(d));
+		return true;
+	});
+}
+
+template <typename FUNC>
+void foreach_incident_face(const CMap3& m, CMap3::Volume v, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Face>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	if (is_tetrahedron(m, v))
+	{
+		const Dart d = v.dart;
+		if (func(CMap3::Face(d)) && func(CMap3::Face(m.phi2(d))) && func(CMap3::Face(m.phi2(m.phi1(d)))))
+			func(CMap3::Face(m.phi2(m.phi_1(d))));
+		return;
+	}
+	// a face is given by the lowest of its darts in the volume
+	m.foreach_dart_of_orbit(v, [&] (Dart d) -> bool
+	{
+		for (Dart it = m.phi1(d); it != d; it = m.phi1(it))
+			if (it.index < d.index)
+				return true;
+		return func(CMap3::Face(d));
+	});
+}
+
+///////////////////
+// FrozenSurface //
+///////////////////
+
+template <typename FUNC>
+void foreach_incident_face(const FrozenSurface& m, FrozenSurface::Vertex v, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, FrozenSurface::Face>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	m.foreach_halfedge_of_vertex(v.index, [&] (uint32 h) -> bool { return func(FrozenSurface::Face(m.halfedge_face(h))); });
+}
+
+template <typename FUNC>
+void foreach_incident_face(const FrozenSurface& m, FrozenSurface::Edge e, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, FrozenSurface::Face>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	const uint32 h = m.edge_halfedge_[e.index];
+	if (func(FrozenSurface::Face(m.halfedge_face(h))) && !m.is_boundary_halfedge(h))
+		func(FrozenSurface::Face(m.halfedge_face(m.halfedge_twin_[h])));
+}
+
 //////////////
 // MESHVIEW //
 //////////////
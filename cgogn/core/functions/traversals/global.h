@@ -30,6 +30,8 @@
 #include <cgogn/core/types/cmap/dart_marker.h>
 #include <cgogn/core/types/cmap/cell_marker.h>
 
+#include <cgogn/core/utils/thread_pool.h>
+
 namespace cgogn
 {
 
@@ -126,6 +128,188 @@ foreach_cell(const CellFilter<MESH>& cf, const FUNC& f)
 	});
 }
 
+////////////////////
+// AdjacencyCache //
+////////////////////
+
+template <typename MESH>
+class AdjacencyCache;
+
+template <typename MESH, typename FUNC>
+void
+foreach_cell(const AdjacencyCache<MESH>& ac, const FUNC& f)
+{
+	using CELL = func_parameter_type<FUNC>;
+	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+
+	ac.foreach_cell(f);
+}
+
+///////////////////
+// FrozenSurface //
+///////////////////
+
+template <typename FUNC>
+void
+foreach_cell(const FrozenSurface& m, const FUNC& f)
+{
+	using CELL = func_parameter_type<FUNC>;
+	static_assert(is_in_tuple<CELL, typename mesh_traits<FrozenSurface>::Cells>::value, "CELL not supported in this MESH");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+
+	if (CELL::DIM == 0)
+	{
+		for (uint32 v : m.vertices_)
+			if (!f(CELL(v)))
+				break;
+	}
+	else
+	{
+		for (uint32 i = 0, end = CELL::DIM == 1 ? m.nb_edges() : m.nb_faces(); i < end; ++i)
+			if (!f(CELL(i)))
+				break;
+	}
+}
+
+/*****************************************************************************/
+
+// template <typename MESH, typename FUNC>
+// void parallel_foreach_cell(MESH& m, const FUNC& f);
+
+/*****************************************************************************/
+
+/////////////
+// GENERIC //
+/////////////
+
+template <typename MESH, typename FUNC>
+void
+parallel_foreach_cell(const MESH& m, const FUNC& f)
+{
+	using CELL = func_parameter_type<FUNC>;
+	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+
+	// markers are not thread-safe: cells are gathered sequentially and then processed in parallel
+	std::vector<CELL> cells;
+	foreach_cell(m, [&] (CELL c) -> bool { cells.push_back(c); return true; });
+
+	std::atomic<bool> stop(false);
+	parallel_foreach_chunk(uint32(cells.size()), [&] (uint32, uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end && !stop; ++i)
+			if (!f(cells[i]))
+				stop = true;
+	});
+}
+
+///////////////
+// CellCache //
+///////////////
+
+template <typename MESH, typename FUNC>
+void
+parallel_foreach_cell(const CellCache<MESH>& cc, const FUNC& f)
+{
+	using CELL = func_parameter_type<FUNC>;
+	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+
+	auto cells = cc.template begin<CELL>();
+	std::atomic<bool> stop(false);
+	parallel_foreach_chunk(uint32(cc.template end<CELL>() - cells), [&] (uint32, uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end && !stop; ++i)
+			if (!f(cells[i]))
+				stop = true;
+	});
+}
+
+///////////////////
+// FrozenSurface //
+///////////////////
+
+template <typename FUNC>
+void
+parallel_foreach_cell(const FrozenSurface& m, const FUNC& f)
+{
+	using CELL = func_parameter_type<FUNC>;
+	static_assert(is_in_tuple<CELL, typename mesh_traits<FrozenSurface>::Cells>::value, "CELL not supported in this MESH");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+
+	const uint32 nb = CELL::DIM == 0 ? m.nb_vertices() : (CELL::DIM == 1 ? m.nb_edges() : m.nb_faces());
+	std::atomic<bool> stop(false);
+	parallel_foreach_chunk(nb, [&] (uint32, uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end && !stop; ++i)
+			if (!f(CELL(CELL::DIM == 0 ? m.vertices_[i] : i)))
+				stop = true;
+	});
+}
+
+/*****************************************************************************/
+
+// template <typename T, typename MESH, typename REDUCE, typename TRANSFORM>
+// T parallel_reduce_cells(MESH& m, const T& init, const REDUCE& reduce, const TRANSFORM& transform);
+
+/*****************************************************************************/
+
+/////////////
+// GENERIC //
+/////////////
+
+/**
+ * \brief reduces the values computed by transform on the cells of the mesh using the threads of the pool.
+ * The cell type is given by the parameter of transform. The result is deterministic (see parallel_transform_reduce).
+ */
+template <typename T, typename MESH, typename REDUCE, typename TRANSFORM>
+T
+parallel_reduce_cells(const MESH& m, const T& init, const REDUCE& reduce, const TRANSFORM& transform)
+{
+	using CELL = func_parameter_type<TRANSFORM>;
+	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
+	static_assert(is_func_return_same<TRANSFORM, T>::value, "Given transform function should return a T");
+
+	// markers are not thread-safe: cells are gathered sequentially and then processed in parallel
+	std::vector<CELL> cells;
+	foreach_cell(m, [&] (CELL c) -> bool { cells.push_back(c); return true; });
+
+	return parallel_transform_reduce(uint32(cells.size()), init, reduce, [&] (uint32 i) { return transform(cells[i]); });
+}
+
+///////////////
+// CellCache //
+///////////////
+
+template <typename T, typename MESH, typename REDUCE, typename TRANSFORM>
+T
+parallel_reduce_cells(const CellCache<MESH>& cc, const T& init, const REDUCE& reduce, const TRANSFORM& transform)
+{
+	using CELL = func_parameter_type<TRANSFORM>;
+	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
+	static_assert(is_func_return_same<TRANSFORM, T>::value, "Given transform function should return a T");
+
+	auto cells = cc.template begin<CELL>();
+	return parallel_transform_reduce(uint32(cc.template end<CELL>() - cells), init, reduce, [&] (uint32 i) { return transform(cells[i]); });
+}
+
+///////////////////
+// FrozenSurface //
+///////////////////
+
+template <typename T, typename REDUCE, typename TRANSFORM>
+T
+parallel_reduce_cells(const FrozenSurface& m, const T& init, const REDUCE& reduce, const TRANSFORM& transform)
+{
+	using CELL = func_parameter_type<TRANSFORM>;
+	static_assert(is_in_tuple<CELL, typename mesh_traits<FrozenSurface>::Cells>::value, "CELL not supported in this MESH");
+	static_assert(is_func_return_same<TRANSFORM, T>::value, "Given transform function should return a T");
+
+	const uint32 nb = CELL::DIM == 0 ? m.nb_vertices() : (CELL::DIM == 1 ? m.nb_edges() : m.nb_faces());
+	return parallel_transform_reduce(nb, init, reduce, [&] (uint32 i) { return transform(CELL(CELL::DIM == 0 ? m.vertices_[i] : i)); });
+}
+
 } // namespace cgogn
 
 #endif // CGOGN_CORE_FUNCTIONS_TRAVERSALS_GLOBAL_H_
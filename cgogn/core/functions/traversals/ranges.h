@@ -0,0 +1,379 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_FUNCTIONS_TRAVERSALS_RANGES_H_
+#define CGOGN_CORE_FUNCTIONS_TRAVERSALS_RANGES_H_
+
+#include <cgogn/core/utils/type_traits.h>
+
+#include <cgogn/core/types/mesh_traits.h>
+#include <cgogn/core/types/mesh_views/cell_cache.h>
+#include <cgogn/core/types/mesh_views/cell_filter.h>
+#include <cgogn/core/functions/traversals/global.h>
+
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace cgogn
+{
+
+/**
+ * \brief range defined by a pair of iterators
+ */
+template <typename ITERATOR>
+class IteratorRange
+{
+	ITERATOR begin_;
+	ITERATOR end_;
+
+public:
+
+	using iterator = ITERATOR;
+	using const_iterator = ITERATOR;
+
+	IteratorRange(ITERATOR begin, ITERATOR end) : begin_(begin), end_(end)
+	{}
+
+	ITERATOR begin() const { return begin_; }
+	ITERATOR end() const { return end_; }
+
+	bool empty() const { return begin_ == end_; }
+	// constant time for random access iterators, linear otherwise
+	std::size_t size() const { return std::size_t(std::distance(begin_, end_)); }
+};
+
+/**
+ * \brief forward iterator over the cells of a map.
+ * The cells are given in the same order and by the same darts as foreach_cell:
+ * a cell is given by its first non-boundary dart in the dart container.
+ * The representative darts are flagged once by the range (with the same marker/embedding check as foreach_cell)
+ * and the iterators only read these flags: they can thus be used concurrently (e.g. by parallel std algorithms).
+ */
+template <typename CELL>
+class MapCellIterator
+{
+	const std::vector<bool>* representatives_;
+	uint32 index_;
+	uint32 end_;
+	CELL cell_;
+
+	void skip()
+	{
+		while (index_ < end_ && !(*representatives_)[index_])
+			++index_;
+		cell_ = CELL(Dart(index_));
+	}
+
+public:
+
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = CELL;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const CELL*;
+	using reference = const CELL&;
+
+	MapCellIterator() : representatives_(nullptr), index_(0u), end_(0u)
+	{}
+
+	MapCellIterator(const std::vector<bool>* representatives, uint32 index) :
+		representatives_(representatives), index_(index), end_(uint32(representatives->size()))
+	{
+		skip();
+	}
+
+	reference operator*() const { return cell_; }
+	pointer operator->() const { return &cell_; }
+
+	MapCellIterator& operator++()
+	{
+		++index_;
+		skip();
+		return *this;
+	}
+
+	MapCellIterator operator++(int)
+	{
+		MapCellIterator tmp(*this);
+		++(*this);
+		return tmp;
+	}
+
+	bool operator==(const MapCellIterator& it) const { return index_ == it.index_; }
+	bool operator!=(const MapCellIterator& it) const { return index_ != it.index_; }
+};
+
+/**
+ * \brief range over the cells of a map.
+ * The representative flags are shared by the copies of the range and must remain valid as long as the iterators are used.
+ * The range is not updated when the map is modified.
+ */
+template <typename MESH, typename CELL>
+class MapCellRange
+{
+	std::shared_ptr<std::vector<bool>> representatives_;
+
+public:
+
+	using iterator = MapCellIterator<CELL>;
+	using const_iterator = iterator;
+
+	MapCellRange(const MESH& m) : representatives_(std::make_shared<std::vector<bool>>(m.topology_.size(), false))
+	{
+		std::vector<bool>& representatives = *representatives_;
+		foreach_cell(m, [&] (CELL c) -> bool { representatives[c.dart.index] = true; return true; });
+	}
+
+	iterator begin() const { return iterator(representatives_.get(), 0u); }
+	iterator end() const { return iterator(representatives_.get(), uint32(representatives_->size())); }
+
+	bool empty() const { return begin() == end(); }
+	// linear in the number of darts
+	std::size_t size() const { return std::size_t(std::distance(begin(), end())); }
+};
+
+/**
+ * \brief random access iterator over cells identified by an index.
+ * The index of the cell at position i is indices[i] or i itself if indices is null.
+ * The dereferenced cell is stored in the iterator: the returned reference is valid as long as the iterator
+ * is neither modified nor destroyed. operator[] returns the cell by value.
+ */
+template <typename CELL>
+class IndexCellIterator
+{
+	const uint32* indices_;
+	std::ptrdiff_t pos_;
+	mutable CELL cell_;
+
+	CELL cell(std::ptrdiff_t pos) const { return CELL(indices_ ? indices_[pos] : uint32(pos)); }
+
+public:
+
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = CELL;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const CELL*;
+	using reference = const CELL&;
+
+	IndexCellIterator() : indices_(nullptr), pos_(0)
+	{}
+
+	IndexCellIterator(const uint32* indices, std::ptrdiff_t pos) : indices_(indices), pos_(pos)
+	{}
+
+	reference operator*() const { cell_ = cell(pos_); return cell_; }
+	pointer operator->() const { return &(**this); }
+	value_type operator[](difference_type n) const { return cell(pos_ + n); }
+
+	IndexCellIterator& operator++() { ++pos_; return *this; }
+	IndexCellIterator operator++(int) { IndexCellIterator tmp(*this); ++pos_; return tmp; }
+	IndexCellIterator& operator--() { --pos_; return *this; }
+	IndexCellIterator operator--(int) { IndexCellIterator tmp(*this); --pos_; return tmp; }
+
+	IndexCellIterator& operator+=(difference_type n) { pos_ += n; return *this; }
+	IndexCellIterator& operator-=(difference_type n) { pos_ -= n; return *this; }
+	IndexCellIterator operator+(difference_type n) const { return IndexCellIterator(indices_, pos_ + n); }
+	IndexCellIterator operator-(difference_type n) const { return IndexCellIterator(indices_, pos_ - n); }
+	friend IndexCellIterator operator+(difference_type n, const IndexCellIterator& it) { return it + n; }
+	difference_type operator-(const IndexCellIterator& it) const { return pos_ - it.pos_; }
+
+	bool operator==(const IndexCellIterator& it) const { return pos_ == it.pos_; }
+	bool operator!=(const IndexCellIterator& it) const { return pos_ != it.pos_; }
+	bool operator<(const IndexCellIterator& it) const { return pos_ < it.pos_; }
+	bool operator>(const IndexCellIterator& it) const { return pos_ > it.pos_; }
+	bool operator<=(const IndexCellIterator& it) const { return pos_ <= it.pos_; }
+	bool operator>=(const IndexCellIterator& it) const { return pos_ >= it.pos_; }
+};
+
+/**
+ * \brief forward iterator over the elements of an underlying iterator that satisfy a predicate.
+ * The predicate is evaluated lazily, when the iterator is incremented.
+ */
+template <typename ITERATOR, typename PRED>
+class FilterIterator
+{
+	ITERATOR current_;
+	ITERATOR end_;
+	const PRED* pred_;
+
+	void skip()
+	{
+		while (current_ != end_ && !(*pred_)(*current_))
+			++current_;
+	}
+
+public:
+
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = typename std::iterator_traits<ITERATOR>::value_type;
+	using difference_type = typename std::iterator_traits<ITERATOR>::difference_type;
+	using pointer = typename std::iterator_traits<ITERATOR>::pointer;
+	using reference = typename std::iterator_traits<ITERATOR>::reference;
+
+	FilterIterator() : pred_(nullptr)
+	{}
+
+	FilterIterator(ITERATOR current, ITERATOR end, const PRED* pred) : current_(current), end_(end), pred_(pred)
+	{
+		skip();
+	}
+
+	reference operator*() const { return *current_; }
+	pointer operator->() const { return &(*current_); }
+
+	FilterIterator& operator++()
+	{
+		++current_;
+		skip();
+		return *this;
+	}
+
+	FilterIterator operator++(int)
+	{
+		FilterIterator tmp(*this);
+		++(*this);
+		return tmp;
+	}
+
+	bool operator==(const FilterIterator& it) const { return current_ == it.current_; }
+	bool operator!=(const FilterIterator& it) const { return current_ != it.current_; }
+};
+
+/**
+ * \brief range over the elements of an underlying range that satisfy a predicate.
+ * The predicate is shared by the copies of the range and must remain valid as long as the iterators are used.
+ */
+template <typename RANGE, typename PRED>
+class FilteredRange
+{
+	RANGE range_;
+	std::shared_ptr<PRED> pred_;
+
+public:
+
+	using iterator = FilterIterator<typename RANGE::iterator, PRED>;
+	using const_iterator = iterator;
+
+	FilteredRange(const RANGE& range, const PRED& pred) : range_(range), pred_(std::make_shared<PRED>(pred))
+	{}
+
+	iterator begin() const { return iterator(range_.begin(), range_.end(), pred_.get()); }
+	iterator end() const { return iterator(range_.end(), range_.end(), pred_.get()); }
+
+	bool empty() const { return begin() == end(); }
+};
+
+template <typename RANGE, typename PRED>
+FilteredRange<RANGE, PRED>
+filter(const RANGE& range, const PRED& pred)
+{
+	return FilteredRange<RANGE, PRED>(range, pred);
+}
+
+/*****************************************************************************/
+
+// template <typename CELL, typename MESH>
+// RANGE cells(MESH& m);
+
+/*****************************************************************************/
+
+//////////////
+// CMapBase //
+//////////////
+
+template <typename CELL, typename MESH,
+		  typename std::enable_if<std::is_base_of<CMapBase, MESH>::value>::type* = nullptr>
+MapCellRange<MESH, CELL>
+cells(const MESH& m)
+{
+	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
+	return MapCellRange<MESH, CELL>(m);
+}
+
+// type of the range returned by cells<CELL>(m) for a MESH m
+template <typename MESH, typename CELL>
+struct cell_range
+{
+	using type = decltype(cells<CELL>(std::declval<const MESH&>()));
+};
+
+///////////////
+// CellCache //
+///////////////
+
+template <typename CELL, typename MESH>
+IteratorRange<typename std::vector<CELL>::const_iterator>
+cells(const CellCache<MESH>& cc)
+{
+	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
+	return IteratorRange<typename std::vector<CELL>::const_iterator>(cc.template begin<CELL>(), cc.template end<CELL>());
+}
+
+////////////////
+// CellFilter //
+////////////////
+
+template <typename MESH, typename CELL>
+struct CellFilterPredicate
+{
+	const CellFilter<MESH>* cf_;
+	bool operator()(CELL c) const { return cf_->filter(c); }
+};
+
+template <typename CELL, typename MESH>
+FilteredRange<typename cell_range<MESH, CELL>::type, CellFilterPredicate<MESH, CELL>>
+cells(const CellFilter<MESH>& cf)
+{
+	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
+	return filter(cells<CELL>(cf.mesh()), CellFilterPredicate<MESH, CELL>{&cf});
+}
+
+///////////////////
+// FrozenSurface //
+///////////////////
+
+template <typename CELL>
+IteratorRange<IndexCellIterator<CELL>>
+cells(const FrozenSurface& m)
+{
+	static_assert(is_in_tuple<CELL, typename mesh_traits<FrozenSurface>::Cells>::value, "CELL not supported in this MESH");
+	const uint32* indices = CELL::DIM == 0 ? m.vertices_.data() : nullptr;
+	const uint32 nb = CELL::DIM == 0 ? m.nb_vertices() : (CELL::DIM == 1 ? m.nb_edges() : m.nb_faces());
+	return IteratorRange<IndexCellIterator<CELL>>(IndexCellIterator<CELL>(indices, 0), IndexCellIterator<CELL>(indices, nb));
+}
+
+//////////////
+// MESHVIEW //
+//////////////
+
+template <typename CELL, typename MESH,
+		  typename std::enable_if<is_mesh_view<MESH>::value>::type* = nullptr>
+typename cell_range<typename std::decay<decltype(std::declval<const MESH&>().mesh())>::type, CELL>::type
+cells(const MESH& m)
+{
+	return cells<CELL>(m.mesh());
+}
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_FUNCTIONS_TRAVERSALS_RANGES_H_
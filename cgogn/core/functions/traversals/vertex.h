@@ -28,6 +28,8 @@
 
 #include <cgogn/core/types/mesh_traits.h>
 
+#include <cgogn/core/functions/traversals/volume.h>
+
 namespace cgogn
 {
 
@@ -42,7 +44,7 @@ namespace cgogn
 // CMap1 //
 ///////////
 
-std::vector<CMap1::Vertex> incident_vertices(const CMap1& m, CMap1::Face f)
+inline std::vector<CMap1::Vertex> incident_vertices(const CMap1& m, CMap1::Face f)
 {
 	std::vector<CMap1::Vertex> vertices;
 	m.foreach_dart_of_orbit(f, [&] (Dart d) -> bool { vertices.push_back(CMap1::Vertex(d)); return true; });
@@ -53,20 +55,50 @@ std::vector<CMap1::Vertex> incident_vertices(const CMap1& m, CMap1::Face f)
 // CMap2 //
 ///////////
 
-std::vector<CMap2::Vertex> incident_vertices(const CMap2& m, CMap2::Edge e)
+inline std::vector<CMap2::Vertex> incident_vertices(const CMap2& m, CMap2::Edge e)
 {
 	std::vector<CMap2::Vertex> vertices;
 	m.foreach_dart_of_orbit(e, [&] (Dart d) -> bool { vertices.push_back(CMap2::Vertex(d)); return true; });
 	return vertices;
 }
 
-std::vector<CMap2::Vertex> incident_vertices(const CMap2& m, CMap2::Face f)
+inline std::vector<CMap2::Vertex> incident_vertices(const CMap2& m, CMap2::Face f)
 {
 	std::vector<CMap2::Vertex> vertices;
 	m.foreach_dart_of_orbit(f, [&] (Dart d) -> bool { vertices.push_back(CMap2::Vertex(d)); return true; });
 	return vertices;
 }
 
+///////////
+// CMap3 //
+///////////
+
+template <typename CELL,
+		  typename std::enable_if<is_in_tuple<CELL, CMap3::Cells>::value>::type* = nullptr>
+std::vector<CMap3::Vertex> incident_vertices(const CMap3& m, CELL c)
+{
+	std::vector<CMap3::Vertex> vertices;
+	foreach_incident_vertex(m, c, [&] (CMap3::Vertex v) -> bool { vertices.push_back(v); return true; });
+	return vertices;
+}
+
+///////////////////
+// FrozenSurface //
+///////////////////
+
+inline std::vector<FrozenSurface::Vertex> incident_vertices(const FrozenSurface& m, FrozenSurface::Edge e)
+{
+	return { FrozenSurface::Vertex(m.edge_vertex(e.index, 0u)), FrozenSurface::Vertex(m.edge_vertex(e.index, 1u)) };
+}
+
+inline std::vector<FrozenSurface::Vertex> incident_vertices(const FrozenSurface& m, FrozenSurface::Face f)
+{
+	std::vector<FrozenSurface::Vertex> vertices;
+	vertices.reserve(m.face_size(f.index));
+	m.foreach_halfedge_of_face(f.index, [&] (uint32 h) -> bool { vertices.push_back(FrozenSurface::Vertex(m.halfedge_vertex_[h])); return true; });
+	return vertices;
+}
+
 //////////////
 // MESHVIEW //
 //////////////
@@ -119,6 +151,70 @@ void foreach_incident_vertex(const CMap2& m, CMap2::Face f, const FUNC& func)
 	m.foreach_dart_of_orbit(f, [&] (Dart d) -> bool { return func(CMap2::Vertex(d)); });
 }
 
+///////////
+// CMap3 //
+///////////
+
+template <typename FUNC>
+void foreach_incident_vertex(const CMap3& m, CMap3::Edge e, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Vertex>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	if (func(CMap3::Vertex(e.dart)))
+		func(CMap3::Vertex(m.phi2(e.dart)));
+}
+
+template <typename FUNC>
+void foreach_incident_vertex(const CMap3& m, CMap3::Face f, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Vertex>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	m.foreach_dart_of_PHI1(f.dart, [&] (Dart d) -> bool { return func(CMap3::Vertex(d)); });
+}
+
+template <typename FUNC>
+void foreach_incident_vertex(const CMap3& m, CMap3::Volume v, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Vertex>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	if (is_tetrahedron(m, v))
+	{
+		const Dart d = v.dart;
+		if (func(CMap3::Vertex(d)) && func(CMap3::Vertex(m.phi1(d))) && func(CMap3::Vertex(m.phi_1(d))))
+			func(CMap3::Vertex(m.phi_1(m.phi2(d))));
+		return;
+	}
+	// a vertex is given by the lowest of its darts in the volume (its phi21 cycle)
+	m.foreach_dart_of_orbit(v, [&] (Dart d) -> bool
+	{
+		for (Dart it = m.phi1(m.phi2(d)); it != d; it = m.phi1(m.phi2(it)))
+			if (it.index < d.index)
+				return true;
+		return func(CMap3::Vertex(d));
+	});
+}
+
+///////////////////
+// FrozenSurface //
+///////////////////
+
+template <typename FUNC>
+void foreach_incident_vertex(const FrozenSurface& m, FrozenSurface::Edge e, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, FrozenSurface::Vertex>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	if (func(FrozenSurface::Vertex(m.edge_vertex(e.index, 0u))))
+		func(FrozenSurface::Vertex(m.edge_vertex(e.index, 1u)));
+}
+
+template <typename FUNC>
+void foreach_incident_vertex(const FrozenSurface& m, FrozenSurface::Face f, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, FrozenSurface::Vertex>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	m.foreach_halfedge_of_face(f.index, [&] (uint32 h) -> bool { return func(FrozenSurface::Vertex(m.halfedge_vertex_[h])); });
+}
+
 //////////////
 // MESHVIEW //
 //////////////
@@ -152,6 +248,66 @@ foreach_adjacent_vertex_through_edge(const CMap2& m, CMap2::Vertex v, const FUNC
 	m.foreach_dart_of_orbit(v, [&] (Dart d) -> bool { return func(CMap2::Vertex(m.phi2(d))); });
 }
 
+///////////
+// CMap3 //
+///////////
+
+template <typename FUNC>
+void
+foreach_adjacent_vertex_through_edge(const CMap3& m, CMap3::Vertex v, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Vertex>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	m.foreach_dart_of_orbit(v, [&] (Dart d) -> bool
+	{
+		// several darts of the vertex belong to the same edge:
+		// only the one with the lowest index is considered
+		for (Dart it = m.phi3(m.phi2(d)); it != d; it = m.phi3(m.phi2(it)))
+			if (it.index < d.index)
+				return true;
+		return func(CMap3::Vertex(m.phi2(d)));
+	});
+}
+
+///////////////////
+// FrozenSurface //
+///////////////////
+
+template <typename FUNC>
+void
+foreach_adjacent_vertex_through_edge(const FrozenSurface& m, FrozenSurface::Vertex v, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, FrozenSurface::Vertex>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	m.foreach_halfedge_of_vertex(v.index, [&] (uint32 h) -> bool
+	{
+		if (!func(FrozenSurface::Vertex(m.halfedge_vertex_[m.next(h)])))
+			return false;
+		// the incoming boundary edge has no outgoing half-edge from v
+		const uint32 p = m.prev(h);
+		if (m.is_boundary_halfedge(p))
+			return func(FrozenSurface::Vertex(m.halfedge_vertex_[p]));
+		return true;
+	});
+}
+
+////////////////////
+// AdjacencyCache //
+////////////////////
+
+template <typename MESH>
+class AdjacencyCache;
+
+template <typename CELL, typename MESH, typename FUNC>
+void
+foreach_adjacent_vertex_through_edge(const AdjacencyCache<MESH>& ac, CELL v, const FUNC& func)
+{
+	static_assert(std::is_same<CELL, typename mesh_traits<MESH>::Vertex>::value, "Wrong cell type");
+	static_assert(is_func_parameter_same<FUNC, typename mesh_traits<MESH>::Vertex>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	ac.foreach_adjacent_vertex(v, func);
+}
+
 //////////////
 // MESHVIEW //
 //////////////
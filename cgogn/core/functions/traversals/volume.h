@@ -0,0 +1,227 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_FUNCTIONS_TRAVERSALS_VOLUME_H_
+#define CGOGN_CORE_FUNCTIONS_TRAVERSALS_VOLUME_H_
+
+#include <cgogn/core/utils/type_traits.h>
+
+#include <cgogn/core/types/mesh_traits.h>
+
+namespace cgogn
+{
+
+/*****************************************************************************/
+
+// template <typename MESH>
+// bool is_tetrahedron(const MESH& m, typename mesh_traits<MESH>::Volume v);
+
+/*****************************************************************************/
+
+///////////
+// CMap3 //
+///////////
+
+/**
+ * \brief tells if the given volume is a tetrahedron (four triangles glued as a tetrahedron).
+ * Tetrahedra have dedicated fast paths in the CMap3 incidence traversals: their cells
+ * are directly given by the darts below (A, B, C, D being the vertices of the tetrahedron
+ * and d the dart of the volume going from A to B)
+ *  - vertices: d (A), phi1(d) (B), phi_1(d) (C), phi_1(phi2(d)) (D)
+ *  - edges: d (AB), phi1(d) (BC), phi_1(d) (CA), phi1(phi2(d)) (AD), phi_1(phi2(d)) (DB), phi1(phi2(phi_1(d))) (CD)
+ *  - faces: d (ABC), phi2(d) (BAD), phi2(phi1(d)) (CBD), phi2(phi_1(d)) (ACD)
+ */
+inline bool is_tetrahedron(const CMap3& m, CMap3::Volume v)
+{
+	auto is_triangle = [&] (Dart d) -> bool { return m.phi1(m.phi1(m.phi1(d))) == d; };
+	const Dart d = v.dart;
+	if (!is_triangle(d))
+		return false;
+	const Dart e0 = m.phi2(d);
+	const Dart e1 = m.phi2(m.phi1(d));
+	const Dart e2 = m.phi2(m.phi_1(d));
+	return
+		is_triangle(e0) && is_triangle(e1) && is_triangle(e2) &&
+		m.phi2(m.phi1(e0)) == m.phi_1(e2) &&
+		m.phi2(m.phi1(e1)) == m.phi_1(e0) &&
+		m.phi2(m.phi1(e2)) == m.phi_1(e1);
+}
+
+/*****************************************************************************/
+
+// template <typename CELL, typename MESH>
+// std::vector<typename mesh_traits<MESH>::Volume> incident_volumes(const MESH& m, CELL c);
+
+/*****************************************************************************/
+
+///////////
+// CMap3 //
+///////////
+
+template <typename CELL,
+		  typename std::enable_if<is_in_tuple<CELL, CMap3::Cells>::value>::type* = nullptr>
+std::vector<CMap3::Volume> incident_volumes(const CMap3& m, CELL c)
+{
+	std::vector<CMap3::Volume> volumes;
+	foreach_incident_volume(m, c, [&] (CMap3::Volume v) -> bool { volumes.push_back(v); return true; });
+	return volumes;
+}
+
+//////////////
+// MESHVIEW //
+//////////////
+
+template <typename CELL, typename MESH,
+		  typename std::enable_if<is_mesh_view<MESH>::value>::type* = nullptr>
+std::vector<typename mesh_traits<MESH>::Volume>
+incident_volumes(const MESH& m, CELL c)
+{
+	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
+	return incident_volumes(m.mesh(), c);
+}
+
+/*****************************************************************************/
+
+// template <typename CELL, typename MESH, typename FUNC>
+// void foreach_incident_volume(const MESH& m, CELL c, const FUNC& f);
+
+/*****************************************************************************/
+
+///////////
+// CMap3 //
+///////////
+
+template <typename FUNC>
+void foreach_incident_volume(const CMap3& m, CMap3::Vertex v, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Volume>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	// a volume is given by the lowest of its darts in the vertex (the phi21 cycle of the volume around the vertex)
+	m.foreach_dart_of_orbit(v, [&] (Dart d) -> bool
+	{
+		if (m.is_boundary(d))
+			return true;
+		for (Dart it = m.phi1(m.phi2(d)); it != d; it = m.phi1(m.phi2(it)))
+			if (it.index < d.index)
+				return true;
+		return func(CMap3::Volume(d));
+	});
+}
+
+template <typename FUNC>
+void foreach_incident_volume(const CMap3& m, CMap3::Edge e, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Volume>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	// each volume around the edge holds two darts of the edge: d and phi2(d)
+	m.foreach_dart_of_orbit(e, [&] (Dart d) -> bool
+	{
+		if (!m.is_boundary(d) && d.index < m.phi2(d).index)
+			return func(CMap3::Volume(d));
+		return true;
+	});
+}
+
+template <typename FUNC>
+void foreach_incident_volume(const CMap3& m, CMap3::Face f, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Volume>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	const Dart d = f.dart;
+	const Dart d3 = m.phi3(d);
+	if (!m.is_boundary(d) && !func(CMap3::Volume(d)))
+		return;
+	if (!m.is_boundary(d3))
+		func(CMap3::Volume(d3));
+}
+
+//////////////
+// MESHVIEW //
+//////////////
+
+template <typename CELL, typename MESH, typename FUNC,
+		  typename std::enable_if<is_mesh_view<MESH>::value>::type* = nullptr>
+void
+foreach_incident_volume(const MESH& m, CELL c, const FUNC& func)
+{
+	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
+	foreach_incident_volume(m.mesh(), c, func);
+}
+
+/*****************************************************************************/
+
+// template <typename CELL, typename MESH, typename FUNC>
+// void foreach_adjacent_volume_through_face(const MESH& m, typename mesh_traits<MESH>::Volume v, const FUNC& f);
+
+/*****************************************************************************/
+
+///////////
+// CMap3 //
+///////////
+
+template <typename FUNC>
+void foreach_adjacent_volume_through_face(const CMap3& m, CMap3::Volume v, const FUNC& func)
+{
+	static_assert(is_func_parameter_same<FUNC, CMap3::Volume>::value, "Wrong function cell parameter type");
+	static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+	if (is_tetrahedron(m, v))
+	{
+		const Dart d = v.dart;
+		const Dart faces[4] = { d, m.phi2(d), m.phi2(m.phi1(d)), m.phi2(m.phi_1(d)) };
+		for (Dart fd : faces)
+		{
+			const Dart d3 = m.phi3(fd);
+			if (!m.is_boundary(d3) && !func(CMap3::Volume(d3)))
+				return;
+		}
+		return;
+	}
+	// a face is given by the lowest of its darts in the volume
+	m.foreach_dart_of_orbit(v, [&] (Dart d) -> bool
+	{
+		for (Dart it = m.phi1(d); it != d; it = m.phi1(it))
+			if (it.index < d.index)
+				return true;
+		const Dart d3 = m.phi3(d);
+		if (!m.is_boundary(d3))
+			return func(CMap3::Volume(d3));
+		return true;
+	});
+}
+
+//////////////
+// MESHVIEW //
+//////////////
+
+template <typename CELL, typename MESH, typename FUNC,
+		  typename std::enable_if<is_mesh_view<MESH>::value>::type* = nullptr>
+void
+foreach_adjacent_volume_through_face(const MESH& m, CELL c, const FUNC& func)
+{
+	static_assert(is_in_tuple<CELL, typename mesh_traits<MESH>::Cells>::value, "CELL not supported in this MESH");
+	foreach_adjacent_volume_through_face(m.mesh(), c, func);
+}
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_FUNCTIONS_TRAVERSALS_VOLUME_H_
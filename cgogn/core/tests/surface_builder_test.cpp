@@ -0,0 +1,163 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <cgogn/core/types/cmap/cmap2.h>
+#include <cgogn/core/types/cmap/cmap_info.h>
+#include <cgogn/core/functions/mesh_info.h>
+#include <cgogn/core/functions/mesh_ops/surface_builder.h>
+
+#include <vector>
+
+namespace cgogn
+{
+
+namespace
+{
+
+// builds and sews the given faces (each one given by its vertex indices)
+SewingReport build(CMap2& m, uint32 nb_vertices, const std::vector<std::vector<uint32>>& faces, bool close)
+{
+	std::vector<uint32> offsets(1u, 0u);
+	std::vector<uint32> indices;
+	for (const std::vector<uint32>& f : faces)
+	{
+		indices.insert(indices.end(), f.begin(), f.end());
+		offsets.push_back(uint32(indices.size()));
+	}
+	m.create_embedding<CMap2::Vertex>();
+	const uint32 vertex_base = m.attribute_containers_[CMap2::Vertex::ORBIT].add_lines(nb_vertices);
+	internal::add_face_block(m, vertex_base, nb_vertices, offsets, indices);
+	return sew_faces(m, close);
+}
+
+// checks that phi2 is an involution without fixed point and returns the number of boundary darts
+uint32 check_closed(CMap2& m)
+{
+	uint32 nb_boundary = 0u;
+	for (uint32 i = 0u; i < m.nb_darts(); ++i)
+	{
+		const Dart d(i);
+		EXPECT_NE(m.phi2(d), d);
+		EXPECT_EQ(m.phi2(m.phi2(d)), d);
+		EXPECT_FALSE(m.is_boundary(d) && m.is_boundary(m.phi2(d)));
+		if (m.is_boundary(d))
+		{
+			++nb_boundary;
+			EXPECT_EQ(m.embedding(CMap2::Vertex(d)), m.embedding(CMap2::Vertex(m.phi1(m.phi2(d)))));
+		}
+	}
+	return nb_boundary;
+}
+
+} // namespace
+
+TEST(SurfaceBuilderTest, ClosedSurface)
+{
+	CMap2 m;
+	const SewingReport r = build(m, 4u, {{0u, 1u, 2u}, {0u, 3u, 1u}, {1u, 3u, 2u}, {0u, 2u, 3u}}, true);
+	EXPECT_EQ(r.nb_sewn_edges, 6u);
+	EXPECT_EQ(r.nb_boundary_edges, 0u);
+	EXPECT_EQ(r.nb_non_manifold_edges, 0u);
+	EXPECT_EQ(r.nb_holes, 0u);
+	EXPECT_EQ(r.nb_open_holes, 0u);
+	EXPECT_EQ(check_closed(m), 0u);
+	EXPECT_EQ(nb_cells<CMap2::Vertex>(m), 4u);
+	EXPECT_EQ(nb_cells<CMap2::Edge>(m), 6u);
+	EXPECT_EQ(nb_cells<CMap2::Face>(m), 4u);
+}
+
+TEST(SurfaceBuilderTest, OpenSurface)
+{
+	// a 3x2 grid of quads with a missing quad in the middle of the first row: a single hole with a notch
+	CMap2 m;
+	std::vector<std::vector<uint32>> faces;
+	for (uint32 j = 0u; j < 2u; ++j)
+		for (uint32 i = 0u; i < 3u; ++i)
+			if (i != 1u || j != 0u)
+				faces.push_back({j * 4u + i, j * 4u + i + 1u, (j + 1u) * 4u + i + 1u, (j + 1u) * 4u + i});
+	const SewingReport r = build(m, 12u, faces, false);
+	EXPECT_EQ(r.nb_sewn_edges, 4u);
+	EXPECT_EQ(r.nb_boundary_edges, 12u);
+	EXPECT_EQ(r.nb_non_manifold_edges, 0u);
+	EXPECT_EQ(r.nb_holes, 0u);
+
+	uint32 nb_open_holes = 1u;
+	EXPECT_EQ(close_holes(m, &nb_open_holes), 1u);
+	EXPECT_EQ(nb_open_holes, 0u);
+	EXPECT_EQ(check_closed(m), 12u);
+	EXPECT_EQ(nb_cells<CMap2::Vertex>(m), 12u);
+	EXPECT_EQ(nb_cells<CMap2::Face>(m), 5u);
+
+	// closing again does nothing
+	EXPECT_EQ(close_holes(m, &nb_open_holes), 0u);
+	EXPECT_EQ(nb_open_holes, 0u);
+}
+
+TEST(SurfaceBuilderTest, NonManifoldEdge)
+{
+	// three triangles on the edge (0,1): only one pair of darts of opposite directions can be sewn
+	CMap2 m;
+	const SewingReport r = build(m, 5u, {{0u, 1u, 2u}, {1u, 0u, 3u}, {0u, 1u, 4u}}, true);
+	EXPECT_EQ(r.nb_sewn_edges, 1u);
+	EXPECT_EQ(r.nb_boundary_edges, 7u);
+	EXPECT_EQ(r.nb_non_manifold_edges, 1u);
+	EXPECT_EQ(r.nb_holes, 2u);
+	EXPECT_EQ(r.nb_open_holes, 0u);
+	EXPECT_EQ(check_closed(m), 7u);
+}
+
+TEST(SurfaceBuilderTest, InconsistentOrientation)
+{
+	// two triangles on the edge (0,1) with the same direction
+	CMap2 m;
+	const SewingReport r = build(m, 4u, {{0u, 1u, 2u}, {0u, 1u, 3u}}, true);
+	EXPECT_EQ(r.nb_sewn_edges, 0u);
+	EXPECT_EQ(r.nb_boundary_edges, 6u);
+	EXPECT_EQ(r.nb_non_manifold_edges, 1u);
+	EXPECT_EQ(r.nb_holes, 2u);
+	EXPECT_EQ(r.nb_open_holes, 0u);
+	EXPECT_EQ(check_closed(m), 6u);
+}
+
+TEST(SurfaceBuilderTest, NonManifoldVertex)
+{
+	// two fans of triangles sharing only the vertex 0: each one has its own hole through 0
+	CMap2 m;
+	const SewingReport r = build(m, 7u, {{0u, 1u, 2u}, {0u, 2u, 3u}, {0u, 4u, 5u}, {0u, 5u, 6u}}, true);
+	EXPECT_EQ(r.nb_sewn_edges, 2u);
+	EXPECT_EQ(r.nb_boundary_edges, 8u);
+	EXPECT_EQ(r.nb_non_manifold_edges, 0u);
+	EXPECT_EQ(r.nb_holes, 2u);
+	EXPECT_EQ(r.nb_open_holes, 0u);
+	EXPECT_EQ(check_closed(m), 8u);
+	// each hole only goes around its own fan
+	for (uint32 i = 0u; i < m.nb_darts(); ++i)
+	{
+		if (m.is_boundary(Dart(i)))
+			EXPECT_EQ(nb_darts_of_orbit(m, CMap2::Face(Dart(i))), 4u);
+	}
+}
+
+} // namespace cgogn
@@ -29,7 +29,8 @@ namespace cgogn
 AttributeGen::AttributeGen(AttributeContainer* container, bool is_mark, const std::string& name) :
 	name_(name),
 	container_(container),
-	is_mark_(is_mark)
+	is_mark_(is_mark),
+	modification_count_(0u)
 {}
 
 AttributeGen::~AttributeGen()
@@ -30,6 +30,8 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <utility>
 
 namespace cgogn
 {
@@ -43,9 +45,11 @@ protected:
 	std::string name_;
 	AttributeContainer* container_;
 	bool is_mark_;
+	uint64 modification_count_;
 
 	friend class AttributeContainer;
 	virtual void add_line() = 0;
+	virtual void resize(uint32 size) = 0;
 	virtual const void* data_ptr() const = 0;
 
 public:
@@ -54,43 +58,107 @@ public:
 	virtual ~AttributeGen();
 
 	const std::string& name() const { return name_; }
+
+	/**
+	 * \brief counter of the modifications of the attribute, used by the caches computed from its values.
+	 * It is incremented when lines are added or the data are swapped; the code that writes values
+	 * must call notify_modification once it is done (it is not incremented by operator[]).
+	 */
+	uint64 modification_count() const { return modification_count_; }
+	void notify_modification() { ++modification_count_; }
 };
 
 template <typename T>
 class CGOGN_CORE_EXPORT Attribute : public AttributeGen
 {
 	std::vector<T> data_;
+	T* values_; // data_.data() or the external storage
+	uint32 size_;
+	std::shared_ptr<void> external_; // keeps the external storage alive
+
+	// copies the external values into the owned vector before its size changes
+	void own_values()
+	{
+		if (external_)
+		{
+			data_.assign(values_, values_ + size_);
+			external_.reset();
+		}
+	}
 
 	friend class AttributeContainer;
-	void add_line() override { data_.push_back(T()); }
-	void resize(uint32 size) { data_.resize(size); }
+	void add_line() override
+	{
+		own_values();
+		data_.push_back(T());
+		values_ = data_.data();
+		++size_;
+		++modification_count_;
+	}
+	void resize(uint32 size) override
+	{
+		if (size == size_)
+			return;
+		own_values();
+		data_.resize(size);
+		values_ = data_.data();
+		size_ = size;
+		++modification_count_;
+	}
 
 public:
 
-	using const_iterator = typename std::vector<T>::const_iterator;
-	inline const_iterator begin() const { return data_.begin(); }
-	inline const_iterator end() const { return data_.end(); }
+	using const_iterator = const T*;
+	inline const_iterator begin() const { return values_; }
+	inline const_iterator end() const { return values_ + size_; }
 
-	using iterator = typename std::vector<T>::iterator;
-	inline iterator begin() { return data_.begin(); }
-	inline iterator end() { return data_.end(); }
+	using iterator = T*;
+	inline iterator begin() { return values_; }
+	inline iterator end() { return values_ + size_; }
 
-	Attribute(AttributeContainer* container, bool is_mark, const std::string& name) : AttributeGen(container, is_mark, name)
+	Attribute(AttributeContainer* container, bool is_mark, const std::string& name) :
+		AttributeGen(container, is_mark, name),
+		values_(nullptr),
+		size_(0u)
 	{}
 
 	~Attribute() override
 	{}
 
-	uint32 size() const { return data_.size(); }
-	const void* data_ptr() const override { return &data_[0]; }
+	uint32 size() const { return size_; }
+	const void* data_ptr() const override { return values_; }
+
+	/**
+	 * \brief makes the attribute use size values stored outside of it (e.g. a block of a mapped file)
+	 * without copying them. The storage must be writable and is kept alive by owner as long as it is used;
+	 * the values are copied into the attribute when lines are added.
+	 * Must be called before the lines are added to the (empty) container with add_lines(size).
+	 */
+	void set_external_values(T* values, uint32 size, std::shared_ptr<void> owner)
+	{
+		std::vector<T>().swap(data_);
+		values_ = values;
+		size_ = size;
+		external_ = std::move(owner);
+		++modification_count_;
+	}
+
+	bool has_external_values() const { return bool(external_); }
 
-	inline T& operator[](uint32 index) { return data_[index]; }
-	inline const T& operator[](uint32 index) const { return data_[index]; }
+	inline T& operator[](uint32 index) { return values_[index]; }
+	inline const T& operator[](uint32 index) const { return values_[index]; }
 
 	inline void swap(Attribute<T>* attribute)
 	{
 		if (attribute->container_ == this->container_)
+		{
 			data_.swap(attribute->data_);
+			std::swap(values_, attribute->values_);
+			std::swap(size_, attribute->size_);
+			external_.swap(attribute->external_);
+			this->notify_modification();
+			attribute->notify_modification();
+		}
 	}
 };
 
@@ -140,6 +208,15 @@ public:
 		return nullptr;
 	}
 
+	/**
+	 * \brief removes and deletes the given attribute of the container (it must not be used anymore)
+	 */
+	void remove_attribute(AttributeGen* attribute)
+	{
+		if (attribute && attribute->container_ == this && !attribute->is_mark_)
+			delete attribute; // the destructor removes it from attributes_
+	}
+
 	Attribute<uint8>* add_mark_attribute()
 	{
 		Attribute<uint8>* a = new Attribute<uint8>(this, true, "mark");
@@ -156,6 +233,36 @@ public:
 			a->add_line();
 		return size_++;
 	}
+
+	/**
+	 * \brief adds n lines at once (a single resize of each attribute)
+	 * \returns the index of the first added line, the others following contiguously
+	 */
+	uint32 add_lines(uint32 n)
+	{
+		for (AttributeGen* ag : attributes_)
+			ag->resize(size_ + n);
+		for (Attribute<uint8>* a : mark_attributes_)
+			a->resize(size_ + n);
+		const uint32 first = size_;
+		size_ += n;
+		return first;
+	}
+
+	/**
+	 * \brief removes the last lines so that the container has the given size
+	 * (the removed lines must not be referenced anymore, e.g. lines added by an aborted construction)
+	 */
+	void truncate(uint32 size)
+	{
+		if (size >= size_)
+			return;
+		for (AttributeGen* ag : attributes_)
+			ag->resize(size);
+		for (Attribute<uint8>* a : mark_attributes_)
+			a->resize(size);
+		size_ = size;
+	}
 };
 
 } // namespace cgogn
@@ -28,6 +28,8 @@
 
 #include <cgogn/core/types/cmap/cmap2.h>
 
+#include <cgogn/core/utils/buffers.h>
+
 namespace cgogn
 {
 
@@ -99,6 +101,27 @@ struct CGOGN_CORE_EXPORT CMap3 : public CMap2
 		}
 	}
 
+	template <typename FUNC>
+	inline void foreach_dart_of_PHI1_PHI2(Dart d, const FUNC& f) const
+	{
+		static_assert(is_func_parameter_same<FUNC, Dart>::value, "Given function should take a Dart as parameter");
+		static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
+		// visited darts are stored in a VisitedSet (instead of a DartMarker as in CMap2)
+		// so that volumes can be traversed concurrently
+		VisitedSet<Dart> visited;
+
+		visited.insert(d);
+		for (uint32 i = 0; i < visited.size(); ++i)
+		{
+			const Dart curr_dart = visited[i];
+			if (!f(curr_dart))
+				break;
+
+			visited.insert(phi1(curr_dart)); // next dart in face
+			visited.insert(phi2(curr_dart)); // change face
+		}
+	}
+
 	template <typename FUNC>
 	inline void foreach_dart_of_PHI1_PHI3(Dart d, const FUNC& f) const
 	{
@@ -131,25 +154,21 @@ struct CGOGN_CORE_EXPORT CMap3 : public CMap2
 	{
 		static_assert(is_func_parameter_same<FUNC, Dart>::value, "Given function should take a Dart as parameter");
 		static_assert(is_func_return_same<FUNC, bool>::value, "Given function should return a bool");
-		DartMarkerStore marker(*this);
-		const std::vector<Dart>& marked_darts = marker.marked_darts();
+		// visited darts are stored in a VisitedSet (instead of a DartMarker)
+		// so that vertices can be traversed concurrently
+		VisitedSet<Dart> visited;
 
-		marker.mark(d);
-		for (uint32 i = 0; i < marked_darts.size(); ++i)
+		visited.insert(d);
+		for (uint32 i = 0; i < visited.size(); ++i)
 		{
-			const Dart curr_dart = marked_darts[i];
+			const Dart curr_dart = visited[i];
 //			if ( !(is_boundary(curr_dart) && is_boundary(phi3(curr_dart))) )
 				if (!f(curr_dart))
 					break;
 
 			const Dart d_1 = phi_1(curr_dart);
-			const Dart d2_1 = phi2(d_1); // turn in volume
-			const Dart d3_1 = phi3(d_1); // change volume
-
-			if (!marker.is_marked(d2_1))
-				marker.mark(d2_1);
-			if (!marker.is_marked(d3_1))
-				marker.mark(d3_1);
+			visited.insert(phi2(d_1)); // turn in volume
+			visited.insert(phi3(d_1)); // change volume
 		}
 	}
 
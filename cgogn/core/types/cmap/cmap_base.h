@@ -136,6 +136,19 @@ public:
 		return d;
 	}
 
+	/**
+	 * \brief adds n darts at once, whose relations are fixed points
+	 * \returns the first added dart, the others having the following indices
+	 */
+	Dart add_darts(uint32 n)
+	{
+		const uint32 first = topology_.add_lines(n);
+		for (auto rel : relations_)
+			for (uint32 i = first; i < first + n; ++i)
+				(*rel)[i] = Dart(i);
+		return Dart(first);
+	}
+
 	template <typename FUNC>
 	void foreach_dart(const FUNC& f) const
 	{
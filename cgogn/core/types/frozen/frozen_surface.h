@@ -0,0 +1,235 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_TYPES_FROZEN_FROZEN_SURFACE_H_
+#define CGOGN_CORE_TYPES_FROZEN_FROZEN_SURFACE_H_
+
+#include <cgogn/core/cgogn_core_export.h>
+
+#include <cgogn/core/types/cmap/attributes.h>
+
+#include <cgogn/core/utils/definitions.h>
+#include <cgogn/core/utils/numerics.h>
+
+#include <array>
+#include <vector>
+#include <tuple>
+#include <iostream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/**
+ * \file cgogn/core/types/frozen/frozen_surface.h
+ * \brief Immutable compact indexed surface mesh.
+ */
+
+namespace cgogn
+{
+
+/**
+ * \brief Cell of a FrozenSurface, identified by its index.
+ * \tparam DIM the dimension of the cell
+ */
+template <uint32 DIM_>
+struct FrozenCell
+{
+	static const uint32 DIM = DIM_;
+	using Self = FrozenCell<DIM>;
+
+	uint32 index;
+
+	inline FrozenCell() : index(INVALID_INDEX)
+	{}
+
+	inline explicit FrozenCell(uint32 i) : index(i)
+	{}
+
+	inline bool is_valid() const { return index != INVALID_INDEX; }
+
+	inline bool operator==(Self rhs) const { return index == rhs.index; }
+	inline bool operator!=(Self rhs) const { return index != rhs.index; }
+
+	inline friend std::ostream& operator<<(std::ostream &out, const Self& rhs) { return out << rhs.index; }
+};
+
+/**
+ * \brief Bit vector with a rank directory: rank(i), the number of set bits before i, is computed in constant time.
+ * The bits are set by words (bits 64w ... 64w + 63 in words_[w]) and build_ranks() is then called.
+ */
+struct RankBitVector
+{
+	std::vector<uint64> words_;
+	std::vector<uint32> ranks_; // number of set bits before each word
+
+	inline void resize(uint32 nb_bits)
+	{
+		words_.assign((nb_bits + 63u) / 64u, 0ull);
+	}
+
+	inline void build_ranks()
+	{
+		ranks_.resize(words_.size() + 1u);
+		ranks_[0] = 0u;
+		for (std::size_t w = 0u; w < words_.size(); ++w)
+			ranks_[w + 1u] = ranks_[w] + popcount(words_[w]);
+	}
+
+	inline bool test(uint32 i) const
+	{
+		return (words_[i / 64u] >> (i % 64u)) & 1ull;
+	}
+
+	inline uint32 rank(uint32 i) const
+	{
+		const uint64 w = words_[i / 64u] & ((1ull << (i % 64u)) - 1ull);
+		return ranks_[i / 64u] + popcount(w);
+	}
+
+	static inline uint32 popcount(uint64 x)
+	{
+#ifdef _MSC_VER
+		return uint32(__popcnt64(x));
+#else
+		return uint32(__builtin_popcountll(x));
+#endif
+	}
+};
+
+/**
+ * \brief Read-only snapshot of the topology of a surface (see freeze()).
+ * Faces are stored as a face-vertex CSR whose entries are the half-edges of the surface.
+ * The half-edges of face f are the range [face_offsets_[f], face_offsets_[f+1][,
+ * half-edge h going from vertex halfedge_vertex_[h] to the vertex of the next half-edge of the face.
+ * Boundary half-edges do not exist: the twin of a half-edge incident to the boundary is INVALID_INDEX.
+ * Vertices keep the index of the vertex embedding of the map they come from,
+ * so that the vertex attributes of the map can be used on the snapshot.
+ *
+ * Only the source vertex and the twin of the half-edges are stored (plus the outgoing half-edges of the vertices):
+ * the face of a half-edge is the rank of its face start bit and its edge is the rank of the edge representative
+ * half-edge (the one with the lower index, or the one on the boundary).
+ * For a triangle mesh, this is about 17 bytes per half-edge: as much as a vertex-embedded CMap2 per dart
+ * (phi1, phi_1, phi2, vertex embedding and boundary mark), the snapshot having no boundary darts
+ * and no marker or embedding containers to maintain.
+ */
+struct CGOGN_CORE_EXPORT FrozenSurface
+{
+	using Vertex = FrozenCell<0>;
+	using Edge = FrozenCell<1>;
+	using Face = FrozenCell<2>;
+
+	using Cells = std::tuple<Vertex, Edge, Face>;
+
+	// indices of the vertices
+	std::vector<uint32> vertices_;
+
+	// face-vertex CSR
+	std::vector<uint32> face_offsets_;
+	std::vector<uint32> halfedge_vertex_;
+	RankBitVector face_start_;
+
+	// half-edges relations
+	std::vector<uint32> halfedge_twin_;
+
+	// vertex-face CSR (outgoing half-edges of each vertex index)
+	std::vector<uint32> vertex_offsets_;
+	std::vector<uint32> vertex_halfedges_;
+
+	// edges: representative half-edge of each edge
+	RankBitVector edge_representative_;
+	std::vector<uint32> edge_halfedge_;
+
+	// Cells attributes containers
+	mutable std::array<AttributeContainer, 3> attribute_containers_;
+
+	FrozenSurface()
+	{}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(FrozenSurface);
+
+	inline uint32 nb_vertices() const { return uint32(vertices_.size()); }
+	inline uint32 nb_edges() const { return uint32(edge_halfedge_.size()); }
+	inline uint32 nb_faces() const { return uint32(face_offsets_.size()) - 1u; }
+	inline uint32 nb_halfedges() const { return uint32(halfedge_vertex_.size()); }
+
+	inline uint32 face_size(uint32 f) const
+	{
+		return face_offsets_[f + 1u] - face_offsets_[f];
+	}
+
+	inline uint32 halfedge_face(uint32 h) const
+	{
+		return face_start_.rank(h + 1u) - 1u;
+	}
+
+	inline uint32 halfedge_edge(uint32 h) const
+	{
+		return edge_representative_.rank(edge_representative_.test(h) ? h : halfedge_twin_[h]);
+	}
+
+	inline uint32 edge_vertex(uint32 e, uint32 i) const
+	{
+		const uint32 h = edge_halfedge_[e];
+		return halfedge_vertex_[i == 0u ? h : next(h)];
+	}
+
+	inline uint32 next(uint32 h) const
+	{
+		if (h + 1u < nb_halfedges() && !face_start_.test(h + 1u))
+			return h + 1u;
+		return face_offsets_[halfedge_face(h)];
+	}
+
+	inline uint32 prev(uint32 h) const
+	{
+		if (!face_start_.test(h))
+			return h - 1u;
+		return face_offsets_[halfedge_face(h) + 1u] - 1u;
+	}
+
+	inline bool is_boundary_halfedge(uint32 h) const
+	{
+		return halfedge_twin_[h] == INVALID_INDEX;
+	}
+
+	template <typename FUNC>
+	inline void foreach_halfedge_of_face(uint32 f, const FUNC& func) const
+	{
+		for (uint32 h = face_offsets_[f], end = face_offsets_[f + 1u]; h < end; ++h)
+			if (!func(h))
+				break;
+	}
+
+	template <typename FUNC>
+	inline void foreach_halfedge_of_vertex(uint32 v, const FUNC& func) const
+	{
+		for (uint32 i = vertex_offsets_[v], end = vertex_offsets_[v + 1u]; i < end; ++i)
+			if (!func(vertex_halfedges_[i]))
+				break;
+	}
+};
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_TYPES_FROZEN_FROZEN_SURFACE_H_
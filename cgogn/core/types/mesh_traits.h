@@ -27,6 +27,7 @@
 #include <cgogn/core/cgogn_core_export.h>
 
 #include <cgogn/core/types/cmap/cmap3.h>
+#include <cgogn/core/types/frozen/frozen_surface.h>
 
 namespace cgogn
 {
@@ -86,6 +87,19 @@ struct mesh_traits<CMap3>
 	using Attribute = Attribute<T>;
 };
 
+template <>
+struct mesh_traits<FrozenSurface>
+{
+	using Vertex = FrozenSurface::Vertex;
+	using Edge = FrozenSurface::Edge;
+	using Face = FrozenSurface::Face;
+
+	using Cells = FrozenSurface::Cells;
+
+	template <typename T>
+	using Attribute = Attribute<T>;
+};
+
 } // namespace cgogn
 
 #endif // CGOGN_CORE_TYPES_MESH_TRAITS_H_
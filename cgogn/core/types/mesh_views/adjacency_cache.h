@@ -0,0 +1,156 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_TYPES_MESH_VIEWS_ADJACENCY_CACHE_H_
+#define CGOGN_CORE_TYPES_MESH_VIEWS_ADJACENCY_CACHE_H_
+
+#include <cgogn/core/cgogn_core_export.h>
+
+#include <cgogn/core/types/mesh_traits.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/functions/attributes.h>
+#include <cgogn/core/functions/traversals/global.h>
+#include <cgogn/core/functions/traversals/vertex.h>
+
+#include <numeric>
+
+namespace cgogn
+{
+
+/**
+ * \brief Read-only compressed (CSR) storage of the vertex one-rings of a mesh.
+ * The neighbors of the vertex of index i are stored in the range [offsets[i], offsets[i+1][
+ * of the neighbors arrays. Vertex traversal and adjacent vertex traversal through edges
+ * are then answered by streaming over flat arrays. Other queries are forwarded to the mesh.
+ * The cache has to be rebuilt after any change of the topology of the mesh.
+ * The vertices of the mesh must be embedded.
+ */
+template <typename MESH>
+class AdjacencyCache
+{
+public:
+
+	using Vertex = typename mesh_traits<MESH>::Vertex;
+
+private:
+
+	MESH& m_;
+
+	std::vector<Vertex> vertices_;
+	std::vector<uint32> offsets_;
+	std::vector<Vertex> neighbors_;
+	std::vector<uint32> neighbor_indices_;
+
+	template <typename FUNC>
+	void foreach_cell(const FUNC& f, std::true_type) const
+	{
+		for (Vertex v : vertices_)
+			if (!f(v))
+				break;
+	}
+
+	template <typename FUNC>
+	void foreach_cell(const FUNC& f, std::false_type) const
+	{
+		cgogn::foreach_cell(m_, f);
+	}
+
+public:
+
+	static const bool is_mesh_view = true;
+
+	AdjacencyCache(MESH& m) : m_(m) {}
+
+	MESH& mesh() { return m_; }
+	const MESH& mesh() const { return m_; }
+
+	void build()
+	{
+		vertices_.clear();
+		uint32 nb_indices = 0u;
+		cgogn::foreach_cell(m_, [&] (Vertex v) -> bool
+		{
+			vertices_.push_back(v);
+			nb_indices = std::max(nb_indices, index_of(m_, v) + 1u);
+			return true;
+		});
+
+		// count the neighbors of each vertex
+		offsets_.assign(nb_indices + 1u, 0u);
+		parallel_for(uint32(vertices_.size()), [&] (uint32 i)
+		{
+			uint32 nb = 0u;
+			foreach_adjacent_vertex_through_edge(m_, vertices_[i], [&] (Vertex) -> bool { ++nb; return true; });
+			offsets_[index_of(m_, vertices_[i]) + 1u] = nb;
+		});
+		std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+
+		// fill the rows
+		neighbors_.resize(offsets_.back());
+		neighbor_indices_.resize(offsets_.back());
+		parallel_for(uint32(vertices_.size()), [&] (uint32 i)
+		{
+			uint32 pos = offsets_[index_of(m_, vertices_[i])];
+			foreach_adjacent_vertex_through_edge(m_, vertices_[i], [&] (Vertex av) -> bool
+			{
+				neighbors_[pos] = av;
+				neighbor_indices_[pos] = index_of(m_, av);
+				++pos;
+				return true;
+			});
+		});
+	}
+
+	inline const std::vector<Vertex>& vertices() const { return vertices_; }
+	inline const std::vector<uint32>& offsets() const { return offsets_; }
+	inline const std::vector<uint32>& neighbor_indices() const { return neighbor_indices_; }
+
+	inline uint32 nb_neighbors(Vertex v) const
+	{
+		const uint32 vi = index_of(m_, v);
+		return offsets_[vi + 1u] - offsets_[vi];
+	}
+
+	template <typename FUNC>
+	void foreach_cell(const FUNC& f) const
+	{
+		foreach_cell(f, std::is_same<func_parameter_type<FUNC>, Vertex>());
+	}
+
+	template <typename FUNC>
+	void foreach_adjacent_vertex(Vertex v, const FUNC& f) const
+	{
+		const uint32 vi = index_of(m_, v);
+		for (uint32 i = offsets_[vi], end = offsets_[vi + 1u]; i < end; ++i)
+			if (!f(neighbors_[i]))
+				break;
+	}
+};
+
+template <typename MESH>
+struct mesh_traits<AdjacencyCache<MESH>> : public mesh_traits<MESH>
+{};
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_TYPES_MESH_VIEWS_ADJACENCY_CACHE_H_
@@ -0,0 +1,100 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_UTILS_BOUNDED_QUEUE_H_
+#define CGOGN_CORE_UTILS_BOUNDED_QUEUE_H_
+
+#include <cgogn/core/utils/definitions.h>
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <utility>
+#include <cstddef>
+
+namespace cgogn
+{
+
+/**
+ * \brief FIFO queue of bounded capacity between producer and consumer threads.
+ * push blocks while the queue is full and pop blocks while it is empty;
+ * once the queue is closed, push fails and pop returns the remaining items and then fails.
+ */
+template <typename T>
+class BoundedQueue
+{
+	std::deque<T> items_;
+	std::size_t capacity_;
+	bool closed_;
+	std::mutex mutex_;
+	std::condition_variable not_empty_;
+	std::condition_variable not_full_;
+
+public:
+
+	explicit BoundedQueue(std::size_t capacity) : capacity_(capacity > 0u ? capacity : 1u), closed_(false)
+	{}
+
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(BoundedQueue);
+
+	/**
+	 * \returns false (and drops the item) if the queue is closed, e.g. when the consumer stopped
+	 */
+	bool push(T item)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		not_full_.wait(lock, [this] { return items_.size() < capacity_ || closed_; });
+		if (closed_)
+			return false;
+		items_.push_back(std::move(item));
+		not_empty_.notify_one();
+		return true;
+	}
+
+	/**
+	 * \returns false if the queue is closed and empty
+	 */
+	bool pop(T& item)
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		not_empty_.wait(lock, [this] { return !items_.empty() || closed_; });
+		if (items_.empty())
+			return false;
+		item = std::move(items_.front());
+		items_.pop_front();
+		not_full_.notify_one();
+		return true;
+	}
+
+	void close()
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		closed_ = true;
+		not_empty_.notify_all();
+		not_full_.notify_all();
+	}
+};
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_UTILS_BOUNDED_QUEUE_H_
@@ -0,0 +1,172 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_UTILS_BUFFERS_H_
+#define CGOGN_CORE_UTILS_BUFFERS_H_
+
+#include <cgogn/core/utils/numerics.h>
+
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <cstddef>
+
+namespace cgogn
+{
+
+/**
+ * \brief Per-thread pool of reusable vectors.
+ * Traversals that need some temporary storage take a buffer from the pool of
+ * the current thread instead of allocating (and instead of using a marker,
+ * which is not thread-safe). Buffers are stacked so that traversals can be nested.
+ */
+template <typename T>
+class Buffers
+{
+	std::vector<std::unique_ptr<std::vector<T>>> free_buffers_;
+
+public:
+
+	inline std::vector<T>* buffer()
+	{
+		if (free_buffers_.empty())
+		{
+			std::vector<T>* v = new std::vector<T>();
+			v->reserve(128u);
+			return v;
+		}
+		std::vector<T>* v = free_buffers_.back().release();
+		free_buffers_.pop_back();
+		return v;
+	}
+
+	inline void release_buffer(std::vector<T>* v)
+	{
+		v->clear();
+		free_buffers_.emplace_back(v);
+	}
+};
+
+template <typename T>
+inline Buffers<T>& thread_buffers()
+{
+	static thread_local Buffers<T> buffers;
+	return buffers;
+}
+
+/**
+ * \brief RAII helper taking a buffer from the pool of the current thread
+ */
+template <typename T>
+class BufferGuard
+{
+	std::vector<T>* buffer_;
+
+public:
+
+	inline BufferGuard() : buffer_(thread_buffers<T>().buffer()) {}
+	inline ~BufferGuard() { thread_buffers<T>().release_buffer(buffer_); }
+
+	BufferGuard(const BufferGuard&) = delete;
+	BufferGuard& operator=(const BufferGuard&) = delete;
+
+	inline std::vector<T>& operator*() { return *buffer_; }
+	inline std::vector<T>* operator->() { return buffer_; }
+};
+
+/**
+ * \brief set of the elements visited by a traversal, in their order of insertion.
+ * The elements are stored in buffers of the current thread (so that traversals can run concurrently
+ * without allocating): small sets are searched linearly and larger ones through an open addressing hash table.
+ * T() marks the empty slots of the table and must not be inserted.
+ */
+template <typename T>
+class VisitedSet
+{
+	static const std::size_t LINEAR_SEARCH_SIZE = 64u;
+
+	BufferGuard<T> elements_;
+	BufferGuard<T> table_;
+
+	inline bool table_insert(T e)
+	{
+		const std::size_t mask = table_->size() - 1u;
+		std::size_t i = std::size_t((uint64(std::hash<T>()(e)) * 0x9E3779B97F4A7C15ull) >> 32u) & mask;
+		for (;; i = (i + 1u) & mask)
+		{
+			if ((*table_)[i] == e)
+				return false;
+			if ((*table_)[i] == T())
+			{
+				(*table_)[i] = e;
+				return true;
+			}
+		}
+	}
+
+	inline void rehash(std::size_t capacity)
+	{
+		table_->assign(capacity, T());
+		for (T e : *elements_)
+			table_insert(e);
+	}
+
+public:
+
+	inline VisitedSet() {}
+	VisitedSet(const VisitedSet&) = delete;
+	VisitedSet& operator=(const VisitedSet&) = delete;
+
+	/**
+	 * \returns false if e was already in the set
+	 */
+	inline bool insert(T e)
+	{
+		if (table_->empty())
+		{
+			if (elements_->size() < LINEAR_SEARCH_SIZE)
+			{
+				if (std::find(elements_->begin(), elements_->end(), e) != elements_->end())
+					return false;
+				elements_->push_back(e);
+				return true;
+			}
+			rehash(4u * LINEAR_SEARCH_SIZE);
+		}
+		else if (2u * (elements_->size() + 1u) > table_->size())
+			rehash(2u * table_->size());
+
+		if (!table_insert(e))
+			return false;
+		elements_->push_back(e);
+		return true;
+	}
+
+	inline std::size_t size() { return elements_->size(); }
+	inline T operator[](std::size_t i) { return (*elements_)[i]; }
+};
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_UTILS_BUFFERS_H_
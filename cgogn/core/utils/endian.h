@@ -0,0 +1,159 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_UTILS_ENDIAN_H_
+#define CGOGN_CORE_UTILS_ENDIAN_H_
+
+#include <cgogn/core/utils/numerics.h>
+
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+
+#ifdef _MSC_VER
+#include <stdlib.h>
+#endif
+
+namespace cgogn
+{
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static const bool CGOGN_NATIVE_LITTLE_ENDIAN = false;
+#else
+static const bool CGOGN_NATIVE_LITTLE_ENDIAN = true;
+#endif
+
+namespace internal
+{
+
+inline uint16 byte_swap(uint16 x)
+{
+	return uint16((x >> 8) | (x << 8));
+}
+
+inline uint32 byte_swap(uint32 x)
+{
+#if defined(_MSC_VER)
+	return _byteswap_ulong(x);
+#else
+	return __builtin_bswap32(x);
+#endif
+}
+
+inline uint64 byte_swap(uint64 x)
+{
+#if defined(_MSC_VER)
+	return _byteswap_uint64(x);
+#else
+	return __builtin_bswap64(x);
+#endif
+}
+
+template <std::size_t SIZE>
+struct UIntOfSize;
+template <> struct UIntOfSize<2u> { using type = uint16; };
+template <> struct UIntOfSize<4u> { using type = uint32; };
+template <> struct UIntOfSize<8u> { using type = uint64; };
+
+} // namespace internal
+
+/**
+ * \brief reverses the order of the bytes of a value (of an arithmetic type)
+ */
+template <typename T>
+inline typename std::enable_if<sizeof(T) == 1u, T>::type swap_endianness(const T& x)
+{
+	return x;
+}
+
+template <typename T>
+inline typename std::enable_if<sizeof(T) != 1u, T>::type swap_endianness(const T& x)
+{
+	static_assert(std::is_arithmetic<T>::value, "swap_endianness: arithmetic type expected");
+	using U = typename internal::UIntOfSize<sizeof(T)>::type;
+	U u;
+	std::memcpy(&u, &x, sizeof(T));
+	u = internal::byte_swap(u);
+	T r;
+	std::memcpy(&r, &u, sizeof(T));
+	return r;
+}
+
+/**
+ * \brief converts a value between the native byte order and big endian (in both directions)
+ */
+template <typename T>
+inline T swap_endianness_native_big(const T& x)
+{
+	return CGOGN_NATIVE_LITTLE_ENDIAN ? swap_endianness(x) : x;
+}
+
+/**
+ * \brief converts a value between the native byte order and little endian (in both directions)
+ */
+template <typename T>
+inline T swap_endianness_native_little(const T& x)
+{
+	return CGOGN_NATIVE_LITTLE_ENDIAN ? x : swap_endianness(x);
+}
+
+/**
+ * \brief reverses in place the order of the bytes of n values.
+ * The values are processed as unsigned integers in a plain loop that compilers vectorize (byte shuffles).
+ */
+template <typename T>
+inline typename std::enable_if<sizeof(T) == 1u>::type swap_endianness(T*, std::size_t)
+{}
+
+template <typename T>
+inline typename std::enable_if<sizeof(T) != 1u>::type swap_endianness(T* data, std::size_t n)
+{
+	static_assert(std::is_arithmetic<T>::value, "swap_endianness: arithmetic type expected");
+	using U = typename internal::UIntOfSize<sizeof(T)>::type;
+	char* bytes = reinterpret_cast<char*>(data);
+	for (std::size_t i = 0u; i < n; ++i, bytes += sizeof(U))
+	{
+		U u;
+		std::memcpy(&u, bytes, sizeof(U)); // no aliasing of T as U
+		u = internal::byte_swap(u);
+		std::memcpy(bytes, &u, sizeof(U));
+	}
+}
+
+template <typename T>
+inline void swap_endianness_native_big(T* data, std::size_t n)
+{
+	if (CGOGN_NATIVE_LITTLE_ENDIAN)
+		swap_endianness(data, n);
+}
+
+template <typename T>
+inline void swap_endianness_native_little(T* data, std::size_t n)
+{
+	if (!CGOGN_NATIVE_LITTLE_ENDIAN)
+		swap_endianness(data, n);
+}
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_UTILS_ENDIAN_H_
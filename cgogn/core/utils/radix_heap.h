@@ -0,0 +1,168 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_UTILS_RADIX_HEAP_H_
+#define CGOGN_CORE_UTILS_RADIX_HEAP_H_
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/assert.h>
+
+#include <vector>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace cgogn
+{
+
+/**
+ * \brief monotone priority queue of (key, value) pairs with non-negative floating point keys.
+ *
+ * The keys pushed must not be smaller than the last key popped (as in Dijkstra's algorithm).
+ * The elements are stored in buckets given by the highest bit in which their key differs from the last popped key:
+ * push is O(1) and each element is moved at most once per bit of the key, without any comparison-based sift.
+ * There is no decrease-key: push the element again and skip the outdated entries when popping them.
+ */
+template <typename VALUE, typename KEY = float64>
+class RadixHeap
+{
+	static_assert(std::is_floating_point<KEY>::value, "RadixHeap keys must be floating point values");
+
+	using Bits = typename std::conditional<sizeof(KEY) == 8u, uint64, uint32>::type;
+	static const uint32 NB_BITS = 8u * sizeof(Bits);
+
+	std::array<std::vector<std::pair<Bits, VALUE>>, NB_BITS + 1u> buckets_;
+	Bits last_;
+	std::size_t size_;
+
+	// the bit patterns of non-negative IEEE floats are ordered as the floats themselves
+	static Bits bits(KEY key)
+	{
+		if (key == KEY(0))
+			key = KEY(0); // -0 has the sign bit set
+		Bits b;
+		std::memcpy(&b, &key, sizeof(Bits));
+		return b;
+	}
+
+	static KEY key(Bits b)
+	{
+		KEY k;
+		std::memcpy(&k, &b, sizeof(Bits));
+		return k;
+	}
+
+	static uint32 highest_bit(uint64 x)
+	{
+#ifdef _MSC_VER
+		unsigned long i;
+		_BitScanReverse64(&i, x);
+		return uint32(i);
+#else
+		return 63u - uint32(__builtin_clzll(x));
+#endif
+	}
+
+	uint32 bucket(Bits b) const
+	{
+		return b == last_ ? 0u : highest_bit(uint64(b ^ last_)) + 1u;
+	}
+
+	// moves the elements of the first non-empty bucket into the lower buckets when bucket 0 is empty
+	void refill()
+	{
+		if (!buckets_[0].empty())
+			return;
+		uint32 i = 1u;
+		while (buckets_[i].empty())
+			++i;
+		Bits min = buckets_[i][0].first;
+		for (const auto& e : buckets_[i])
+			if (e.first < min)
+				min = e.first;
+		last_ = min;
+		for (const auto& e : buckets_[i])
+			buckets_[bucket(e.first)].push_back(e);
+		buckets_[i].clear();
+	}
+
+public:
+
+	RadixHeap() : last_(0), size_(0u)
+	{}
+
+	bool empty() const { return size_ == 0u; }
+	std::size_t size() const { return size_; }
+
+	void clear()
+	{
+		for (auto& b : buckets_)
+			b.clear();
+		last_ = 0;
+		size_ = 0u;
+	}
+
+	void push(KEY k, const VALUE& v)
+	{
+		cgogn_message_assert(k >= KEY(0), "RadixHeap: negative key");
+		const Bits b = bits(k);
+		cgogn_message_assert(b >= last_, "RadixHeap: key smaller than the last popped key");
+		buckets_[bucket(b)].emplace_back(b, v);
+		++size_;
+	}
+
+	/**
+	 * \brief smallest key of the heap (the heap must not be empty)
+	 */
+	KEY top_key()
+	{
+		refill();
+		return key(last_);
+	}
+
+	/**
+	 * \brief removes an element of smallest key and returns it (the heap must not be empty)
+	 */
+	std::pair<KEY, VALUE> pop()
+	{
+		cgogn_message_assert(!empty(), "RadixHeap: pop on an empty heap");
+		refill();
+		std::pair<KEY, VALUE> res(key(last_), buckets_[0].back().second);
+		buckets_[0].pop_back();
+		--size_;
+		return res;
+	}
+};
+
+template <typename VALUE, typename KEY>
+const uint32 RadixHeap<VALUE, KEY>::NB_BITS;
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_UTILS_RADIX_HEAP_H_
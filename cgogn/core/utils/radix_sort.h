@@ -0,0 +1,112 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_UTILS_RADIX_SORT_H_
+#define CGOGN_CORE_UTILS_RADIX_SORT_H_
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+#include <vector>
+#include <array>
+#include <algorithm>
+
+namespace cgogn
+{
+
+/**
+ * \brief sorts (key, value) pairs by increasing key with a parallel LSD radix sort (8 bits per pass).
+ * The sort is stable and its result does not depend on the number of threads.
+ * Each pass counts the digits of fixed size chunks in parallel and scatters the chunks in parallel;
+ * the passes in which all the keys have the same digit are skipped.
+ * \param[in] key_bits number of significant low bits of the keys
+ */
+template <typename VALUE>
+void parallel_radix_sort(std::vector<uint64>& keys, std::vector<VALUE>& values, uint32 key_bits = 64u)
+{
+	static const uint32 RADIX = 256u;
+	static const uint32 CHUNK_SIZE = 1u << 16u;
+
+	cgogn_message_assert(keys.size() == values.size(), "parallel_radix_sort: keys and values sizes differ");
+	const uint32 n = uint32(keys.size());
+	if (n < 2u)
+		return;
+
+	const uint32 nbc = nb_chunks(n, CHUNK_SIZE);
+	std::vector<std::array<uint32, RADIX>> offsets(nbc);
+	std::vector<uint64> tmp_keys(n);
+	std::vector<VALUE> tmp_values(n);
+
+	for (uint32 shift = 0u; shift < key_bits; shift += 8u)
+	{
+		parallel_foreach_chunk(n, [&] (uint32 c, uint32 begin, uint32 end)
+		{
+			std::array<uint32, RADIX>& h = offsets[c];
+			h.fill(0u);
+			for (uint32 i = begin; i < end; ++i)
+				++h[(keys[i] >> shift) & (RADIX - 1u)];
+		}, CHUNK_SIZE);
+
+		// a digit holding all the keys leaves the order unchanged
+		bool trivial = false;
+		for (uint32 d = 0u; d < RADIX && !trivial; ++d)
+		{
+			uint32 total = 0u;
+			for (uint32 c = 0u; c < nbc; ++c)
+				total += offsets[c][d];
+			trivial = total == n;
+		}
+		if (trivial)
+			continue;
+
+		// the keys of a digit are placed in chunk order
+		uint32 sum = 0u;
+		for (uint32 d = 0u; d < RADIX; ++d)
+		{
+			for (uint32 c = 0u; c < nbc; ++c)
+			{
+				const uint32 count = offsets[c][d];
+				offsets[c][d] = sum;
+				sum += count;
+			}
+		}
+
+		parallel_foreach_chunk(n, [&] (uint32 c, uint32 begin, uint32 end)
+		{
+			std::array<uint32, RADIX>& o = offsets[c];
+			for (uint32 i = begin; i < end; ++i)
+			{
+				const uint32 p = o[(keys[i] >> shift) & (RADIX - 1u)]++;
+				tmp_keys[p] = keys[i];
+				tmp_values[p] = values[i];
+			}
+		}, CHUNK_SIZE);
+
+		keys.swap(tmp_keys);
+		values.swap(tmp_values);
+	}
+}
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_UTILS_RADIX_SORT_H_
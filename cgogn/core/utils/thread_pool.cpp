@@ -0,0 +1,104 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <cgogn/core/utils/thread_pool.h>
+
+namespace cgogn
+{
+
+ThreadPool::ThreadPool(uint32 nb_workers) :
+	stop_(false)
+{
+	for (uint32 i = 0u; i < nb_workers; ++i)
+	{
+		workers_.emplace_back([this] ()
+		{
+			while (true)
+			{
+				std::packaged_task<void()> task;
+				{
+					std::unique_lock<std::mutex> lock(queue_mutex_);
+					condition_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+					if (stop_ && tasks_.empty())
+						return;
+					task = std::move(tasks_.front());
+					tasks_.pop();
+				}
+				task();
+			}
+		});
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::unique_lock<std::mutex> lock(queue_mutex_);
+		stop_ = true;
+	}
+	condition_.notify_all();
+	for (std::thread& worker : workers_)
+		worker.join();
+}
+
+std::future<void> ThreadPool::enqueue(const std::function<void()>& task)
+{
+	std::packaged_task<void()> pt(task);
+	std::future<void> res = pt.get_future();
+	{
+		std::unique_lock<std::mutex> lock(queue_mutex_);
+		tasks_.push(std::move(pt));
+	}
+	condition_.notify_one();
+	return res;
+}
+
+ThreadPool* thread_pool()
+{
+	static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1u);
+	return &pool;
+}
+
+namespace
+{
+
+thread_local bool parallel_region_ = false;
+
+} // namespace
+
+bool in_parallel_region()
+{
+	return parallel_region_;
+}
+
+namespace internal
+{
+
+void set_parallel_region(bool b)
+{
+	parallel_region_ = b;
+}
+
+} // namespace internal
+
+} // namespace cgogn
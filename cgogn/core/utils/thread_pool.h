@@ -0,0 +1,228 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_CORE_UTILS_THREAD_POOL_H_
+#define CGOGN_CORE_UTILS_THREAD_POOL_H_
+
+#include <cgogn/core/cgogn_core_export.h>
+
+#include <cgogn/core/utils/definitions.h>
+#include <cgogn/core/utils/numerics.h>
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+namespace cgogn
+{
+
+/**
+ * \brief Fixed size pool of worker threads.
+ * Tasks are executed in FIFO order by the first available worker.
+ */
+class CGOGN_CORE_EXPORT ThreadPool
+{
+	std::vector<std::thread> workers_;
+	std::queue<std::packaged_task<void()>> tasks_;
+	std::mutex queue_mutex_;
+	std::condition_variable condition_;
+	bool stop_;
+
+public:
+
+	ThreadPool(uint32 nb_workers);
+	~ThreadPool();
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ThreadPool);
+
+	inline uint32 nb_workers() const { return uint32(workers_.size()); }
+
+	std::future<void> enqueue(const std::function<void()>& task);
+};
+
+/**
+ * \brief the pool shared by all the parallel algorithms of cgogn.
+ * It holds (hardware_concurrency - 1) workers, the calling thread taking part in the work.
+ */
+CGOGN_CORE_EXPORT ThreadPool* thread_pool();
+
+/**
+ * \brief tells whether the current thread is already executing a parallel task.
+ * Parallel algorithms called from such a thread run sequentially.
+ */
+CGOGN_CORE_EXPORT bool in_parallel_region();
+
+namespace internal
+{
+
+CGOGN_CORE_EXPORT void set_parallel_region(bool b);
+
+/**
+ * \brief RAII helper marking the current thread as executing a parallel task
+ */
+class ParallelRegionGuard
+{
+	bool previous_;
+
+public:
+
+	inline ParallelRegionGuard() : previous_(in_parallel_region()) { set_parallel_region(true); }
+	inline ~ParallelRegionGuard() { set_parallel_region(previous_); }
+	CGOGN_NOT_COPYABLE_NOR_MOVABLE(ParallelRegionGuard);
+};
+
+} // namespace internal
+
+/**
+ * \brief default number of elements processed by a task.
+ * Chunks boundaries only depend on the number of elements (and not on the number of threads)
+ * so that per-chunk results can be combined deterministically.
+ */
+static const uint32 PARALLEL_CHUNK_SIZE = 1024u;
+
+inline uint32 nb_chunks(uint32 size, uint32 chunk_size = PARALLEL_CHUNK_SIZE)
+{
+	return (size + chunk_size - 1u) / chunk_size;
+}
+
+/**
+ * \brief applies f on the chunks of the range [0, size[ using the threads of the pool.
+ * If f throws, the remaining chunks are not processed and the first exception caught
+ * is rethrown on the calling thread once all the tasks are over.
+ * \param[in] f a function taking the chunk index and the [begin, end[ bounds of the chunk
+ */
+template <typename FUNC>
+void parallel_foreach_chunk(uint32 size, const FUNC& f, uint32 chunk_size = PARALLEL_CHUNK_SIZE)
+{
+	const uint32 nbc = nb_chunks(size, chunk_size);
+	if (nbc == 0u)
+		return;
+
+	ThreadPool* pool = thread_pool();
+	if (nbc == 1u || pool->nb_workers() == 0u || in_parallel_region())
+	{
+		for (uint32 c = 0u; c < nbc; ++c)
+			f(c, c * chunk_size, std::min(size, (c + 1u) * chunk_size));
+		return;
+	}
+
+	std::atomic<uint32> next_chunk(0u);
+	auto process_chunks = [&] ()
+	{
+		internal::ParallelRegionGuard guard;
+		try
+		{
+			for (uint32 c = next_chunk++; c < nbc; c = next_chunk++)
+				f(c, c * chunk_size, std::min(size, (c + 1u) * chunk_size));
+		}
+		catch (...)
+		{
+			next_chunk = nbc; // the other threads stop taking chunks
+			throw;
+		}
+	};
+
+	const uint32 nb_tasks = std::min(nbc - 1u, pool->nb_workers());
+	std::vector<std::future<void>> futures;
+	futures.reserve(nb_tasks);
+	for (uint32 i = 0u; i < nb_tasks; ++i)
+		futures.push_back(pool->enqueue(process_chunks));
+
+	// the tasks use the locals of this function: they must all be over before leaving it
+	std::exception_ptr error;
+	try
+	{
+		process_chunks();
+	}
+	catch (...)
+	{
+		error = std::current_exception();
+	}
+	for (std::future<void>& fu : futures)
+	{
+		try
+		{
+			fu.get();
+		}
+		catch (...)
+		{
+			if (!error)
+				error = std::current_exception();
+		}
+	}
+	if (error)
+		std::rethrow_exception(error);
+}
+
+/**
+ * \brief applies f on every index of the range [0, size[ using the threads of the pool.
+ */
+template <typename FUNC>
+void parallel_for(uint32 size, const FUNC& f, uint32 chunk_size = PARALLEL_CHUNK_SIZE)
+{
+	parallel_foreach_chunk(size, [&] (uint32, uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+			f(i);
+	}, chunk_size);
+}
+
+/**
+ * \brief computes reduce(init, reduce(transform(0), ..., transform(size - 1))) using the threads of the pool.
+ * A partial result is computed for each chunk and the partial results are then combined pairwise,
+ * in chunk order: the result only depends on the size of the range and not on the number of threads.
+ * \param[in] reduce an associative function combining two values of type T
+ * \param[in] transform a function computing a value of type T from an index of the range
+ */
+template <typename T, typename REDUCE, typename TRANSFORM>
+T parallel_transform_reduce(uint32 size, const T& init, const REDUCE& reduce, const TRANSFORM& transform, uint32 chunk_size = PARALLEL_CHUNK_SIZE)
+{
+	const uint32 nbc = nb_chunks(size, chunk_size);
+	if (nbc == 0u)
+		return init;
+
+	std::vector<T> partials(nbc, init);
+	parallel_foreach_chunk(size, [&] (uint32 c, uint32 begin, uint32 end)
+	{
+		T partial = transform(begin);
+		for (uint32 i = begin + 1u; i < end; ++i)
+			partial = reduce(partial, transform(i));
+		partials[c] = partial;
+	}, chunk_size);
+
+	for (uint32 step = 1u; step < nbc; step *= 2u)
+		for (uint32 c = 0u; c + step < nbc; c += 2u * step)
+			partials[c] = reduce(partials[c], partials[c + step]);
+
+	return reduce(init, partials[0]);
+}
+
+} // namespace cgogn
+
+#endif // CGOGN_CORE_UTILS_THREAD_POOL_H_
@@ -25,6 +25,7 @@
 #define CGOGN_CORE_UTILS_TYPE_TRAITS_H_
 
 #include <tuple>
+#include <cstddef>
 
 namespace cgogn
 {
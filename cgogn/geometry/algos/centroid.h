@@ -52,17 +52,18 @@ centroid(
 	VEC result;
 	set_zero(result);
 	uint32 count = 0;
-	foreach_incident_vertex(m, c, [&] (Vertex v)
+	foreach_incident_vertex(m, c, [&] (Vertex v) -> bool
 	{
 		result += value<VEC>(m, attribute, v);
 		++count;
+		return true;
 	});
 	result /= Scalar(count);
 	return result;
 }
 
 template <typename VEC, typename MESH>
-void
+VEC
 centroid(
 	const MESH& m,
 	const typename mesh_traits<MESH>::template Attribute<VEC>* attribute
@@ -70,16 +71,15 @@ centroid(
 {
 	using Vertex = typename mesh_traits<MESH>::Vertex;
 	using Scalar = typename vector_traits<VEC>::Scalar;
-	VEC result;
-	set_zero(result);
-	uint32 count = 0;
-	foreach_cell(m, [&] (Vertex v)
-	{
-		result += value<VEC>(m, attribute, v);
-		++count;
-	});
-	result /= Scalar(count);
-	return result;
+	using SumCount = std::pair<VEC, uint32>;
+	SumCount zero;
+	set_zero(zero.first);
+	zero.second = 0;
+	SumCount sum = parallel_reduce_cells(m, zero,
+		[] (const SumCount& a, const SumCount& b) -> SumCount { return SumCount(a.first + b.first, a.second + b.second); },
+		[&] (Vertex v) -> SumCount { return SumCount(value<VEC>(m, attribute, v), 1u); }
+	);
+	return sum.first / Scalar(sum.second);
 }
 
 template <typename VEC, typename CELL, typename MESH,
@@ -91,9 +91,10 @@ compute_centroid(
 	typename mesh_traits<MESH>::template Attribute<VEC>* cell_centroid
 )
 {
-	foreach_cell(m, [&] (CELL c)
+	foreach_cell(m, [&] (CELL c) -> bool
 	{
 		value<VEC>(m, cell_centroid, c) = centroid<VEC>(m, c, attribute);
+		return true;
 	});
 }
 
@@ -106,19 +107,18 @@ central_vertex(
 {
 	using Vertex = typename mesh_traits<MESH>::Vertex;
 	using Scalar = typename vector_traits<VEC>::Scalar;
+	using DistVertex = std::pair<Scalar, Vertex>;
 	VEC center = centroid<VEC>(m, attribute);
-	Scalar min_dist = std::numeric_limits<Scalar>::max();
-	Vertex min_vertex;
-	foreach_cell(m, [&] (Vertex v)
-	{
-		Scalar distance = square_norm(value(m, attribute, v) - center);
-		if (distance < min_dist)
+	// on equal distances, the first vertex in traversal order is kept
+	DistVertex closest = parallel_reduce_cells(m, DistVertex(std::numeric_limits<Scalar>::max(), Vertex()),
+		[] (const DistVertex& a, const DistVertex& b) -> DistVertex { return b.first < a.first ? b : a; },
+		[&] (Vertex v) -> DistVertex
 		{
-			min_dist = distance;
-			min_vertex = v;
+			VEC d = value<VEC>(m, attribute, v) - center;
+			return DistVertex(squared_norm(d), v);
 		}
-	});
-	return min_vertex;
+	);
+	return closest.second;
 }
 
 } // namespace geometry
@@ -26,22 +26,155 @@
 
 #include <cgogn/core/types/mesh_traits.h>
 #include <cgogn/core/functions/traversals/global.h>
+#include <cgogn/core/functions/traversals/vertex.h>
 #include <cgogn/core/functions/traversals/edge.h>
 #include <cgogn/core/functions/attributes.h>
 
 #include <cgogn/geometry/types/vector_traits.h>
 #include <cgogn/geometry/functions/vector_ops.h>
+#include <cgogn/geometry/algos/laplacian.h>
 
 #include <Eigen/IterativeLinearSolvers>
 
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
 namespace cgogn
 {
 
 namespace geometry
 {
 
+namespace internal
+{
+
+/**
+ * \brief neighborhoods of the vertices of a mesh (or of the vertices kept by a mesh view),
+ * stored as attribute indices: the i-th vertex has index vertex_index[i] and its adjacent vertices
+ * have indices neighbors[offsets[i]] ... neighbors[offsets[i+1] - 1]
+ */
+struct VertexNeighborhoods
+{
+	std::vector<uint32> vertex_index;
+	std::vector<uint32> offsets;
+	std::vector<uint32> neighbors;
+
+	uint32 size() const { return uint32(vertex_index.size()); }
+};
+
+template <typename MESH>
+VertexNeighborhoods
+vertex_neighborhoods(const MESH& m)
+{
+	using Vertex = typename mesh_traits<MESH>::Vertex;
+
+	// markers are not thread-safe: vertices are gathered sequentially and then processed in parallel
+	std::vector<Vertex> vertices;
+	foreach_cell(m, [&] (Vertex v) -> bool { vertices.push_back(v); return true; });
+	const uint32 nbv = uint32(vertices.size());
+
+	VertexNeighborhoods nh;
+	nh.vertex_index.resize(nbv);
+	nh.offsets.resize(nbv + 1u);
+	nh.offsets[0] = 0u;
+	parallel_for(nbv, [&] (uint32 i)
+	{
+		nh.vertex_index[i] = index_of(m, vertices[i]);
+		uint32 count = 0u;
+		foreach_adjacent_vertex_through_edge(m, vertices[i], [&] (Vertex) -> bool { ++count; return true; });
+		nh.offsets[i + 1u] = count;
+	});
+	for (uint32 i = 0u; i < nbv; ++i)
+		nh.offsets[i + 1u] += nh.offsets[i];
+
+	nh.neighbors.resize(nh.offsets[nbv]);
+	parallel_for(nbv, [&] (uint32 i)
+	{
+		uint32 k = nh.offsets[i];
+		foreach_adjacent_vertex_through_edge(m, vertices[i], [&] (Vertex av) -> bool
+		{
+			nh.neighbors[k++] = index_of(m, av);
+			return true;
+		});
+	});
+
+	return nh;
+}
+
+/**
+ * \brief runs at most nb_iterations iterations of a filter made of nb_steps Jacobi steps.
+ * The values are read from one buffer and written into the other one, the buffers being swapped after each step:
+ * the first buffer is the attribute itself, the second one is a copy of it, so that the values of the vertices
+ * that are not filtered are the same in both buffers.
+ * The iterations stop as soon as no vertex moved by more than convergence during an iteration.
+ * \param[in] update computes the new value of the i-th vertex of nh at the given step from the values of the buffer in
+ * \returns the number of iterations that were run
+ */
+template <typename VEC, typename UPDATE>
+uint32
+filter_iterate(
+	const VertexNeighborhoods& nh,
+	Attribute<VEC>* attribute,
+	uint32 nb_iterations,
+	uint32 nb_steps,
+	typename vector_traits<VEC>::Scalar convergence,
+	const UPDATE& update
+)
+{
+	using Scalar = typename vector_traits<VEC>::Scalar;
+
+	if (nh.size() == 0u || nb_iterations == 0u)
+		return 0u;
+
+	std::vector<VEC> buffer(attribute->begin(), attribute->end());
+	VEC* attribute_data = &(*attribute)[0];
+	VEC* in = attribute_data;
+	VEC* out = buffer.data();
+
+	auto max_reduce = [] (Scalar a, Scalar b) -> Scalar { return std::max(a, b); };
+	const Scalar squared_convergence = convergence * convergence;
+
+	uint32 it = 0u;
+	while (it < nb_iterations)
+	{
+		Scalar max_move = Scalar(0);
+		for (uint32 step = 0u; step < nb_steps; ++step)
+		{
+			const VEC* cin = in;
+			max_move = std::max(max_move, parallel_transform_reduce(nh.size(), Scalar(0), max_reduce, [&] (uint32 i) -> Scalar
+			{
+				const uint32 index = nh.vertex_index[i];
+				out[index] = update(step, i, cin);
+				return squared_norm(VEC(out[index] - cin[index]));
+			}));
+			std::swap(in, out);
+		}
+		++it;
+		if (max_move <= squared_convergence)
+			break;
+	}
+
+	if (in != attribute_data)
+		parallel_for(nh.size(), [&] (uint32 i)
+		{
+			const uint32 index = nh.vertex_index[i];
+			attribute_data[index] = in[index];
+		});
+	attribute->notify_modification();
+
+	return it;
+}
+
+} // namespace internal
+
+/**
+ * \brief replaces the value of each vertex by the average of the values of its adjacent vertices (one pass in parallel).
+ * attribute_out must contain a copy of attribute_in for the vertices that are filtered out by a mesh view.
+ */
 template <typename VEC, typename MESH>
-void filter_average(
+void
+filter_average(
 	const MESH& m,
 	const typename mesh_traits<MESH>::template Attribute<VEC>* attribute_in,
 	typename mesh_traits<MESH>::template Attribute<VEC>* attribute_out
@@ -49,7 +182,7 @@ void filter_average(
 {
 	using Scalar = typename vector_traits<VEC>::Scalar;
 	using Vertex = typename mesh_traits<MESH>::Vertex;
-	foreach_cell(m, [&] (Vertex v) -> bool
+	parallel_foreach_cell(m, [&] (Vertex v) -> bool
 	{
 		VEC sum;
 		set_zero(sum);
@@ -60,206 +193,186 @@ void filter_average(
 			++count;
 			return true;
 		});
-		value<VEC>(m, attribute_out, v) = sum / Scalar(count);
+		value<VEC>(m, attribute_out, v) = count > 0 ? VEC(sum / Scalar(count)) : value<VEC>(m, attribute_in, v);
 		return true;
 	});
+	attribute_out->notify_modification();
 }
 
-//template <typename MAP, typename MASK, typename VERTEX_ATTR>
-//void filter_bilateral(
-//	const MAP& map,
-//	const MASK& mask,
-//	const VERTEX_ATTR& position_in,
-//	VERTEX_ATTR& position_out,
-//	const VERTEX_ATTR& normal
-//)
-//{
-//	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value, "position_in, position_out & normal must be a vertex attribute");
-
-//	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
-//	using Scalar = ScalarOf<VEC3>;
-//	using Vertex = typename MAP::Vertex;
-//	using Edge = typename MAP::Edge;
-
-//	Scalar length_sum = 0;
-//	Scalar angle_sum = 0;
-//	uint32 nb_edges = 0;
-
-//	map.foreach_cell([&] (Edge e)
-//	{
-//		std::pair<Vertex, Vertex> v = map.vertices(e);
-//		VEC3 edge = position_in[v.first] - position_in[v.second];
-//		length_sum += edge.norm();
-//		angle_sum += angle(normal[v.first], normal[v.second]);
-//		++nb_edges;
-//	},
-//	mask);
-
-//	Scalar sigmaC = 1.0 * (length_sum / Scalar(nb_edges));
-//	Scalar sigmaS = 2.5 * (angle_sum / Scalar(nb_edges));
-
-//	map.parallel_foreach_cell([&] (Vertex v)
-//	{
-//		const VEC3& n = normal[v];
-
-//		Scalar sum = 0, normalizer = 0;
-//		map.foreach_adjacent_vertex_through_edge(v, [&] (Vertex av)
-//		{
-//			VEC3 edge = position_in[av] - position_in[v];
-//			Scalar t = edge.norm();
-//			Scalar h = n.dot(edge);
-//			Scalar wcs = std::exp((-1.0 * (t * t) / (2.0 * sigmaC * sigmaC)) + (-1.0 * (h * h) / (2.0 * sigmaS * sigmaS)));
-//			sum += wcs * h;
-//			normalizer += wcs;
-//		});
-
-//		position_out[v] = position_in[v] + ((sum / normalizer) * n);
-//	},
-//	mask);
-//}
-
-//template <typename MAP, typename MASK, typename VERTEX_ATTR>
-//void filter_taubin(
-//	const MAP& map,
-//	const MASK& mask,
-//	VERTEX_ATTR& position,
-//	VERTEX_ATTR& position_tmp)
-//{
-//	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value, "position & position_tmp must be a vertex attribute");
-
-//	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
-//	using Scalar = ScalarOf<VEC3>;
-//	using Vertex = typename MAP::Vertex;
-
-//	const Scalar lambda = 0.6307;
-//	const Scalar mu = -0.6532;
-
-//	map.parallel_foreach_cell([&] (Vertex v)
-//	{
-//		VEC3 avg;
-//		set_zero(avg);
-//		uint32 count = 0;
-//		map.foreach_adjacent_vertex_through_edge(v, [&] (Vertex av)
-//		{
-//			avg += position[av];
-//			++count;
-//		});
-//		avg /= Scalar(count);
-//		const VEC3& p = position[v];
-//		position_tmp[v] = p + ((avg - p) * lambda);
-//	},
-//	mask);
-
-//	map.parallel_foreach_cell([&] (Vertex v)
-//	{
-//		VEC3 avg;
-//		set_zero(avg);
-//		uint32 count = 0;
-//		map.foreach_adjacent_vertex_through_edge(v, [&] (Vertex av)
-//		{
-//			avg += position_tmp[av];
-//			++count;
-//		});
-//		avg /= Scalar(count);
-//		const VEC3& p = position_tmp[v];
-//		position[v] = p + ((avg - p) * mu);
-//	},
-//	mask);
-//}
-
-//template <typename MAP, typename MASK, typename VERTEX_ATTR>
-//void filter_laplacian(
-//	MAP& map,
-//	const MASK& mask,
-//	VERTEX_ATTR& position_in,
-//	VERTEX_ATTR& position_out
-//)
-//{
-//	static_assert(is_orbit_of<VERTEX_ATTR, MAP::Vertex::ORBIT>::value, "position_in & position_out must be a vertex attribute");
-
-//	using VEC3 = InsideTypeOf<VERTEX_ATTR>;
-//	using Scalar = ScalarOf<VEC3>;
-//	using CDart = typename MAP::CDart;
-//	using Vertex = typename MAP::Vertex;
-//	using Edge = typename MAP::Edge;
-
-//	typename MAP::template EdgeAttribute<Scalar> edge_weight = map.template add_attribute<Scalar, Edge::ORBIT>("__edge_weight");
-//	typename MAP::template VertexAttribute<uint32> vertex_index = map.template add_attribute<uint32, Vertex::ORBIT>("__vertex_index");
-//	typename MAP::template VertexAttribute<VEC3> vertex_lapl = map.template add_attribute<VEC3, Vertex::ORBIT>("__vertex_lapl");
-
-//	// compute edge weights
-//	map.parallel_foreach_cell([&] (Edge e)
-//	{
-//		if (!map.is_incident_to_boundary(e))
-//		{
-//			edge_weight[e] = (
-//				std::tan(M_PI_2 - angle(map, CDart(map.phi_1(e.dart)), position_in)) +
-//				std::tan(M_PI_2 - angle(map, CDart(map.phi_1(map.phi2(e.dart))), position_in))
-//			) / 2.0;
-//		}
-//		else
-//		{
-//			cgogn::Dart d = map.boundary_dart(e);
-//			edge_weight[e] = std::tan(M_PI_2 - angle(map, CDart(map.phi_1(map.phi2(d))), position_in));
-//		}
-//	},
-//	mask);
-
-//	// compute vertices laplacian
-//	uint32 nb_vertices = 0;
-//	map.foreach_cell([&] (Vertex v) { vertex_index[v] = nb_vertices++; }, mask);
-//	Eigen::SparseMatrix<Scalar, Eigen::ColMajor> LAPL(nb_vertices, nb_vertices);
-//	std::vector<Eigen::Triplet<Scalar>> LAPLcoeffs;
-//	LAPLcoeffs.reserve(nb_vertices * 10);
-//	map.foreach_cell([&] (Vertex v)
-//	{
-//		uint32 vidx = vertex_index[v];
-//		Scalar wsum = 0;
-//		Scalar a = 1. / (4. * area(map, v, position_in));
-//		map.foreach_incident_edge(v, [&] (Edge e) { wsum += a * edge_weight[e]; });
-//		map.foreach_adjacent_vertex_through_edge(v, [&] (Vertex av)
-//		{
-//			LAPLcoeffs.push_back(Eigen::Triplet<Scalar>(vidx, vertex_index[av], (a * edge_weight[Edge(av.dart)]) / wsum));
-//		});
-//		LAPLcoeffs.push_back(Eigen::Triplet<Scalar>(vidx, vidx, -1.));
-//	},
-//	mask);
-//	LAPL.setFromTriplets(LAPLcoeffs.begin(), LAPLcoeffs.end());
-
-//	Eigen::MatrixXd vpos(nb_vertices, 3);
-//	map.parallel_foreach_cell([&] (Vertex v)
-//	{
-//		const VEC3& pv = position_in[v];
-//		uint32 vidx = vertex_index[v];
-//		vpos(vidx, 0) = pv[0];
-//		vpos(vidx, 1) = pv[1];
-//		vpos(vidx, 2) = pv[2];
-//	},
-//	mask);
-
-//	Eigen::MatrixXd lapl(nb_vertices, 3);
-//	lapl = LAPL * vpos;
-//	map.parallel_foreach_cell([&] (Vertex v)
-//	{
-//		VEC3& vl = vertex_lapl[v];
-//		uint32 vidx = vertex_index[v];
-//		vl[0] = lapl(vidx, 0);
-//		vl[1] = lapl(vidx, 1);
-//		vl[2] = lapl(vidx, 2);
-//	},
-//	mask);
-
-//	// vertices displacement
-//	map.parallel_foreach_cell([&] (Vertex v)
-//	{
-//		position_out[v] = position_in[v] + 0.1 * vertex_lapl[v];
-//	},
-//	mask);
-
-//	map.remove_attribute(edge_weight);
-//	map.remove_attribute(vertex_index);
-//	map.remove_attribute(vertex_lapl);
-//}
+/**
+ * \brief applies nb_iterations iterations of the average filter on the given vertex attribute.
+ * Only the vertices kept by the mesh (view) are moved: pass a CellFilter to mask vertices.
+ * \param[in] convergence the iterations stop when no vertex moved by more than this distance
+ * \returns the number of iterations that were run
+ */
+template <typename VEC, typename MESH>
+uint32
+filter_average(
+	const MESH& m,
+	typename mesh_traits<MESH>::template Attribute<VEC>* attribute,
+	uint32 nb_iterations,
+	typename vector_traits<VEC>::Scalar convergence = 0
+)
+{
+	using Scalar = typename vector_traits<VEC>::Scalar;
+	const internal::VertexNeighborhoods nh = internal::vertex_neighborhoods(m);
+	return internal::filter_iterate(nh, attribute, nb_iterations, 1u, convergence,
+		[&] (uint32, uint32 i, const VEC* in) -> VEC
+	{
+		const uint32 begin = nh.offsets[i];
+		const uint32 end = nh.offsets[i + 1u];
+		if (begin == end)
+			return in[nh.vertex_index[i]];
+		VEC sum;
+		set_zero(sum);
+		for (uint32 k = begin; k < end; ++k)
+			sum += in[nh.neighbors[k]];
+		return sum / Scalar(end - begin);
+	});
+}
+
+/**
+ * \brief applies nb_iterations iterations of Taubin's non-shrinking smoothing on the given vertex positions:
+ * each iteration is a smoothing step of factor lambda followed by an inflating step of factor mu.
+ * Only the vertices kept by the mesh (view) are moved: pass a CellFilter to mask vertices.
+ * \param[in] convergence the iterations stop when no vertex moved by more than this distance during a step
+ * \returns the number of iterations that were run
+ */
+template <typename VEC3, typename MESH>
+uint32
+filter_taubin(
+	const MESH& m,
+	typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position,
+	uint32 nb_iterations,
+	typename vector_traits<VEC3>::Scalar convergence = 0,
+	typename vector_traits<VEC3>::Scalar lambda = 0.6307,
+	typename vector_traits<VEC3>::Scalar mu = -0.6532
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	const internal::VertexNeighborhoods nh = internal::vertex_neighborhoods(m);
+	return internal::filter_iterate(nh, vertex_position, nb_iterations, 2u, convergence,
+		[&] (uint32 step, uint32 i, const VEC3* in) -> VEC3
+	{
+		const uint32 begin = nh.offsets[i];
+		const uint32 end = nh.offsets[i + 1u];
+		const VEC3& p = in[nh.vertex_index[i]];
+		if (begin == end)
+			return p;
+		VEC3 avg;
+		set_zero(avg);
+		for (uint32 k = begin; k < end; ++k)
+			avg += in[nh.neighbors[k]];
+		avg /= Scalar(end - begin);
+		return p + (avg - p) * (step == 0u ? lambda : mu);
+	});
+}
+
+/**
+ * \brief applies nb_iterations iterations of the bilateral filter on the given vertex positions:
+ * each vertex moves along its normal by a weighted average of the heights of its neighbors over its tangent plane.
+ * The weights depend on the distance (sigma_c = mean length of the edges) and on the height (sigma_s = 2.5 times
+ * the mean angle between the normals of adjacent vertices); both are computed once from the input.
+ * The normals are not updated between iterations.
+ * Only the vertices kept by the mesh (view) are moved: pass a CellFilter to mask vertices.
+ * \param[in] convergence the iterations stop when no vertex moved by more than this distance
+ * \returns the number of iterations that were run
+ */
+template <typename VEC3, typename MESH>
+uint32
+filter_bilateral(
+	const MESH& m,
+	typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position,
+	const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_normal,
+	uint32 nb_iterations,
+	typename vector_traits<VEC3>::Scalar convergence = 0
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Sums = std::pair<Scalar, Scalar>;
+
+	const internal::VertexNeighborhoods nh = internal::vertex_neighborhoods(m);
+	if (nh.neighbors.empty())
+		return 0u;
+
+	const Attribute<VEC3>& position = *vertex_position;
+	const Attribute<VEC3>& normal = *vertex_normal;
+	const Sums sums = parallel_transform_reduce(nh.size(), Sums(0, 0),
+		[] (const Sums& a, const Sums& b) -> Sums { return Sums(a.first + b.first, a.second + b.second); },
+		[&] (uint32 i) -> Sums
+		{
+			const uint32 index = nh.vertex_index[i];
+			Sums s(0, 0);
+			for (uint32 k = nh.offsets[i]; k < nh.offsets[i + 1u]; ++k)
+			{
+				s.first += (position[nh.neighbors[k]] - position[index]).norm();
+				s.second += angle(normal[index], normal[nh.neighbors[k]]);
+			}
+			return s;
+		});
+	const Scalar sigma_c = sums.first / Scalar(nh.neighbors.size());
+	const Scalar sigma_s = Scalar(2.5) * sums.second / Scalar(nh.neighbors.size());
+	const Scalar inv_2_sigma_c2 = Scalar(1) / (Scalar(2) * sigma_c * sigma_c);
+	const Scalar inv_2_sigma_s2 = sigma_s > Scalar(0) ? Scalar(1) / (Scalar(2) * sigma_s * sigma_s) : Scalar(0);
+
+	return internal::filter_iterate(nh, vertex_position, nb_iterations, 1u, convergence,
+		[&] (uint32, uint32 i, const VEC3* in) -> VEC3
+	{
+		const uint32 index = nh.vertex_index[i];
+		const VEC3& p = in[index];
+		const VEC3& n = normal[index];
+		Scalar sum = 0, normalizer = 0;
+		for (uint32 k = nh.offsets[i]; k < nh.offsets[i + 1u]; ++k)
+		{
+			const VEC3 edge = in[nh.neighbors[k]] - p;
+			const Scalar t = edge.norm();
+			const Scalar h = n.dot(edge);
+			const Scalar w = std::exp(-(t * t) * inv_2_sigma_c2 - (h * h) * inv_2_sigma_s2);
+			sum += w * h;
+			normalizer += w;
+		}
+		if (normalizer > Scalar(0))
+			return p + (sum / normalizer) * n;
+		return p;
+	});
+}
+
+/**
+ * \brief applies nb_iterations steps of implicit fairing on the given vertex positions:
+ * each step solves (M - time_step L) p' = M p with the Laplacian operator of the mesh.
+ * The operator is built and factorized once, the next steps only refresh its numerical values.
+ * \param[in] time_step the time step of the diffusion (homogeneous to an area)
+ */
+template <typename VEC3, typename MESH>
+void
+filter_laplacian(
+	const MESH& m,
+	typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position,
+	uint32 nb_iterations,
+	typename vector_traits<VEC3>::Scalar time_step,
+	LaplacianWeight weight = COTANGENT_LAPLACIAN
+)
+{
+	using Laplacian = LaplacianOperator<MESH>;
+	using Matrix = typename Laplacian::Matrix;
+
+	if (nb_iterations == 0u)
+		return;
+
+	Laplacian lapl(m, vertex_position, weight);
+	const uint32 system = lapl.add_system(1, time_step);
+	Matrix p, rhs;
+	for (uint32 it = 0u; it < nb_iterations; ++it)
+	{
+		if (it > 0u)
+			lapl.template update<VEC3>(vertex_position);
+		lapl.template get_values<VEC3>(vertex_position, p);
+		rhs = lapl.mass().asDiagonal() * p;
+		if (!lapl.solve(system, rhs, p))
+			return;
+		lapl.template set_values<VEC3>(p, vertex_position);
+	}
+}
 
 } // namespace geometry
 
@@ -0,0 +1,359 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_GEODESIC_H_
+#define CGOGN_GEOMETRY_ALGOS_GEODESIC_H_
+
+#include <cgogn/core/types/mesh_traits.h>
+#include <cgogn/core/functions/attributes.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+#include <cgogn/geometry/types/vector_traits.h>
+#include <cgogn/geometry/algos/laplacian.h>
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * \brief geodesic distances on a surface mesh (or mesh view) by the heat method (Crane et al. 2013).
+ *
+ * The cotangent Laplacian, the mass matrix and the two factorized systems of the method
+ * (heat flow (M - t L) u = u0 and Poisson equation L phi = div X) are computed once by the constructor:
+ * the distance to a set of sources then only costs two back-substitutions and two linear passes over the mesh.
+ * Several source sets are solved in parallel.
+ *
+ * The time step is t = time_factor * h^2, h being the mean edge length. Boundaries get Neumann conditions.
+ * Polygonal faces are triangulated as fans for the gradient and divergence operators.
+ * The topology of the mesh must not change during the lifetime of the object.
+ */
+template <typename MESH>
+class HeatMethod
+{
+public:
+
+	using Laplacian = LaplacianOperator<MESH>;
+	using Scalar = typename Laplacian::Scalar;
+	using Matrix = typename Laplacian::Matrix;
+	using Vertex = typename mesh_traits<MESH>::Vertex;
+
+private:
+
+	using Vec3 = Eigen::Matrix<Scalar, 3, 1>;
+
+	// corner c of a triangle has the rows[c] vertex, edge[c] goes from corner c to corner c+1
+	struct Triangle
+	{
+		std::array<uint32, 3> rows;
+		std::array<Vec3, 3> edge;
+		std::array<Vec3, 3> gradient; // gradient of the hat function of each corner
+		std::array<Scalar, 3> cotan; // cotangent of the angle at each corner
+	};
+
+	Laplacian laplacian_;
+	Scalar time_factor_;
+	Scalar mean_edge_length_;
+	uint32 heat_system_;
+	uint32 poisson_system_;
+
+	std::vector<Triangle> triangles_;
+	// corners (3 * triangle + corner) incident to each row
+	std::vector<uint32> corner_offsets_;
+	std::vector<uint32> corners_;
+
+	template <typename FUNC>
+	static void foreach_index(uint32 n, bool parallel, const FUNC& f)
+	{
+		if (parallel)
+			parallel_for(n, f);
+		else
+			for (uint32 i = 0u; i < n; ++i)
+				f(i);
+	}
+
+	Scalar regularization() const { return Scalar(1e-8) / (mean_edge_length_ * mean_edge_length_); }
+
+	void build_triangles()
+	{
+		const std::vector<uint32>& offsets = laplacian_.face_offsets();
+		const std::vector<uint32>& rows = laplacian_.face_rows();
+		const uint32 nbf = laplacian_.nb_faces();
+
+		std::vector<uint32> triangle_offsets(nbf + 1u);
+		triangle_offsets[0] = 0u;
+		for (uint32 f = 0u; f < nbf; ++f)
+			triangle_offsets[f + 1u] = triangle_offsets[f] + (offsets[f + 1u] - offsets[f] - 2u);
+		triangles_.resize(triangle_offsets[nbf]);
+		parallel_for(nbf, [&] (uint32 f)
+		{
+			const uint32 first = offsets[f];
+			for (uint32 k = first + 1u, t = triangle_offsets[f]; k + 1u < offsets[f + 1u]; ++k, ++t)
+				triangles_[t].rows = {{ rows[first], rows[k], rows[k + 1u] }};
+		});
+
+		const uint32 nbv = laplacian_.nb_vertices();
+		const uint32 nbc = 3u * uint32(triangles_.size());
+		corner_offsets_.assign(nbv + 1u, 0u);
+		for (uint32 i = 0u; i < nbc; ++i)
+			++corner_offsets_[triangles_[i / 3u].rows[i % 3u] + 1u];
+		for (uint32 r = 0u; r < nbv; ++r)
+			corner_offsets_[r + 1u] += corner_offsets_[r];
+		corners_.resize(nbc);
+		std::vector<uint32> pos(corner_offsets_.begin(), corner_offsets_.end() - 1);
+		for (uint32 i = 0u; i < nbc; ++i)
+			corners_[pos[triangles_[i / 3u].rows[i % 3u]]++] = i;
+	}
+
+	template <typename VEC3>
+	void compute_geometry(const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position)
+	{
+		auto position = [&] (uint32 row) -> Vec3
+		{
+			const VEC3& p = (*vertex_position)[laplacian_.vertex_index(row)];
+			return Vec3(Scalar(p[0]), Scalar(p[1]), Scalar(p[2]));
+		};
+
+		const uint32 nbt = uint32(triangles_.size());
+		parallel_for(nbt, [&] (uint32 t)
+		{
+			Triangle& tri = triangles_[t];
+			const Vec3 p[3] = { position(tri.rows[0]), position(tri.rows[1]), position(tri.rows[2]) };
+			for (uint32 c = 0u; c < 3u; ++c)
+				tri.edge[c] = p[(c + 1u) % 3u] - p[c];
+			const Vec3 n = tri.edge[0].cross(-tri.edge[2]);
+			const Scalar double_area = n.norm();
+			for (uint32 c = 0u; c < 3u; ++c)
+			{
+				const Vec3& a = tri.edge[c];
+				const Vec3 b = -tri.edge[(c + 2u) % 3u];
+				tri.cotan[c] = a.dot(b) / std::max(double_area, std::numeric_limits<Scalar>::min());
+				// the gradient of the hat function of c is orthogonal to the opposite edge
+				if (double_area > Scalar(0))
+					tri.gradient[c] = (n / double_area).cross(tri.edge[(c + 1u) % 3u]) / double_area;
+				else
+					tri.gradient[c].setZero();
+			}
+		});
+
+		const Scalar sum = parallel_transform_reduce(nbt, Scalar(0),
+			[] (Scalar a, Scalar b) -> Scalar { return a + b; },
+			[&] (uint32 t) -> Scalar
+			{
+				const Triangle& tri = triangles_[t];
+				return tri.edge[0].norm() + tri.edge[1].norm() + tri.edge[2].norm();
+			});
+		mean_edge_length_ = nbt > 0u ? sum / Scalar(3u * nbt) : Scalar(1);
+		if (!(mean_edge_length_ > Scalar(0)))
+			mean_edge_length_ = Scalar(1);
+	}
+
+	/**
+	 * solves the distance to the given source rows into distance (one value per row);
+	 * the passes over the mesh are parallel only if requested (i.e. when a single source set is solved)
+	 */
+	bool solve(const std::vector<uint32>& source_rows, Scalar* distance, bool parallel) const
+	{
+		const uint32 nbv = laplacian_.nb_vertices();
+		const uint32 nbt = uint32(triangles_.size());
+
+		// heat flow from the sources
+		Matrix u0 = Matrix::Zero(nbv, 1);
+		for (uint32 r : source_rows)
+			u0(r, 0) = Scalar(1);
+		Matrix u;
+		if (!laplacian_.solve(heat_system_, u0, u))
+			return false;
+
+		// normalized gradient field pointing away from the sources
+		std::vector<Vec3> field(nbt);
+		foreach_index(nbt, parallel, [&] (uint32 t)
+		{
+			const Triangle& tri = triangles_[t];
+			const Vec3 g = u(tri.rows[0], 0) * tri.gradient[0] + u(tri.rows[1], 0) * tri.gradient[1] + u(tri.rows[2], 0) * tri.gradient[2];
+			const Scalar n = g.norm();
+			if (n > Scalar(0))
+				field[t] = -g / n;
+			else
+				field[t].setZero();
+		});
+
+		// integrated divergence: the Poisson system is (eps M - L) phi = -div X
+		Matrix b(nbv, 1);
+		foreach_index(nbv, parallel, [&] (uint32 r)
+		{
+			Scalar div = 0;
+			for (uint32 i = corner_offsets_[r]; i < corner_offsets_[r + 1u]; ++i)
+			{
+				const uint32 t = corners_[i] / 3u;
+				const uint32 c = corners_[i] % 3u;
+				const uint32 c1 = (c + 1u) % 3u;
+				const uint32 c2 = (c + 2u) % 3u;
+				const Triangle& tri = triangles_[t];
+				div += tri.cotan[c2] * tri.edge[c].dot(field[t]) - tri.cotan[c1] * tri.edge[c2].dot(field[t]);
+			}
+			b(r, 0) = -Scalar(0.5) * div;
+		});
+
+		Matrix phi;
+		if (!laplacian_.solve(poisson_system_, b, phi))
+			return false;
+
+		// the distance is defined up to a constant: the closest vertex is at distance 0
+		const Scalar min = nbv > 0u ? phi.minCoeff() : Scalar(0);
+		foreach_index(nbv, parallel, [&] (uint32 r) { distance[r] = phi(r, 0) - min; });
+		return true;
+	}
+
+	std::vector<uint32> source_rows(const std::vector<Vertex>& sources) const
+	{
+		std::vector<uint32> rows;
+		rows.reserve(sources.size());
+		for (Vertex v : sources)
+			rows.push_back(laplacian_.row(v));
+		return rows;
+	}
+
+public:
+
+	/**
+	 * \brief builds and factorizes the operators of the heat method from the given vertex positions
+	 * \param[in] time_factor the time step of the heat flow relative to the squared mean edge length
+	 */
+	template <typename VEC3>
+	HeatMethod(
+		const MESH& m,
+		const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position,
+		Scalar time_factor = 1
+	) :
+		laplacian_(m, vertex_position, COTANGENT_LAPLACIAN),
+		time_factor_(time_factor),
+		mean_edge_length_(1)
+	{
+		build_triangles();
+		compute_geometry<VEC3>(vertex_position);
+		heat_system_ = laplacian_.add_system(1, time_step());
+		poisson_system_ = laplacian_.add_system(regularization(), 1);
+	}
+
+	HeatMethod(const HeatMethod&) = delete;
+	HeatMethod& operator=(const HeatMethod&) = delete;
+
+	const Laplacian& laplacian() const { return laplacian_; }
+	Scalar mean_edge_length() const { return mean_edge_length_; }
+	Scalar time_step() const { return time_factor_ * mean_edge_length_ * mean_edge_length_; }
+
+	/**
+	 * \brief refreshes the operators and their factorizations after a change of the vertex positions
+	 */
+	template <typename VEC3>
+	void update(const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position)
+	{
+		laplacian_.template update<VEC3>(vertex_position);
+		const Scalar h = mean_edge_length_;
+		compute_geometry<VEC3>(vertex_position);
+		if (mean_edge_length_ != h)
+		{
+			laplacian_.update_system(heat_system_, 1, time_step());
+			laplacian_.update_system(poisson_system_, regularization(), 1);
+		}
+	}
+
+	/**
+	 * \brief computes the geodesic distance to the given source vertices
+	 * \param[out] distance the distance of each vertex, indexed by the rows of laplacian()
+	 */
+	bool compute_distance(const std::vector<Vertex>& sources, std::vector<Scalar>& distance) const
+	{
+		distance.resize(laplacian_.nb_vertices());
+		return solve(source_rows(sources), distance.data(), true);
+	}
+
+	/**
+	 * \brief computes the geodesic distance to the given source vertices into a vertex attribute
+	 */
+	template <typename T>
+	bool compute_distance(
+		const std::vector<Vertex>& sources,
+		typename mesh_traits<MESH>::template Attribute<T>* vertex_distance
+	) const
+	{
+		std::vector<Scalar> distance;
+		if (!compute_distance(sources, distance))
+			return false;
+		parallel_for(laplacian_.nb_vertices(), [&] (uint32 r)
+		{
+			(*vertex_distance)[laplacian_.vertex_index(r)] = T(distance[r]);
+		});
+		vertex_distance->notify_modification();
+		return true;
+	}
+
+	/**
+	 * \brief computes (in parallel) the geodesic distance to each of the given source sets
+	 * \param[out] distances one column per source set, indexed by the rows of laplacian()
+	 */
+	bool compute_distances(const std::vector<std::vector<Vertex>>& source_sets, Matrix& distances) const
+	{
+		const uint32 nbs = uint32(source_sets.size());
+		distances.resize(laplacian_.nb_vertices(), nbs);
+		if (nbs == 1u)
+			return solve(source_rows(source_sets[0]), distances.col(0).data(), true);
+
+		std::vector<uint8> success(nbs);
+		parallel_for(nbs, [&] (uint32 s)
+		{
+			success[s] = solve(source_rows(source_sets[s]), distances.col(s).data(), false);
+		}, 1u);
+		return std::all_of(success.begin(), success.end(), [] (uint8 b) { return b != 0u; });
+	}
+};
+
+/**
+ * \brief computes the geodesic distance of the vertices to the given source vertices by the heat method.
+ * To compute distances to several sources on the same mesh, use a HeatMethod object directly.
+ */
+template <typename VEC3, typename MESH>
+bool compute_geodesic_distance(
+	const MESH& m,
+	const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position,
+	const std::vector<typename mesh_traits<MESH>::Vertex>& sources,
+	typename mesh_traits<MESH>::template Attribute<typename vector_traits<VEC3>::Scalar>* vertex_distance
+)
+{
+	HeatMethod<MESH> heat(m, vertex_position);
+	return heat.template compute_distance<typename vector_traits<VEC3>::Scalar>(sources, vertex_distance);
+}
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_GEODESIC_H_
@@ -0,0 +1,494 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_LAPLACIAN_H_
+#define CGOGN_GEOMETRY_ALGOS_LAPLACIAN_H_
+
+#include <cgogn/core/types/mesh_traits.h>
+#include <cgogn/core/functions/traversals/global.h>
+#include <cgogn/core/functions/traversals/vertex.h>
+#include <cgogn/core/functions/attributes.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+#include <cgogn/geometry/types/vector_traits.h>
+#include <cgogn/geometry/functions/vector_ops.h>
+
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * \brief weights of the edges of a LaplacianOperator
+ *  - UNIFORM_LAPLACIAN: every edge has a unit weight (graph Laplacian)
+ *  - COTANGENT_LAPLACIAN: (cot(alpha) + cot(beta)) / 2, alpha and beta being the angles opposite to the edge
+ */
+enum LaplacianWeight : uint8
+{
+	UNIFORM_LAPLACIAN = 0,
+	COTANGENT_LAPLACIAN
+};
+
+/**
+ * \brief discrete Laplace-Beltrami operator of a surface mesh (or mesh view) with a lumped mass matrix.
+ *
+ * The sparsity pattern of the matrix and all the topological information needed to fill it are computed once
+ * by the constructor. update() then only refreshes the numerical values (in parallel) from the vertex positions,
+ * without traversing the mesh.
+ *
+ * The Laplacian matrix L has L_ij = w_ij for adjacent vertices and L_ii = -sum_j w_ij (negative semi-definite).
+ * The mass matrix M is diagonal: a vertex gets an equal share of the area of each of its incident faces.
+ *
+ * Systems (a M - b L) x = rhs are factorized by add_system (sparse LDLT). The symbolic analysis of a system is done
+ * only once and update() refreshes the numeric factorization of all the systems:
+ * repeated solves on the same mesh (implicit fairing, parameterization, geodesics) only pay the triangular solves.
+ *
+ * The cotangent weights are exact for triangles; for the other polygons, the angle opposite to an edge is taken
+ * at the vertex that follows the edge. The topology of the mesh must not change during the lifetime of the operator.
+ */
+template <typename MESH>
+class LaplacianOperator
+{
+public:
+
+	using Scalar = float64;
+	using SparseMatrix = Eigen::SparseMatrix<Scalar, Eigen::ColMajor, int32>;
+	using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+	using Matrix = Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+	using Vertex = typename mesh_traits<MESH>::Vertex;
+	using Face = typename mesh_traits<MESH>::Face;
+
+private:
+
+	struct System
+	{
+		Scalar mass_coefficient_;
+		Scalar stiffness_coefficient_;
+		SparseMatrix matrix_;
+		Eigen::SimplicialLDLT<SparseMatrix> solver_;
+	};
+
+	const MESH& m_;
+	LaplacianWeight weight_;
+
+	std::vector<Vertex> vertices_;
+	std::vector<uint32> vertex_index_; // attribute index of the vertices
+	std::vector<uint32> row_; // row of the vertices indexed by their attribute index
+
+	// faces as lists of rows
+	std::vector<uint32> face_offsets_;
+	std::vector<uint32> face_rows_;
+	std::vector<Scalar> face_area_;
+
+	// corners of the faces incident to each row (indices in face_rows_) and face of each corner
+	std::vector<uint32> corner_offsets_;
+	std::vector<uint32> corners_;
+	std::vector<uint32> corner_face_;
+
+	// for each off-diagonal entry of the matrix (index in its value array), the corners whose weight it sums:
+	// corner k of a face stands for the half-edge going from its vertex to the next one
+	std::vector<uint32> entry_offsets_;
+	std::vector<uint32> entry_corners_;
+	std::vector<uint32> diagonal_; // index of the diagonal entry of each column
+	std::vector<Scalar> corner_weight_;
+
+	SparseMatrix laplacian_;
+	Vector mass_;
+
+	std::vector<std::unique_ptr<System>> systems_;
+
+	uint32 face_size(uint32 f) const { return face_offsets_[f + 1u] - face_offsets_[f]; }
+
+	void build_topology();
+	template <typename VEC3>
+	void compute_weights(const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position);
+	void fill_system(System& s) const;
+
+public:
+
+	/**
+	 * \brief builds the sparsity pattern of the operator and computes its values from the given vertex positions
+	 */
+	template <typename VEC3>
+	LaplacianOperator(
+		const MESH& m,
+		const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position,
+		LaplacianWeight weight = COTANGENT_LAPLACIAN
+	) :
+		m_(m),
+		weight_(weight)
+	{
+		build_topology();
+		update<VEC3>(vertex_position);
+	}
+
+	LaplacianOperator(const LaplacianOperator&) = delete;
+	LaplacianOperator& operator=(const LaplacianOperator&) = delete;
+
+	LaplacianWeight weight() const { return weight_; }
+	uint32 nb_vertices() const { return uint32(vertices_.size()); }
+
+	/**
+	 * \brief vertex associated to the given row of the matrices
+	 */
+	Vertex vertex(uint32 row) const { return vertices_[row]; }
+
+	/**
+	 * \brief row of the matrices associated to the given vertex
+	 */
+	uint32 row(Vertex v) const { return row_[index_of(m_, v)]; }
+
+	/**
+	 * \brief attribute index of the vertex associated to the given row
+	 */
+	uint32 vertex_index(uint32 row) const { return vertex_index_[row]; }
+
+	/**
+	 * \brief faces of the mesh as lists of rows: the rows of face f are face_rows()[face_offsets()[f] .. face_offsets()[f+1]]
+	 */
+	uint32 nb_faces() const { return uint32(face_area_.size()); }
+	const std::vector<uint32>& face_offsets() const { return face_offsets_; }
+	const std::vector<uint32>& face_rows() const { return face_rows_; }
+
+	const SparseMatrix& laplacian() const { return laplacian_; }
+	const Vector& mass() const { return mass_; }
+
+	/**
+	 * \brief refreshes the numerical values of the matrices and of the factorizations of the systems
+	 * from the given vertex positions: the sparsity pattern and the symbolic factorizations are reused
+	 */
+	template <typename VEC3>
+	void update(const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position)
+	{
+		compute_weights<VEC3>(vertex_position);
+		for (std::unique_ptr<System>& s : systems_)
+		{
+			fill_system(*s);
+			s->solver_.factorize(s->matrix_);
+		}
+	}
+
+	/**
+	 * \brief factorizes the system (mass_coefficient M - stiffness_coefficient L) and returns its identifier.
+	 * A small positive mass_coefficient regularizes the (singular) Laplacian of a closed mesh.
+	 */
+	uint32 add_system(Scalar mass_coefficient, Scalar stiffness_coefficient)
+	{
+		std::unique_ptr<System> s(new System());
+		s->mass_coefficient_ = mass_coefficient;
+		s->stiffness_coefficient_ = stiffness_coefficient;
+		s->matrix_ = laplacian_;
+		fill_system(*s);
+		s->solver_.analyzePattern(s->matrix_);
+		s->solver_.factorize(s->matrix_);
+		systems_.push_back(std::move(s));
+		return uint32(systems_.size() - 1u);
+	}
+
+	/**
+	 * \brief changes the coefficients of the given system and refreshes its numeric factorization
+	 */
+	void update_system(uint32 system, Scalar mass_coefficient, Scalar stiffness_coefficient)
+	{
+		cgogn_message_assert(system < systems_.size(), "LaplacianOperator: unknown system");
+		System& s = *systems_[system];
+		s.mass_coefficient_ = mass_coefficient;
+		s.stiffness_coefficient_ = stiffness_coefficient;
+		fill_system(s);
+		s.solver_.factorize(s.matrix_);
+	}
+
+	/**
+	 * \brief solves the given system for each column of rhs
+	 * \returns false if the factorization of the system failed
+	 */
+	bool solve(uint32 system, const Matrix& rhs, Matrix& x) const
+	{
+		cgogn_message_assert(system < systems_.size(), "LaplacianOperator: unknown system");
+		const System& s = *systems_[system];
+		if (s.solver_.info() != Eigen::Success)
+			return false;
+		x = s.solver_.solve(rhs);
+		return s.solver_.info() == Eigen::Success;
+	}
+
+	/**
+	 * \brief copies the values of the given vertex attribute into the rows of x (one column per coordinate)
+	 */
+	template <typename VEC>
+	void get_values(const typename mesh_traits<MESH>::template Attribute<VEC>* attribute, Matrix& x) const
+	{
+		const uint32 dim = uint32(vector_traits<VEC>::SIZE);
+		x.resize(nb_vertices(), dim);
+		parallel_for(nb_vertices(), [&] (uint32 r)
+		{
+			const VEC& v = (*attribute)[vertex_index_[r]];
+			for (uint32 c = 0u; c < dim; ++c)
+				x(r, c) = Scalar(v[c]);
+		});
+	}
+
+	/**
+	 * \brief copies the rows of x into the given vertex attribute
+	 */
+	template <typename VEC>
+	void set_values(const Matrix& x, typename mesh_traits<MESH>::template Attribute<VEC>* attribute) const
+	{
+		using VScalar = typename vector_traits<VEC>::Scalar;
+		const uint32 dim = uint32(vector_traits<VEC>::SIZE);
+		parallel_for(nb_vertices(), [&] (uint32 r)
+		{
+			VEC& v = (*attribute)[vertex_index_[r]];
+			for (uint32 c = 0u; c < dim; ++c)
+				v[c] = VScalar(x(r, c));
+		});
+		attribute->notify_modification();
+	}
+};
+
+template <typename MESH>
+void LaplacianOperator<MESH>::build_topology()
+{
+	// markers are not thread-safe: cells are gathered sequentially and then processed in parallel
+	foreach_cell(m_, [&] (Vertex v) -> bool { vertices_.push_back(v); return true; });
+	std::vector<Face> faces;
+	foreach_cell(m_, [&] (Face f) -> bool { faces.push_back(f); return true; });
+
+	const uint32 nbv = nb_vertices();
+	const uint32 nbf = uint32(faces.size());
+
+	vertex_index_.resize(nbv);
+	parallel_for(nbv, [&] (uint32 r) { vertex_index_[r] = index_of(m_, vertices_[r]); });
+	const uint32 max_index = nbv > 0u ? *std::max_element(vertex_index_.begin(), vertex_index_.end()) : 0u;
+	row_.assign(max_index + 1u, INVALID_INDEX);
+	for (uint32 r = 0u; r < nbv; ++r)
+		row_[vertex_index_[r]] = r;
+
+	// faces
+	face_offsets_.resize(nbf + 1u);
+	face_offsets_[0] = 0u;
+	parallel_for(nbf, [&] (uint32 f)
+	{
+		uint32 count = 0u;
+		foreach_incident_vertex(m_, faces[f], [&] (Vertex) -> bool { ++count; return true; });
+		face_offsets_[f + 1u] = count;
+	});
+	for (uint32 f = 0u; f < nbf; ++f)
+		face_offsets_[f + 1u] += face_offsets_[f];
+	face_rows_.resize(face_offsets_[nbf]);
+	parallel_for(nbf, [&] (uint32 f)
+	{
+		uint32 k = face_offsets_[f];
+		foreach_incident_vertex(m_, faces[f], [&] (Vertex v) -> bool
+		{
+			const uint32 index = index_of(m_, v);
+			cgogn_message_assert(index <= max_index && row_[index] != INVALID_INDEX, "LaplacianOperator: face vertex is not a vertex of the mesh");
+			face_rows_[k++] = row_[index];
+			return true;
+		});
+	});
+	face_area_.resize(nbf);
+
+	const uint32 nbc = uint32(face_rows_.size());
+	corner_face_.resize(nbc);
+	parallel_for(nbf, [&] (uint32 f)
+	{
+		for (uint32 k = face_offsets_[f]; k < face_offsets_[f + 1u]; ++k)
+			corner_face_[k] = f;
+	});
+
+	// corners incident to each row (counting sort)
+	corner_offsets_.assign(nbv + 1u, 0u);
+	for (uint32 k = 0u; k < nbc; ++k)
+		++corner_offsets_[face_rows_[k] + 1u];
+	for (uint32 r = 0u; r < nbv; ++r)
+		corner_offsets_[r + 1u] += corner_offsets_[r];
+	corners_.resize(nbc);
+	{
+		std::vector<uint32> pos(corner_offsets_.begin(), corner_offsets_.end() - 1);
+		for (uint32 k = 0u; k < nbc; ++k)
+			corners_[pos[face_rows_[k]]++] = k;
+	}
+
+	auto next = [&] (uint32 k) -> uint32 { return k + 1u < face_offsets_[corner_face_[k] + 1u] ? k + 1u : face_offsets_[corner_face_[k]]; };
+	auto prev = [&] (uint32 k) -> uint32 { return k > face_offsets_[corner_face_[k]] ? k - 1u : face_offsets_[corner_face_[k] + 1u] - 1u; };
+
+	// sparsity pattern: the neighbors of a row are the next and previous vertices of its corners
+	std::vector<int32> outer(nbv + 1u);
+	outer[0] = 0;
+	std::vector<std::vector<int32>> columns(nbv);
+	parallel_for(nbv, [&] (uint32 r)
+	{
+		std::vector<int32>& col = columns[r];
+		col.reserve(2u * (corner_offsets_[r + 1u] - corner_offsets_[r]) + 1u);
+		col.push_back(int32(r));
+		for (uint32 i = corner_offsets_[r]; i < corner_offsets_[r + 1u]; ++i)
+		{
+			col.push_back(int32(face_rows_[next(corners_[i])]));
+			col.push_back(int32(face_rows_[prev(corners_[i])]));
+		}
+		std::sort(col.begin(), col.end());
+		col.erase(std::unique(col.begin(), col.end()), col.end());
+	});
+	for (uint32 r = 0u; r < nbv; ++r)
+		outer[r + 1u] = outer[r] + int32(columns[r].size());
+
+	laplacian_.resize(nbv, nbv);
+	laplacian_.resizeNonZeros(outer[nbv]);
+	std::copy(outer.begin(), outer.end(), laplacian_.outerIndexPtr());
+	int32* inner = laplacian_.innerIndexPtr();
+	parallel_for(nbv, [&] (uint32 r) { std::copy(columns[r].begin(), columns[r].end(), inner + outer[r]); });
+	std::fill(laplacian_.valuePtr(), laplacian_.valuePtr() + outer[nbv], Scalar(0));
+	columns.clear();
+	columns.shrink_to_fit();
+
+	auto entry = [&] (uint32 row, uint32 col) -> uint32
+	{
+		const int32* b = inner + outer[col];
+		const int32* e = inner + outer[col + 1u];
+		return uint32(std::lower_bound(b, e, int32(row)) - inner);
+	};
+
+	diagonal_.resize(nbv);
+	parallel_for(nbv, [&] (uint32 r) { diagonal_[r] = entry(r, r); });
+
+	// each corner (half-edge a -> b) contributes to the entries (a, b) and (b, a): counting sort of the contributions
+	const uint32 nnz = uint32(outer[nbv]);
+	std::vector<uint32> corner_entry(2u * nbc);
+	parallel_for(nbc, [&] (uint32 k)
+	{
+		const uint32 a = face_rows_[k];
+		const uint32 b = face_rows_[next(k)];
+		corner_entry[2u * k] = entry(a, b);
+		corner_entry[2u * k + 1u] = entry(b, a);
+	});
+	entry_offsets_.assign(nnz + 1u, 0u);
+	for (uint32 i = 0u; i < 2u * nbc; ++i)
+		++entry_offsets_[corner_entry[i] + 1u];
+	for (uint32 i = 0u; i < nnz; ++i)
+		entry_offsets_[i + 1u] += entry_offsets_[i];
+	entry_corners_.resize(2u * nbc);
+	{
+		std::vector<uint32> pos(entry_offsets_.begin(), entry_offsets_.end() - 1);
+		for (uint32 i = 0u; i < 2u * nbc; ++i)
+			entry_corners_[pos[corner_entry[i]]++] = i / 2u;
+	}
+
+	corner_weight_.resize(nbc);
+	mass_.resize(nbv);
+}
+
+template <typename MESH>
+template <typename VEC3>
+void LaplacianOperator<MESH>::compute_weights(const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position)
+{
+	const uint32 nbv = nb_vertices();
+	const uint32 nbf = uint32(face_area_.size());
+	auto position = [&] (uint32 k) -> const VEC3& { return (*vertex_position)[vertex_index_[face_rows_[k]]]; };
+
+	// areas of the faces (Newell's method) and weights of the half-edges
+	parallel_for(nbf, [&] (uint32 f)
+	{
+		const uint32 begin = face_offsets_[f];
+		const uint32 end = face_offsets_[f + 1u];
+		VEC3 n;
+		set_zero(n);
+		for (uint32 k = begin; k < end; ++k)
+			n += cross(position(k), position(k + 1u < end ? k + 1u : begin));
+		face_area_[f] = Scalar(0.5) * Scalar(n.norm());
+
+		for (uint32 k = begin; k < end; ++k)
+		{
+			if (weight_ == UNIFORM_LAPLACIAN)
+			{
+				corner_weight_[k] = Scalar(1);
+				continue;
+			}
+			// angle opposite to the half-edge (a, b), at the vertex c following b
+			const uint32 kb = k + 1u < end ? k + 1u : begin;
+			const uint32 kc = kb + 1u < end ? kb + 1u : begin;
+			const VEC3 ca = position(k) - position(kc);
+			const VEC3 cb = position(kb) - position(kc);
+			const Scalar sin_c = Scalar(cross(ca, cb).norm());
+			const Scalar cos_c = Scalar(ca.dot(cb));
+			corner_weight_[k] = Scalar(0.5) * cos_c / std::max(sin_c, std::numeric_limits<Scalar>::min());
+		}
+	});
+
+	// off-diagonal entries sum the weights of their half-edges, diagonal entries compensate
+	Scalar* values = laplacian_.valuePtr();
+	const int32* outer = laplacian_.outerIndexPtr();
+	parallel_for(nbv, [&] (uint32 c)
+	{
+		Scalar sum = 0;
+		for (int32 i = outer[c]; i < outer[c + 1u]; ++i)
+		{
+			if (uint32(i) == diagonal_[c])
+				continue;
+			Scalar w = 0;
+			if (weight_ == UNIFORM_LAPLACIAN)
+				w = Scalar(1);
+			else
+				for (uint32 j = entry_offsets_[i]; j < entry_offsets_[i + 1]; ++j)
+					w += corner_weight_[entry_corners_[j]];
+			values[i] = w;
+			sum += w;
+		}
+		values[diagonal_[c]] = -sum;
+
+		Scalar mass = 0;
+		for (uint32 j = corner_offsets_[c]; j < corner_offsets_[c + 1u]; ++j)
+		{
+			const uint32 f = corner_face_[corners_[j]];
+			mass += face_area_[f] / Scalar(face_size(f));
+		}
+		mass_[c] = mass;
+	});
+}
+
+template <typename MESH>
+void LaplacianOperator<MESH>::fill_system(System& s) const
+{
+	const Scalar* l = laplacian_.valuePtr();
+	Scalar* a = s.matrix_.valuePtr();
+	const uint32 nnz = uint32(laplacian_.nonZeros());
+	parallel_for(nnz, [&] (uint32 i) { a[i] = -s.stiffness_coefficient_ * l[i]; });
+	parallel_for(nb_vertices(), [&] (uint32 r) { a[diagonal_[r]] += s.mass_coefficient_ * mass_[r]; });
+}
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_LAPLACIAN_H_
@@ -33,6 +33,14 @@
 #include <cgogn/geometry/types/vector_traits.h>
 #include <cgogn/geometry/functions/vector_ops.h>
 #include <cgogn/geometry/functions/normal.h>
+#include <cgogn/geometry/functions/triangle_batch.h>
+#include <cgogn/geometry/types/kd_tree.h>
+
+#include <Eigen/Eigenvalues>
+
+#include <vector>
+#include <queue>
+#include <algorithm>
 
 namespace cgogn
 {
@@ -40,9 +48,37 @@ namespace cgogn
 namespace geometry
 {
 
+/**
+ * \brief type of weights used to accumulate the normals of the faces incident to a vertex
+ *  - UNIFORM_WEIGHT: unit normals of the faces
+ *  - AREA_WEIGHT: normals of the faces weighted by their area
+ *  - ANGLE_WEIGHT: normals of the faces weighted by the angle of the face at the vertex
+ */
+enum NormalWeight : uint8
+{
+	UNIFORM_WEIGHT = 0,
+	AREA_WEIGHT,
+	ANGLE_WEIGHT
+};
+
+/**
+ * \brief way the normals of the faces are accumulated into the normals of the vertices
+ *  - GATHER: each vertex sums the normals of its incident faces (parallel, race-free)
+ *  - SCATTER: each face adds its normal to its incident vertices (sequential, one pass over the faces)
+ */
+enum NormalAccumulation : uint8
+{
+	GATHER = 0,
+	SCATTER
+};
+
+/**
+ * \brief computes the vector area of the face f: its direction is the normal of the face
+ * and its norm is twice the area of the face (Newell's method for polygons)
+ */
 template <typename VEC3, typename MESH>
 VEC3
-normal(
+vector_area(
 	const MESH& m,
 	typename mesh_traits<MESH>::Face f,
 	const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position
@@ -50,31 +86,112 @@ normal(
 {
 	using Scalar = typename vector_traits<VEC3>::Scalar;
 	using Vertex = typename mesh_traits<MESH>::Vertex;
-	std::vector<Vertex> vertices = incident_vertices(m, f);
-	if (vertices.size() == 3)
+	VEC3 n{Scalar(0), Scalar(0), Scalar(0)};
+	const VEC3* p[3] = { nullptr, nullptr, nullptr };
+	const VEC3* prev = nullptr;
+	uint32 count = 0;
+	auto newell = [&] (const VEC3& a, const VEC3& b)
 	{
-		VEC3 n = normal(
-			value<VEC3>(m, vertex_position, vertices[0]),
-			value<VEC3>(m, vertex_position, vertices[1]),
-			value<VEC3>(m, vertex_position, vertices[2])
-		);
-		normalize(n);
-		return n;
-	}
-	else
+		n[0] += (a[1] - b[1]) * (a[2] + b[2]);
+		n[1] += (a[2] - b[2]) * (a[0] + b[0]);
+		n[2] += (a[0] - b[0]) * (a[1] + b[1]);
+	};
+	// Newell's sums are only computed when the face is not a triangle
+	foreach_incident_vertex(m, f, [&] (Vertex v) -> bool
 	{
-		VEC3 n{Scalar(0), Scalar(0), Scalar(0)};
-		for (uint32 i = 0; i < vertices.size() - 1; ++i)
+		const VEC3& q = value<VEC3>(m, vertex_position, v);
+		if (count < 3)
+			p[count] = &q;
+		else
 		{
-			const VEC3& p = value<VEC3>(m, vertex_position, vertices[i]);
-			const VEC3& q = value<VEC3>(m, vertex_position, vertices[i+1]);
-			n[0] += (p[1] - q[1]) * (p[2] + q[2]);
-			n[1] += (p[2] - q[2]) * (p[0] + q[0]);
-			n[2] += (p[0] - q[0]) * (p[1] + q[1]);
+			if (count == 3)
+			{
+				newell(*p[0], *p[1]);
+				newell(*p[1], *p[2]);
+			}
+			newell(*prev, q);
 		}
-		normalize(n);
-		return n;
-	}
+		prev = &q;
+		++count;
+		return true;
+	});
+	if (count == 3)
+		return normal(*p[0], *p[1], *p[2]);
+	if (count > 3)
+		newell(*prev, *p[0]);
+	return n;
+}
+
+template <typename VEC3, typename MESH>
+VEC3
+normal(
+	const MESH& m,
+	typename mesh_traits<MESH>::Face f,
+	const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position
+)
+{
+	VEC3 n = vector_area<VEC3>(m, f, vertex_position);
+	normalize(n);
+	return n;
+}
+
+template <typename VEC3, typename MESH>
+typename vector_traits<VEC3>::Scalar
+area(
+	const MESH& m,
+	typename mesh_traits<MESH>::Face f,
+	const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	return Scalar(0.5) * vector_area<VEC3>(m, f, vertex_position).norm();
+}
+
+/**
+ * \brief computes the angle of the face f at its vertex v
+ */
+template <typename VEC3, typename MESH>
+typename vector_traits<VEC3>::Scalar
+corner_angle(
+	const MESH& m,
+	typename mesh_traits<MESH>::Face f,
+	typename mesh_traits<MESH>::Vertex v,
+	const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position
+)
+{
+	using Vertex = typename mesh_traits<MESH>::Vertex;
+	const uint32 vi = index_of(m, v);
+	const VEC3* first = nullptr;
+	const VEC3* prev = nullptr;
+	const VEC3* before = nullptr;
+	const VEC3* after = nullptr;
+	bool found = false;
+	foreach_incident_vertex(m, f, [&] (Vertex u) -> bool
+	{
+		const VEC3& q = value<VEC3>(m, vertex_position, u);
+		if (found && !after)
+			after = &q;
+		if (after)
+		{
+			prev = &q;
+			return before == nullptr; // if v is the first vertex, its predecessor is the last one
+		}
+		if (!first)
+			first = &q;
+		if (index_of(m, u) == vi)
+		{
+			before = prev;
+			found = true;
+		}
+		prev = &q;
+		return true;
+	});
+	if (!before)
+		before = prev;
+	if (!after)
+		after = first;
+	const VEC3& p = value<VEC3>(m, vertex_position, v);
+	return angle(VEC3(*before - p), VEC3(*after - p));
 }
 
 template <typename VEC3, typename MESH>
@@ -88,7 +205,6 @@ normal(
 	using Scalar = typename vector_traits<VEC3>::Scalar;
 	using Face = typename mesh_traits<MESH>::Face;
 	VEC3 n{Scalar{0}, Scalar{0}, Scalar{0}};
-	const VEC3& p = value<VEC3>(m, vertex_position, v);
 	foreach_incident_face(m, v, [&] (Face f) -> bool
 	{
 		n += normal<VEC3>(m, f, vertex_position);
@@ -107,11 +223,347 @@ compute_normal(
 )
 {
 	using Vertex = typename mesh_traits<MESH>::Vertex;
-	foreach_cell(m, [&] (Vertex v) -> bool
+	parallel_foreach_cell(m, [&] (Vertex v) -> bool
 	{
 		value<VEC3>(m, vertex_normal, v) = normal<VEC3>(m, v, vertex_position);
 		return true;
 	});
+	vertex_normal->notify_modification();
+}
+
+/**
+ * \brief computes the unit normals (and optionally the areas) of the faces of the mesh in parallel.
+ * The triangles are processed by batches of TRIANGLE_BATCH_SIZE (see compute_triangle_batch)
+ */
+template <typename VEC3, typename MESH>
+void
+compute_face_normal(
+	const MESH& m,
+	const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position,
+	typename mesh_traits<MESH>::template Attribute<VEC3>* face_normal,
+	typename mesh_traits<MESH>::template Attribute<typename vector_traits<VEC3>::Scalar>* face_area = nullptr
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex = typename mesh_traits<MESH>::Vertex;
+	using Face = typename mesh_traits<MESH>::Face;
+
+	// markers are not thread-safe: faces are gathered sequentially and then processed in parallel
+	std::vector<Face> faces;
+	foreach_cell(m, [&] (Face f) -> bool { faces.push_back(f); return true; });
+
+	// triangles are processed by batches (SIMD), other faces one by one
+	parallel_foreach_chunk(uint32(faces.size()), [&] (uint32, uint32 begin, uint32 end)
+	{
+		TriangleBatch batch;
+		batch.clear();
+		Face batch_faces[TriangleBatch::SIZE];
+
+		auto flush = [&] ()
+		{
+			compute_triangle_batch(batch, false);
+			for (uint32 i = 0u; i < batch.size; ++i)
+			{
+				value<VEC3>(m, face_normal, batch_faces[i]) =
+					VEC3{Scalar(batch.normal[0][i]), Scalar(batch.normal[1][i]), Scalar(batch.normal[2][i])};
+				if (face_area)
+					value<Scalar>(m, face_area, batch_faces[i]) = Scalar(batch.area[i]);
+			}
+			batch.clear();
+		};
+
+		for (uint32 i = begin; i < end; ++i)
+		{
+			Face f = faces[i];
+			const VEC3* p[3];
+			uint32 count = 0u;
+			foreach_incident_vertex(m, f, [&] (Vertex v) -> bool
+			{
+				if (count < 3u)
+					p[count] = &value<VEC3>(m, vertex_position, v);
+				return ++count <= 3u;
+			});
+
+			if (count == 3u)
+			{
+				batch_faces[batch.size] = f;
+				batch.add(*p[0], *p[1], *p[2]);
+				if (batch.full())
+					flush();
+			}
+			else
+			{
+				VEC3 n = vector_area<VEC3>(m, f, vertex_position);
+				if (face_area)
+					value<Scalar>(m, face_area, f) = Scalar(0.5) * n.norm();
+				normalize(n);
+				value<VEC3>(m, face_normal, f) = n;
+			}
+		}
+		if (batch.size > 0u)
+			flush();
+	});
+	face_normal->notify_modification();
+	if (face_area)
+		face_area->notify_modification();
+}
+
+/**
+ * \brief computes the normals of the vertices from the normals of the faces computed by compute_face_normal.
+ * The face normals are thus computed only once instead of once per incident vertex.
+ * \param[in] face_area the areas of the faces, only needed for AREA_WEIGHT
+ */
+template <typename VEC3, typename MESH>
+void
+compute_vertex_normal(
+	const MESH& m,
+	const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position,
+	const typename mesh_traits<MESH>::template Attribute<VEC3>* face_normal,
+	const typename mesh_traits<MESH>::template Attribute<typename vector_traits<VEC3>::Scalar>* face_area,
+	typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_normal,
+	NormalWeight weight = UNIFORM_WEIGHT,
+	NormalAccumulation accumulation = GATHER
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex = typename mesh_traits<MESH>::Vertex;
+	using Face = typename mesh_traits<MESH>::Face;
+
+	cgogn_message_assert(weight != AREA_WEIGHT || face_area != nullptr, "compute_vertex_normal: face areas are needed for area weighting");
+
+	auto face_weight = [&] (Face f, Vertex v) -> Scalar
+	{
+		switch (weight)
+		{
+			case AREA_WEIGHT: return value<Scalar>(m, face_area, f);
+			case ANGLE_WEIGHT: return corner_angle<VEC3>(m, f, v, vertex_position);
+			default: return Scalar(1);
+		}
+	};
+
+	if (accumulation == GATHER)
+	{
+		parallel_foreach_cell(m, [&] (Vertex v) -> bool
+		{
+			VEC3 n{Scalar(0), Scalar(0), Scalar(0)};
+			foreach_incident_face(m, v, [&] (Face f) -> bool
+			{
+				n += face_weight(f, v) * value<VEC3>(m, face_normal, f);
+				return true;
+			});
+			normalize(n);
+			value<VEC3>(m, vertex_normal, v) = n;
+			return true;
+		});
+	}
+	else
+	{
+		foreach_cell(m, [&] (Vertex v) -> bool
+		{
+			set_zero(value<VEC3>(m, vertex_normal, v));
+			return true;
+		});
+		foreach_cell(m, [&] (Face f) -> bool
+		{
+			const VEC3& fn = value<VEC3>(m, face_normal, f);
+			if (weight != ANGLE_WEIGHT)
+			{
+				const VEC3 wfn = weight == AREA_WEIGHT ? VEC3(value<Scalar>(m, face_area, f) * fn) : fn;
+				foreach_incident_vertex(m, f, [&] (Vertex v) -> bool
+				{
+					value<VEC3>(m, vertex_normal, v) += wfn;
+					return true;
+				});
+				return true;
+			}
+			// the angle of each corner is computed when its successor is reached
+			// (the first corner being computed at the end with the last one)
+			Vertex v0, v1, prev, curr;
+			uint32 count = 0;
+			auto add_corner = [&] (Vertex b, Vertex c, Vertex a)
+			{
+				const VEC3& p = value<VEC3>(m, vertex_position, c);
+				const Scalar alpha = angle(VEC3(value<VEC3>(m, vertex_position, b) - p), VEC3(value<VEC3>(m, vertex_position, a) - p));
+				value<VEC3>(m, vertex_normal, c) += alpha * fn;
+			};
+			foreach_incident_vertex(m, f, [&] (Vertex v) -> bool
+			{
+				if (count == 0)
+					v0 = v;
+				else if (count == 1)
+					v1 = v;
+				else
+					add_corner(prev, curr, v);
+				prev = curr;
+				curr = v;
+				++count;
+				return true;
+			});
+			add_corner(prev, curr, v0);
+			add_corner(curr, v0, v1);
+			return true;
+		});
+		parallel_foreach_cell(m, [&] (Vertex v) -> bool
+		{
+			normalize(value<VEC3>(m, vertex_normal, v));
+			return true;
+		});
+	}
+	vertex_normal->notify_modification();
+}
+
+namespace internal
+{
+
+/**
+ * orients the normals of n points consistently by propagation along the minimum spanning tree of their
+ * symmetric kNN graph (weight 1 - |ni.nj|, Prim's algorithm), starting in each connected component from
+ * its highest point whose normal is oriented towards +z.
+ * The neighbors of point i are neighbors[i * k, (i + 1) * k[ and normal_of(i) gives a reference to its normal.
+ * Prim's algorithm is sequential: each point is oriented from its parent, which is only known once all the
+ * points of smaller weight have been reached. The graph is built in O(n k).
+ */
+template <typename VEC3, typename FUNC>
+void
+orient_normals(const std::vector<VEC3>& points, const std::vector<uint32>& neighbors, uint32 k, const FUNC& normal_of)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	const uint32 n = uint32(points.size());
+
+	// 2 n k (directed) arcs: the offsets do not fit in 32 bits for large clouds
+	std::vector<std::size_t> offsets(n + 1u, 0u);
+	for (std::size_t e = 0u; e < neighbors.size(); ++e)
+	{
+		++offsets[e / k + 1u];
+		++offsets[neighbors[e] + 1u];
+	}
+	for (uint32 i = 0u; i < n; ++i)
+		offsets[i + 1u] += offsets[i];
+	std::vector<uint32> adjacency(offsets[n]);
+	{
+		std::vector<std::size_t> pos(offsets.begin(), offsets.end() - 1);
+		for (std::size_t e = 0u; e < neighbors.size(); ++e)
+		{
+			const uint32 a = uint32(e / k);
+			const uint32 b = neighbors[e];
+			adjacency[pos[a]++] = b;
+			adjacency[pos[b]++] = a;
+		}
+	}
+
+	// components are processed from their highest point
+	std::vector<uint32> order(n);
+	for (uint32 i = 0u; i < n; ++i)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [&] (uint32 a, uint32 b) { return points[a][2] > points[b][2]; });
+
+	using Candidate = std::pair<Scalar, std::pair<uint32, uint32>>; // (weight, (point, parent))
+	std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+	std::vector<bool> visited(n, false);
+	for (uint32 seed : order)
+	{
+		if (visited[seed])
+			continue;
+		if (normal_of(seed)[2] < Scalar(0))
+			normal_of(seed) = -normal_of(seed);
+		queue.push(Candidate(Scalar(0), std::make_pair(seed, seed)));
+		while (!queue.empty())
+		{
+			const uint32 i = queue.top().second.first;
+			const uint32 parent = queue.top().second.second;
+			queue.pop();
+			if (visited[i])
+				continue;
+			visited[i] = true;
+			VEC3& ni = normal_of(i);
+			if (ni.dot(normal_of(parent)) < Scalar(0))
+				ni = -ni;
+			for (std::size_t a = offsets[i]; a < offsets[i + 1u]; ++a)
+			{
+				const uint32 j = adjacency[a];
+				if (!visited[j])
+					queue.push(Candidate(Scalar(1) - std::abs(ni.dot(normal_of(j))), std::make_pair(j, i)));
+			}
+		}
+	}
+}
+
+} // namespace internal
+
+/**
+ * \brief estimates the normals of a point cloud: the normal of a point is the direction of least variance
+ * of its k nearest neighbors (eigenvector of the smallest eigenvalue of their covariance matrix).
+ * The neighbors and the eigen-decompositions are computed in parallel.
+ * \param[in] orient if true, the normals are consistently oriented by propagation along a minimum spanning tree
+ * of the kNN graph (weight 1 - |ni.nj|), starting in each connected component from the highest point whose normal
+ * is oriented towards +z; otherwise the sign of the normals is arbitrary
+ */
+template <typename VEC3>
+void
+compute_normal(
+	const CMap0& m,
+	const typename mesh_traits<CMap0>::template Attribute<VEC3>* vertex_position,
+	typename mesh_traits<CMap0>::template Attribute<VEC3>* vertex_normal,
+	uint32 k = 10u,
+	bool orient = true
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex = CMap0::Vertex;
+	using Matrix3 = Eigen::Matrix<Scalar, 3, 3>;
+	using Vector3 = Eigen::Matrix<Scalar, 3, 1>;
+
+	const KDTree<CMap0, VEC3> kd_tree(m, vertex_position);
+	const uint32 n = kd_tree.nb_points();
+	if (n == 0u)
+		return;
+	k = std::min(k, n);
+
+	// markers are not thread-safe: points are gathered sequentially and then processed in parallel
+	std::vector<uint32> point_index;
+	point_index.reserve(n);
+	foreach_cell(m, [&] (Vertex v) -> bool { point_index.push_back(index_of(m, v)); return true; });
+
+	std::vector<VEC3> points(n);
+	parallel_for(n, [&] (uint32 i) { points[i] = (*vertex_position)[point_index[i]]; });
+	std::vector<Vertex> neighbor_vertices;
+	kd_tree.knn(points, k, neighbor_vertices);
+
+	// neighbors as point numbers (for the spanning tree)
+	std::vector<uint32> point_of_index(vertex_position->size(), INVALID_INDEX);
+	for (uint32 i = 0u; i < n; ++i)
+		point_of_index[point_index[i]] = i;
+	std::vector<uint32> neighbors(std::size_t(n) * k);
+
+	parallel_for(n, [&] (uint32 i)
+	{
+		const std::size_t first = std::size_t(i) * k;
+		Vector3 mean = Vector3::Zero();
+		for (uint32 j = 0u; j < k; ++j)
+		{
+			const uint32 nb = point_of_index[index_of(m, neighbor_vertices[first + j])];
+			neighbors[first + j] = nb;
+			mean += Vector3(points[nb][0], points[nb][1], points[nb][2]);
+		}
+		mean /= Scalar(k);
+		Matrix3 covariance = Matrix3::Zero();
+		for (uint32 j = 0u; j < k; ++j)
+		{
+			const VEC3& p = points[neighbors[first + j]];
+			const Vector3 d = Vector3(p[0], p[1], p[2]) - mean;
+			covariance += d * d.transpose();
+		}
+		// the eigenvalues are sorted in increasing order
+		Eigen::SelfAdjointEigenSolver<Matrix3> solver;
+		solver.computeDirect(covariance);
+		const Vector3 normal = solver.eigenvectors().col(0);
+		VEC3& res = (*vertex_normal)[point_index[i]];
+		res = VEC3(normal[0], normal[1], normal[2]);
+	}, 256u);
+
+	if (orient)
+		internal::orient_normals(points, neighbors, k, [&] (uint32 i) -> VEC3& { return (*vertex_normal)[point_index[i]]; });
+	vertex_normal->notify_modification();
 }
 
 } // namespace geometry
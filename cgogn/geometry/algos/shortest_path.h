@@ -0,0 +1,331 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_ALGOS_SHORTEST_PATH_H_
+#define CGOGN_GEOMETRY_ALGOS_SHORTEST_PATH_H_
+
+#include <cgogn/core/types/mesh_traits.h>
+#include <cgogn/core/functions/traversals/global.h>
+#include <cgogn/core/functions/traversals/vertex.h>
+#include <cgogn/core/functions/attributes.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/radix_heap.h>
+
+#include <cgogn/geometry/types/vector_traits.h>
+#include <cgogn/geometry/functions/vector_ops.h>
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * \brief shortest paths in the graph of the vertices and edges of a mesh (or mesh view), the length of
+ * an edge being the distance between the positions of its vertices.
+ *
+ * The adjacency graph and the edge lengths are computed once by the constructor, so that many queries
+ * (region growing, local parameterizations) can be run on the same mesh. A query is a multi-source Dijkstra
+ * with a monotone radix heap; the state of the vertices is tagged with the number of the query (epoch),
+ * so that a query never clears anything and costs only the size of the explored region.
+ * A query can be bounded by a radius: the vertices farther than the radius from the sources are not reached.
+ *
+ * Queries modify the state of the object: they must not be run concurrently on the same object.
+ * The topology of the mesh must not change during the lifetime of the object.
+ */
+template <typename MESH>
+class ShortestPaths
+{
+public:
+
+	using Scalar = float64;
+	using Vertex = typename mesh_traits<MESH>::Vertex;
+
+private:
+
+	const MESH& m_;
+
+	std::vector<Vertex> vertices_;
+	std::vector<uint32> row_; // row of the vertices indexed by their attribute index
+	std::vector<uint32> offsets_;
+	std::vector<uint32> neighbors_;
+	std::vector<Scalar> length_;
+
+	uint32 epoch_;
+	std::vector<uint32> reached_epoch_;
+	std::vector<uint32> settled_epoch_;
+	std::vector<Scalar> distance_;
+	std::vector<uint32> predecessor_;
+	std::vector<uint32> source_;
+
+	std::vector<Vertex> reached_vertices_;
+	RadixHeap<uint32, Scalar> heap_;
+
+	uint32 row(Vertex v) const { return row_[index_of(m_, v)]; }
+	bool settled(uint32 r) const { return settled_epoch_[r] == epoch_; }
+
+	void build_graph()
+	{
+		// markers are not thread-safe: vertices are gathered sequentially and then processed in parallel
+		foreach_cell(m_, [&] (Vertex v) -> bool { vertices_.push_back(v); return true; });
+		const uint32 nbv = nb_vertices();
+
+		uint32 max_index = 0u;
+		for (Vertex v : vertices_)
+			max_index = std::max(max_index, index_of(m_, v));
+		row_.assign(max_index + 1u, INVALID_INDEX);
+		for (uint32 r = 0u; r < nbv; ++r)
+			row_[index_of(m_, vertices_[r])] = r;
+
+		offsets_.resize(nbv + 1u);
+		offsets_[0] = 0u;
+		parallel_for(nbv, [&] (uint32 r)
+		{
+			uint32 count = 0u;
+			foreach_adjacent_vertex_through_edge(m_, vertices_[r], [&] (Vertex) -> bool { ++count; return true; });
+			offsets_[r + 1u] = count;
+		});
+		for (uint32 r = 0u; r < nbv; ++r)
+			offsets_[r + 1u] += offsets_[r];
+
+		neighbors_.resize(offsets_[nbv]);
+		length_.resize(offsets_[nbv]);
+		parallel_for(nbv, [&] (uint32 r)
+		{
+			uint32 k = offsets_[r];
+			foreach_adjacent_vertex_through_edge(m_, vertices_[r], [&] (Vertex av) -> bool
+			{
+				neighbors_[k++] = row(av);
+				return true;
+			});
+		});
+
+		reached_epoch_.assign(nbv, 0u);
+		settled_epoch_.assign(nbv, 0u);
+		distance_.resize(nbv);
+		predecessor_.resize(nbv);
+		source_.resize(nbv);
+	}
+
+	void next_epoch()
+	{
+		if (++epoch_ == 0u)
+		{
+			std::fill(reached_epoch_.begin(), reached_epoch_.end(), 0u);
+			std::fill(settled_epoch_.begin(), settled_epoch_.end(), 0u);
+			epoch_ = 1u;
+		}
+	}
+
+public:
+
+	template <typename VEC3>
+	ShortestPaths(const MESH& m, const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position) :
+		m_(m),
+		epoch_(0u)
+	{
+		build_graph();
+		update<VEC3>(vertex_position);
+	}
+
+	ShortestPaths(const ShortestPaths&) = delete;
+	ShortestPaths& operator=(const ShortestPaths&) = delete;
+
+	uint32 nb_vertices() const { return uint32(vertices_.size()); }
+
+	/**
+	 * \brief refreshes the lengths of the edges from the given vertex positions
+	 */
+	template <typename VEC3>
+	void update(const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position)
+	{
+		parallel_for(nb_vertices(), [&] (uint32 r)
+		{
+			const VEC3& p = value<VEC3>(m_, vertex_position, vertices_[r]);
+			for (uint32 k = offsets_[r]; k < offsets_[r + 1u]; ++k)
+				length_[k] = Scalar((value<VEC3>(m_, vertex_position, vertices_[neighbors_[k]]) - p).norm());
+		});
+	}
+
+	/**
+	 * \brief computes the shortest paths from the closest of the given sources to the vertices
+	 * that are at most at the given distance from the sources
+	 * \returns the reached vertices, by increasing distance
+	 */
+	const std::vector<Vertex>& compute(
+		const std::vector<Vertex>& sources,
+		Scalar radius = std::numeric_limits<Scalar>::max()
+	)
+	{
+		next_epoch();
+		heap_.clear();
+		reached_vertices_.clear();
+
+		for (Vertex s : sources)
+		{
+			const uint32 r = row(s);
+			if (reached_epoch_[r] == epoch_)
+				continue;
+			reached_epoch_[r] = epoch_;
+			distance_[r] = Scalar(0);
+			predecessor_[r] = INVALID_INDEX;
+			source_[r] = r;
+			heap_.push(Scalar(0), r);
+		}
+
+		while (!heap_.empty())
+		{
+			const std::pair<Scalar, uint32> e = heap_.pop();
+			const uint32 r = e.second;
+			// outdated entry of a vertex whose distance was decreased after its push
+			if (settled(r) || e.first > distance_[r])
+				continue;
+			if (e.first > radius)
+				break;
+			settled_epoch_[r] = epoch_;
+			reached_vertices_.push_back(vertices_[r]);
+
+			for (uint32 k = offsets_[r]; k < offsets_[r + 1u]; ++k)
+			{
+				const uint32 n = neighbors_[k];
+				if (settled(n))
+					continue;
+				const Scalar d = e.first + length_[k];
+				if (reached_epoch_[n] != epoch_ || d < distance_[n])
+				{
+					reached_epoch_[n] = epoch_;
+					distance_[n] = d;
+					predecessor_[n] = r;
+					source_[n] = source_[r];
+					heap_.push(d, n);
+				}
+			}
+		}
+
+		return reached_vertices_;
+	}
+
+	/**
+	 * \brief vertices reached by the last query, by increasing distance
+	 */
+	const std::vector<Vertex>& reached_vertices() const { return reached_vertices_; }
+
+	bool is_reached(Vertex v) const { return settled(row(v)); }
+
+	/**
+	 * \brief distance of the given vertex to its closest source in the last query (infinite if not reached)
+	 */
+	Scalar distance(Vertex v) const
+	{
+		const uint32 r = row(v);
+		return settled(r) ? distance_[r] : std::numeric_limits<Scalar>::infinity();
+	}
+
+	/**
+	 * \brief previous vertex on the shortest path from the closest source to the given vertex
+	 * (invalid for the sources and for the vertices that are not reached)
+	 */
+	Vertex predecessor(Vertex v) const
+	{
+		const uint32 r = row(v);
+		return settled(r) && predecessor_[r] != INVALID_INDEX ? vertices_[predecessor_[r]] : Vertex();
+	}
+
+	/**
+	 * \brief closest source of the given vertex in the last query (invalid if not reached)
+	 */
+	Vertex closest_source(Vertex v) const
+	{
+		const uint32 r = row(v);
+		return settled(r) ? vertices_[source_[r]] : Vertex();
+	}
+
+	/**
+	 * \brief shortest path from the closest source to the given vertex (empty if not reached)
+	 */
+	void path(Vertex v, std::vector<Vertex>& p) const
+	{
+		p.clear();
+		uint32 r = row(v);
+		if (!settled(r))
+			return;
+		for (; r != INVALID_INDEX; r = predecessor_[r])
+			p.push_back(vertices_[r]);
+		std::reverse(p.begin(), p.end());
+	}
+
+	/**
+	 * \brief copies the result of the last query into vertex attributes: the vertices that are not reached
+	 * get the maximal value of T and an invalid predecessor
+	 */
+	template <typename T>
+	void get_distances(
+		typename mesh_traits<MESH>::template Attribute<T>* vertex_distance,
+		typename mesh_traits<MESH>::template Attribute<Vertex>* vertex_predecessor = nullptr
+	) const
+	{
+		parallel_for(nb_vertices(), [&] (uint32 r)
+		{
+			const bool s = settled(r);
+			if (vertex_distance)
+				value<T>(m_, vertex_distance, vertices_[r]) = s ? T(distance_[r]) : std::numeric_limits<T>::max();
+			if (vertex_predecessor)
+				value<Vertex>(m_, vertex_predecessor, vertices_[r]) =
+					s && predecessor_[r] != INVALID_INDEX ? vertices_[predecessor_[r]] : Vertex();
+		});
+		if (vertex_distance)
+			vertex_distance->notify_modification();
+		if (vertex_predecessor)
+			vertex_predecessor->notify_modification();
+	}
+};
+
+/**
+ * \brief computes the shortest paths in the vertex-edge graph of the mesh from the closest of the given sources.
+ * The vertices farther than radius from the sources get the maximal value of the distance type and an invalid predecessor.
+ * To run several queries on the same mesh, use a ShortestPaths object directly.
+ */
+template <typename VEC3, typename MESH>
+void compute_shortest_paths(
+	const MESH& m,
+	const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position,
+	const std::vector<typename mesh_traits<MESH>::Vertex>& sources,
+	typename mesh_traits<MESH>::template Attribute<typename vector_traits<VEC3>::Scalar>* vertex_distance,
+	typename mesh_traits<MESH>::template Attribute<typename mesh_traits<MESH>::Vertex>* vertex_predecessor = nullptr,
+	typename vector_traits<VEC3>::Scalar radius = std::numeric_limits<typename vector_traits<VEC3>::Scalar>::max()
+)
+{
+	ShortestPaths<MESH> sp(m, vertex_position);
+	sp.compute(sources, radius);
+	sp.template get_distances<typename vector_traits<VEC3>::Scalar>(vertex_distance, vertex_predecessor);
+}
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_ALGOS_SHORTEST_PATH_H_
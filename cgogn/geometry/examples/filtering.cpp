@@ -42,6 +42,7 @@
 #include <cgogn/geometry/algos/normal.h>
 #include <cgogn/geometry/algos/filtering.h>
 #include <cgogn/geometry/algos/subdivision.h>
+#include <cgogn/geometry/types/attribute_statistics.h>
 
 #include <cgogn/rendering/mesh_render.h>
 #include <cgogn/rendering/vbo.h>
@@ -90,9 +91,9 @@ private:
 	cgogn::CellFilter<Map2> filtered_map_;
 
 	Attribute<Vec3>* vertex_position_;
-	Attribute<Vec3>* vertex_position2_;
 	Attribute<Vec3>* vertex_normal_;
 
+	std::unique_ptr<cgogn::geometry::AttributeStatistics<Vec3>> position_statistics_;
 	Vec3 bb_min_, bb_max_;
 
 	std::unique_ptr<cgogn::rendering::MeshRender> render_;
@@ -171,7 +172,7 @@ void Viewer::import(const std::string& surface_mesh)
 		std::exit(EXIT_FAILURE);
 	}
 
-	vertex_position2_ = cgogn::add_attribute<Vec3, Vertex>(map_, "position2");
+	position_statistics_ = cgogn::make_unique<cgogn::geometry::AttributeStatistics<Vec3>>(vertex_position_);
 
 	vertex_normal_ = cgogn::add_attribute<Vec3, Vertex>(map_, "normal");
 	cgogn::geometry::compute_normal<Vec3>(map_, vertex_position_, vertex_normal_);
@@ -187,21 +188,8 @@ void Viewer::import(const std::string& surface_mesh)
 
 void Viewer::update_bb()
 {
-	for (cgogn::uint32 i = 0; i < 3; ++i)
-	{
-		bb_min_[i] = std::numeric_limits<cgogn::float32>::max();
-		bb_max_[i] = std::numeric_limits<cgogn::float32>::lowest();
-	}
-	for (Vec3& p : *vertex_position_)
-	{
-		for (cgogn::uint32 i = 0; i < 3; ++i)
-		{
-			if (p[i] < bb_min_[i])
-				bb_min_[i] = p[i];
-			if (p[i] > bb_max_[i])
-				bb_max_[i] = p[i];
-		}
-	}
+	bb_min_ = position_statistics_->min();
+	bb_max_ = position_statistics_->max();
 }
 
 void Viewer::keyPressEvent(QKeyEvent *ev)
@@ -229,10 +217,27 @@ void Viewer::keyPressEvent(QKeyEvent *ev)
 //			bb_rendering_ = !bb_rendering_;
 //			break;
 		case Qt::Key_A: {
-			for (cgogn::uint32 i = 0; i < vertex_position2_->size(); ++i)
-				(*vertex_position2_)[i] = (*vertex_position_)[i];
-			cgogn::geometry::filter_average<Vec3>(filtered_map_, vertex_position_, vertex_position2_);
-			vertex_position_->swap(vertex_position2_);
+			cgogn::geometry::filter_average<Vec3>(filtered_map_, vertex_position_, 1);
+			cgogn::geometry::compute_normal<Vec3>(map_, vertex_position_, vertex_normal_);
+			cgogn::rendering::update_vbo(vertex_position_, vbo_position_.get());
+			cgogn::rendering::update_vbo(vertex_normal_, vbo_normal_.get());
+			update_bb();
+			Vec3 diagonal = bb_max_ - bb_min_;
+			setSceneRadius(diagonal.norm() / 2.0);
+			break;
+		}
+		case Qt::Key_T: {
+			cgogn::geometry::filter_taubin<Vec3>(filtered_map_, vertex_position_, 10);
+			cgogn::geometry::compute_normal<Vec3>(map_, vertex_position_, vertex_normal_);
+			cgogn::rendering::update_vbo(vertex_position_, vbo_position_.get());
+			cgogn::rendering::update_vbo(vertex_normal_, vbo_normal_.get());
+			update_bb();
+			Vec3 diagonal = bb_max_ - bb_min_;
+			setSceneRadius(diagonal.norm() / 2.0);
+			break;
+		}
+		case Qt::Key_L: {
+			cgogn::geometry::filter_bilateral<Vec3>(filtered_map_, vertex_position_, vertex_normal_, 1);
 			cgogn::geometry::compute_normal<Vec3>(map_, vertex_position_, vertex_normal_);
 			cgogn::rendering::update_vbo(vertex_position_, vbo_position_.get());
 			cgogn::rendering::update_vbo(vertex_normal_, vbo_normal_.get());
@@ -262,6 +267,7 @@ void Viewer::keyPressEvent(QKeyEvent *ev)
 			});
 
 			cgogn::geometry::subdivide<Vec3>(filtered_map, vertex_position_);
+			vertex_position_->notify_modification();
 			std::cout << "nbv: " << cgogn::nb_cells<Vertex>(map_) << std::endl;
 			cgogn::geometry::compute_normal<Vec3>(map_, vertex_position_, vertex_normal_);
 			cgogn::rendering::update_vbo(vertex_position_, vbo_position_.get());
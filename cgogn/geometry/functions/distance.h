@@ -0,0 +1,139 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_FUNCTIONS_DISTANCE_H_
+#define CGOGN_GEOMETRY_FUNCTIONS_DISTANCE_H_
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/geometry/types/vector_traits.h>
+
+#include <limits>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * \brief closest point to p in the segment [a, b]
+ */
+template <typename VEC3>
+VEC3
+closest_point_in_segment(const VEC3& p, const VEC3& a, const VEC3& b)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+
+	const VEC3 ab = b - a;
+	const Scalar l2 = ab.squaredNorm();
+	if (l2 <= Scalar(0))
+		return a;
+	const Scalar t = ab.dot(p - a) / l2;
+	if (t <= Scalar(0))
+		return a;
+	if (t >= Scalar(1))
+		return b;
+	return a + ab * t;
+}
+
+/**
+ * \brief closest point to p in the triangle (a, b, c) (Ericson, Real-Time Collision Detection, 5.1.5)
+ */
+template <typename VEC3>
+VEC3
+closest_point_in_triangle(const VEC3& p, const VEC3& a, const VEC3& b, const VEC3& c)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+
+	const VEC3 ab = b - a;
+	const VEC3 ac = c - a;
+	const VEC3 ap = p - a;
+	const Scalar d1 = ab.dot(ap);
+	const Scalar d2 = ac.dot(ap);
+	if (d1 <= Scalar(0) && d2 <= Scalar(0))
+		return a;
+
+	const VEC3 bp = p - b;
+	const Scalar d3 = ab.dot(bp);
+	const Scalar d4 = ac.dot(bp);
+	if (d3 >= Scalar(0) && d4 <= d3)
+		return b;
+
+	const Scalar vc = d1 * d4 - d3 * d2;
+	if (vc <= Scalar(0) && d1 >= Scalar(0) && d3 <= Scalar(0))
+		return a + ab * (d1 / (d1 - d3));
+
+	const VEC3 cp = p - c;
+	const Scalar d5 = ab.dot(cp);
+	const Scalar d6 = ac.dot(cp);
+	if (d6 >= Scalar(0) && d5 <= d6)
+		return c;
+
+	const Scalar vb = d5 * d2 - d1 * d6;
+	if (vb <= Scalar(0) && d2 >= Scalar(0) && d6 <= Scalar(0))
+		return a + ac * (d2 / (d2 - d6));
+
+	const Scalar va = d3 * d6 - d5 * d4;
+	if (va <= Scalar(0) && (d4 - d3) >= Scalar(0) && (d5 - d6) >= Scalar(0))
+		return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+	// va + vb + vc is the squared norm of ab x ac: when it vanishes (up to rounding errors) the triangle is flat
+	// and has no interior, its closest point is on one of its edges
+	const Scalar sum = va + vb + vc;
+	if (!(sum > Scalar(16) * std::numeric_limits<Scalar>::epsilon() * ab.squaredNorm() * ac.squaredNorm()))
+	{
+		const VEC3 q[3] = {
+			closest_point_in_segment(p, a, b),
+			closest_point_in_segment(p, b, c),
+			closest_point_in_segment(p, c, a)
+		};
+		uint32 best = 0;
+		Scalar best_d2 = (q[0] - p).squaredNorm();
+		for (uint32 i = 1; i < 3; ++i)
+		{
+			const Scalar d2 = (q[i] - p).squaredNorm();
+			if (d2 < best_d2)
+			{
+				best = i;
+				best_d2 = d2;
+			}
+		}
+		return q[best];
+	}
+
+	const Scalar denom = Scalar(1) / sum;
+	return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+template <typename VEC3>
+typename vector_traits<VEC3>::Scalar
+squared_distance_point_triangle(const VEC3& p, const VEC3& a, const VEC3& b, const VEC3& c)
+{
+	return (closest_point_in_triangle(p, a, b, c) - p).squaredNorm();
+}
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_FUNCTIONS_DISTANCE_H_
@@ -0,0 +1,167 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_FUNCTIONS_INTERSECTION_H_
+#define CGOGN_GEOMETRY_FUNCTIONS_INTERSECTION_H_
+
+#include <cgogn/core/utils/numerics.h>
+
+#include <cgogn/geometry/types/vector_traits.h>
+#include <cgogn/geometry/types/aabb.h>
+
+#include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * \brief intersection of the ray origin + t direction (t in [0, t_max]) with the triangle (a, b, c) (Moller-Trumbore)
+ * \param[out] t the parameter of the intersection point along the ray
+ * \returns true if the ray intersects the triangle
+ */
+template <typename VEC3>
+bool
+intersection_ray_triangle(
+	const VEC3& origin, const VEC3& direction, typename vector_traits<VEC3>::Scalar t_max,
+	const VEC3& a, const VEC3& b, const VEC3& c,
+	typename vector_traits<VEC3>::Scalar& t
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+
+	const VEC3 ab = b - a;
+	const VEC3 ac = c - a;
+	const VEC3 pv = direction.cross(ac);
+	const Scalar det = ab.dot(pv);
+	if (std::abs(det) <= std::numeric_limits<Scalar>::min())
+		return false;
+	const Scalar inv_det = Scalar(1) / det;
+
+	const VEC3 tv = origin - a;
+	const Scalar u = tv.dot(pv) * inv_det;
+	if (u < Scalar(0) || u > Scalar(1))
+		return false;
+
+	const VEC3 qv = tv.cross(ab);
+	const Scalar v = direction.dot(qv) * inv_det;
+	if (v < Scalar(0) || u + v > Scalar(1))
+		return false;
+
+	t = ac.dot(qv) * inv_det;
+	return t >= Scalar(0) && t <= t_max;
+}
+
+/**
+ * \brief intersection of the ray origin + t direction (t in [0, t_max]) with the box bb (slabs method)
+ * \param[in] inv_direction the componentwise inverse of the direction of the ray
+ * \param[out] t_entry the parameter of the entry point of the ray in the box
+ */
+template <typename VEC3>
+bool
+intersection_ray_aabb(
+	const VEC3& origin, const VEC3& inv_direction, typename vector_traits<VEC3>::Scalar t_max,
+	const AABB<VEC3>& bb,
+	typename vector_traits<VEC3>::Scalar& t_entry
+)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+
+	Scalar t0 = Scalar(0);
+	Scalar t1 = t_max;
+	for (uint32 i = 0u; i < 3u; ++i)
+	{
+		Scalar tn = (bb.min[i] - origin[i]) * inv_direction[i];
+		Scalar tf = (bb.max[i] - origin[i]) * inv_direction[i];
+		if (tn > tf)
+			std::swap(tn, tf);
+		// NaN (0 * inf) comparisons are false: the slab is then ignored
+		if (tn > t0)
+			t0 = tn;
+		if (tf < t1)
+			t1 = tf;
+		if (t0 > t1)
+			return false;
+	}
+	t_entry = t0;
+	return true;
+}
+
+/**
+ * \brief overlap test between the triangle (a, b, c) and the box bb (separating axis theorem, Akenine-Moller)
+ */
+template <typename VEC3>
+bool
+intersection_triangle_aabb(const VEC3& a, const VEC3& b, const VEC3& c, const AABB<VEC3>& bb)
+{
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+
+	const VEC3 center = bb.center();
+	const VEC3 h = bb.max - center;
+	const VEC3 v[3] = { a - center, b - center, c - center };
+
+	// axes of the box
+	for (uint32 i = 0u; i < 3u; ++i)
+	{
+		const Scalar mi = std::min(v[0][i], std::min(v[1][i], v[2][i]));
+		const Scalar ma = std::max(v[0][i], std::max(v[1][i], v[2][i]));
+		if (mi > h[i] || ma < -h[i])
+			return false;
+	}
+
+	// normal of the triangle
+	const VEC3 e[3] = { v[1] - v[0], v[2] - v[1], v[0] - v[2] };
+	const VEC3 n = e[0].cross(e[1]);
+	if (std::abs(n.dot(v[0])) > h[0] * std::abs(n[0]) + h[1] * std::abs(n[1]) + h[2] * std::abs(n[2]))
+		return false;
+
+	// cross products of the edges of the triangle with the axes of the box
+	for (uint32 i = 0u; i < 3u; ++i)
+	{
+		for (uint32 j = 0u; j < 3u; ++j)
+		{
+			VEC3 axis;
+			axis.setZero();
+			axis[(j + 1u) % 3u] = -e[i][(j + 2u) % 3u];
+			axis[(j + 2u) % 3u] = e[i][(j + 1u) % 3u];
+			const Scalar p0 = axis.dot(v[0]);
+			const Scalar p1 = axis.dot(v[1]);
+			const Scalar p2 = axis.dot(v[2]);
+			const Scalar r = h[0] * std::abs(axis[0]) + h[1] * std::abs(axis[1]) + h[2] * std::abs(axis[2]);
+			if (std::min(p0, std::min(p1, p2)) > r || std::max(p0, std::max(p1, p2)) < -r)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_FUNCTIONS_INTERSECTION_H_
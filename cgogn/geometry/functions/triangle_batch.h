@@ -0,0 +1,248 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_FUNCTIONS_TRIANGLE_BATCH_H_
+#define CGOGN_GEOMETRY_FUNCTIONS_TRIANGLE_BATCH_H_
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/utils/assert.h>
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#if defined(CGOGN_USE_SIMD) && (defined(__AVX512F__) || defined(__AVX__))
+#include <immintrin.h>
+#endif
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+namespace simd
+{
+
+/**
+ * \brief pack of doubles processed by one SIMD instruction.
+ * The implementation is chosen at build time from the instruction sets enabled for the compiler
+ * (when CGOGN_USE_SIMD is on): AVX-512, AVX2/AVX or scalar. These instruction sets are not enabled by default:
+ * see the CGOGN_USE_HOST_SIMD_FLAGS cmake option or pass e.g. -march to the compiler.
+ */
+#if defined(CGOGN_USE_SIMD) && defined(__AVX512F__)
+
+struct PackD
+{
+	static const uint32 SIZE = 8u;
+	__m512d v;
+	PackD() {}
+	PackD(__m512d x) : v(x) {}
+	static PackD load(const float64* p) { return _mm512_loadu_pd(p); }
+	static PackD set1(float64 x) { return _mm512_set1_pd(x); }
+	void store(float64* p) const { _mm512_storeu_pd(p, v); }
+	friend PackD operator+(PackD a, PackD b) { return _mm512_add_pd(a.v, b.v); }
+	friend PackD operator-(PackD a, PackD b) { return _mm512_sub_pd(a.v, b.v); }
+	friend PackD operator*(PackD a, PackD b) { return _mm512_mul_pd(a.v, b.v); }
+	friend PackD operator/(PackD a, PackD b) { return _mm512_div_pd(a.v, b.v); }
+	friend PackD sqrt(PackD a) { return _mm512_sqrt_pd(a.v); }
+	friend PackD max(PackD a, PackD b) { return _mm512_max_pd(a.v, b.v); }
+};
+
+static const char* const ISA = "avx512";
+
+#elif defined(CGOGN_USE_SIMD) && defined(__AVX__)
+
+struct PackD
+{
+	static const uint32 SIZE = 4u;
+	__m256d v;
+	PackD() {}
+	PackD(__m256d x) : v(x) {}
+	static PackD load(const float64* p) { return _mm256_loadu_pd(p); }
+	static PackD set1(float64 x) { return _mm256_set1_pd(x); }
+	void store(float64* p) const { _mm256_storeu_pd(p, v); }
+	friend PackD operator+(PackD a, PackD b) { return _mm256_add_pd(a.v, b.v); }
+	friend PackD operator-(PackD a, PackD b) { return _mm256_sub_pd(a.v, b.v); }
+	friend PackD operator*(PackD a, PackD b) { return _mm256_mul_pd(a.v, b.v); }
+	friend PackD operator/(PackD a, PackD b) { return _mm256_div_pd(a.v, b.v); }
+	friend PackD sqrt(PackD a) { return _mm256_sqrt_pd(a.v); }
+	friend PackD max(PackD a, PackD b) { return _mm256_max_pd(a.v, b.v); }
+};
+
+static const char* const ISA = "avx";
+
+#else
+
+struct PackD
+{
+	static const uint32 SIZE = 1u;
+	float64 v;
+	PackD() {}
+	PackD(float64 x) : v(x) {}
+	static PackD load(const float64* p) { return *p; }
+	static PackD set1(float64 x) { return x; }
+	void store(float64* p) const { *p = v; }
+	friend PackD operator+(PackD a, PackD b) { return a.v + b.v; }
+	friend PackD operator-(PackD a, PackD b) { return a.v - b.v; }
+	friend PackD operator*(PackD a, PackD b) { return a.v * b.v; }
+	friend PackD operator/(PackD a, PackD b) { return a.v / b.v; }
+	friend PackD sqrt(PackD a) { return std::sqrt(a.v); }
+	friend PackD max(PackD a, PackD b) { return std::max(a.v, b.v); }
+};
+
+static const char* const ISA = "scalar";
+
+#endif
+
+} // namespace simd
+
+/**
+ * \brief number of triangles processed together by compute_triangle_batch:
+ * 16 with AVX-512 (2 packs of 8 doubles), 8 otherwise
+ */
+static const uint32 TRIANGLE_BATCH_SIZE = simd::PackD::SIZE == 8u ? 16u : 8u;
+
+/**
+ * \brief batch of triangles stored in SoA layout (one array per coordinate).
+ * Triangle i of the batch is made of the points (p[0][.][i], p[1][.][i], p[2][.][i]).
+ * Lanes that are not used (i >= size) must hold valid (e.g. null) values: see clear().
+ */
+struct TriangleBatch
+{
+	static const uint32 SIZE = TRIANGLE_BATCH_SIZE;
+
+	// input: p[vertex][coordinate][triangle]
+	float64 p[3][3][SIZE];
+	uint32 size;
+
+	// output: unit normal n[coordinate][triangle]
+	float64 normal[3][SIZE];
+	// output: area of the triangles
+	float64 area[SIZE];
+	// output: length of the edge going from vertex k to vertex k+1
+	float64 edge_length[3][SIZE];
+	// output: angle (in radians) at vertex k
+	float64 angle[3][SIZE];
+
+	TriangleBatch() : size(0u)
+	{}
+
+	void clear()
+	{
+		std::fill(&p[0][0][0], &p[0][0][0] + 9u * SIZE, 0.0);
+		size = 0u;
+	}
+
+	template <typename VEC3>
+	void add(const VEC3& p0, const VEC3& p1, const VEC3& p2)
+	{
+		cgogn_message_assert(size < SIZE, "TriangleBatch: batch is full");
+		for (uint32 c = 0u; c < 3u; ++c)
+		{
+			p[0][c][size] = float64(p0[c]);
+			p[1][c][size] = float64(p1[c]);
+			p[2][c][size] = float64(p2[c]);
+		}
+		++size;
+	}
+
+	bool full() const { return size == SIZE; }
+};
+
+/**
+ * \brief computes the normals, areas, edge lengths and angles of all the triangles of the batch in one pass.
+ * Everything but the final atan2 of the angles is computed on SIMD packs.
+ * Degenerated triangles get a null normal, like the polygons whose vector area is normalized by normalize.
+ * \param[in] with_angles the angles (the most expensive part) are skipped when false
+ */
+inline void compute_triangle_batch(TriangleBatch& b, bool with_angles = true)
+{
+	using simd::PackD;
+	const uint32 S = TriangleBatch::SIZE;
+	const PackD half = PackD::set1(0.5);
+	const PackD tiny = PackD::set1(std::numeric_limits<float64>::min());
+
+	// the cross product of two edges (twice the area) is used by the angles of the three corners
+	float64 twice_area[S];
+	float64 dot[3][S];
+
+	for (uint32 i = 0u; i < S; i += PackD::SIZE)
+	{
+		PackD p[3][3];
+		for (uint32 v = 0u; v < 3u; ++v)
+			for (uint32 c = 0u; c < 3u; ++c)
+				p[v][c] = PackD::load(&b.p[v][c][i]);
+
+		// edges e_k = p_{k+1} - p_k
+		PackD e[3][3];
+		for (uint32 k = 0u; k < 3u; ++k)
+			for (uint32 c = 0u; c < 3u; ++c)
+				e[k][c] = p[(k + 1u) % 3u][c] - p[k][c];
+
+		// n = e0 x (p2 - p0) = e2 x e0
+		PackD n[3];
+		n[0] = e[2][1] * e[0][2] - e[2][2] * e[0][1];
+		n[1] = e[2][2] * e[0][0] - e[2][0] * e[0][2];
+		n[2] = e[2][0] * e[0][1] - e[2][1] * e[0][0];
+		const PackD n_norm = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		const PackD inv_norm = PackD::set1(1.0) / max(n_norm, tiny);
+		for (uint32 c = 0u; c < 3u; ++c)
+			(n[c] * inv_norm).store(&b.normal[c][i]);
+		(half * n_norm).store(&b.area[i]);
+		n_norm.store(&twice_area[i]);
+
+		for (uint32 k = 0u; k < 3u; ++k)
+		{
+			const PackD* ek = e[k];
+			const PackD* ep = e[(k + 2u) % 3u]; // edge arriving at vertex k
+			sqrt(ek[0] * ek[0] + ek[1] * ek[1] + ek[2] * ek[2]).store(&b.edge_length[k][i]);
+			// the angle at vertex k is between e_k and -e_{k-1}
+			(PackD::set1(0.0) - (ek[0] * ep[0] + ek[1] * ep[1] + ek[2] * ep[2])).store(&dot[k][i]);
+		}
+	}
+
+	// degenerated triangles (null squared norm of the cross product) get a null normal, as normalize does for
+	// the other faces: the division by tiny would otherwise blow up the normals whose squared norm underflows
+	for (uint32 i = 0u; i < S; ++i)
+	{
+		if (twice_area[i] == 0.0)
+		{
+			for (uint32 c = 0u; c < 3u; ++c)
+				b.normal[c][i] = 0.0;
+		}
+	}
+
+	if (!with_angles)
+		return;
+
+	for (uint32 k = 0u; k < 3u; ++k)
+		for (uint32 i = 0u; i < S; ++i)
+			b.angle[k][i] = std::atan2(twice_area[i], dot[k][i]);
+}
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_FUNCTIONS_TRIANGLE_BATCH_H_
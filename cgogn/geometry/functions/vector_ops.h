@@ -26,6 +26,8 @@
 
 #include <cgogn/geometry/types/vector_traits.h>
 
+#include <cmath>
+
 namespace cgogn
 {
 
@@ -46,9 +48,9 @@ normalize(VEC& v)
 template <typename VEC,
 		  typename = typename std::enable_if<is_eigen<VEC>::value>::type>
 typename vector_traits<VEC>::Scalar
-squared_norm(VEC& v)
+squared_norm(const VEC& v)
 {
-	v.squareNorm();
+	return v.squaredNorm();
 }
 
 template <typename VEC,
@@ -76,6 +78,18 @@ cross(const VEC3& v1, const VEC3& v2)
 	return v1.cross(v2);
 }
 
+/**
+ * angle (in radians) between 2 vectors in 3D
+ */
+template <typename VEC3,
+		  typename = typename std::enable_if<is_eigen<VEC3>::value>::type>
+typename vector_traits<VEC3>::Scalar
+angle(const VEC3& v1, const VEC3& v2)
+{
+	static_assert (vector_traits<VEC3>::SIZE == 3, "vec_ops: angle is only defined for vectors of dimension 3");
+	return std::atan2(v1.cross(v2).norm(), v1.dot(v2));
+}
+
 } // namespace geometry
 
 } // namespace cgogn
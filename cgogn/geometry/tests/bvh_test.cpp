@@ -0,0 +1,221 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <cgogn/core/types/cmap/cmap2.h>
+#include <cgogn/core/functions/mesh_ops/surface_builder.h>
+#include <cgogn/core/functions/traversals/vertex.h>
+
+#include <cgogn/geometry/types/bvh.h>
+#include <cgogn/geometry/functions/distance.h>
+#include <cgogn/geometry/functions/intersection.h>
+
+#include <array>
+#include <cmath>
+#include <random>
+
+namespace cgogn
+{
+
+using Vec3 = Eigen::Vector3d;
+using BVH = geometry::BVH<CMap2, Vec3>;
+
+/**
+ * \brief fixture: a torus made of quads and triangles, with a flat triangle glued in a hole,
+ * and the fans of its faces for the brute force queries
+ */
+class BVHTest : public ::testing::Test
+{
+protected:
+
+	CMap2 map_;
+	Attribute<Vec3>* position_;
+	std::vector<std::array<Vec3, 3>> triangles_;
+	std::vector<uint32> triangle_face_;
+	std::mt19937 rng_;
+
+	BVHTest() : position_(nullptr), rng_(42u)
+	{
+		const uint32 nu = 24u, nv = 12u;
+		std::vector<Vec3> positions;
+		for (uint32 i = 0u; i < nu; ++i)
+		{
+			const double u = 2.0 * M_PI * i / nu;
+			for (uint32 j = 0u; j < nv; ++j)
+			{
+				const double v = 2.0 * M_PI * j / nv;
+				positions.emplace_back((1.0 + 0.3 * std::cos(v)) * std::cos(u), (1.0 + 0.3 * std::cos(v)) * std::sin(u), 0.3 * std::sin(v));
+			}
+		}
+		// flat triangle (three aligned points)
+		const uint32 flat = uint32(positions.size());
+		positions.emplace_back(2.0, 0.0, 0.0);
+		positions.emplace_back(2.5, 0.0, 0.0);
+		positions.emplace_back(3.0, 0.0, 0.0);
+
+		std::vector<uint32> offsets(1u, 0u);
+		std::vector<uint32> indices;
+		auto add = [&] (std::initializer_list<uint32> face)
+		{
+			indices.insert(indices.end(), face);
+			offsets.push_back(uint32(indices.size()));
+		};
+		for (uint32 i = 0u; i < nu; ++i)
+		{
+			for (uint32 j = 0u; j < nv; ++j)
+			{
+				const uint32 a = i * nv + j, b = ((i + 1u) % nu) * nv + j;
+				const uint32 c = ((i + 1u) % nu) * nv + (j + 1u) % nv, d = i * nv + (j + 1u) % nv;
+				if ((i + j) % 3u == 0u)
+				{
+					add({a, b, c});
+					add({a, c, d});
+				}
+				else
+					add({a, b, c, d});
+			}
+		}
+		add({flat, flat + 1u, flat + 2u});
+
+		build_from_faces(map_, positions, offsets, indices);
+		position_ = get_attribute<Vec3, CMap2::Vertex>(map_, "position");
+		add_attribute<uint32, CMap2::Face>(map_, "face_id"); // embeds the faces: they are compared by index
+
+		foreach_cell(map_, [&] (CMap2::Face f) -> bool
+		{
+			std::vector<CMap2::Vertex> vertices;
+			foreach_incident_vertex(map_, f, [&] (CMap2::Vertex v) -> bool { vertices.push_back(v); return true; });
+			for (uint32 k = 2u; k < vertices.size(); ++k)
+			{
+				triangles_.push_back({{
+					value<Vec3>(map_, position_, vertices[0]),
+					value<Vec3>(map_, position_, vertices[k - 1u]),
+					value<Vec3>(map_, position_, vertices[k])
+				}});
+				triangle_face_.push_back(index_of(map_, f));
+			}
+			return true;
+		});
+	}
+
+	Vec3 random_point()
+	{
+		std::uniform_real_distribution<double> d(-3.5, 3.5);
+		return Vec3(d(rng_), d(rng_), d(rng_) * 0.3);
+	}
+};
+
+TEST_F(BVHTest, ClosestPoint)
+{
+	BVH bvh(map_, position_);
+	EXPECT_EQ(bvh.nb_triangles(), uint32(triangles_.size()));
+	for (uint32 q = 0u; q < 500u; ++q)
+	{
+		const Vec3 p = random_point();
+		double best = std::numeric_limits<double>::max();
+		for (const auto& t : triangles_)
+			best = std::min(best, geometry::squared_distance_point_triangle(p, t[0], t[1], t[2]));
+		const BVH::ClosestPoint c = bvh.closest_point(p);
+		ASSERT_TRUE(c.found);
+		EXPECT_NEAR(c.squared_distance, best, 1e-9);
+		EXPECT_NEAR((c.point - p).squaredNorm(), best, 1e-9);
+	}
+}
+
+TEST(DistanceTest, ClosestPointInFlatTriangle)
+{
+	const Vec3 a(0.0, 0.0, 0.0), b(1.0, 0.0, 0.0);
+	const Vec3 c(0.5, 0.0, 0.0);
+	const Vec3 p(0.25, 1.0, 0.0);
+	const Vec3 q = geometry::closest_point_in_triangle(p, a, b, c);
+	EXPECT_TRUE(q.allFinite());
+	EXPECT_NEAR((q - Vec3(0.25, 0.0, 0.0)).norm(), 0.0, 1e-12);
+	const Vec3 r = geometry::closest_point_in_triangle(p, a, a, a);
+	EXPECT_EQ(r, a);
+}
+
+TEST_F(BVHTest, Ray)
+{
+	BVH bvh(map_, position_);
+	std::vector<BVH::Ray> rays;
+	for (uint32 q = 0u; q < 500u; ++q)
+	{
+		const Vec3 o = random_point();
+		rays.emplace_back(o, (random_point() - o).normalized());
+	}
+	const std::vector<BVH::RayHit> hits = bvh.intersect(rays);
+	for (uint32 q = 0u; q < rays.size(); ++q)
+	{
+		double best = std::numeric_limits<double>::max();
+		for (const auto& t : triangles_)
+		{
+			double tt;
+			if (geometry::intersection_ray_triangle(rays[q].origin, rays[q].direction, best, t[0], t[1], t[2], tt) && tt < best)
+				best = tt;
+		}
+		ASSERT_EQ(hits[q].hit, best < std::numeric_limits<double>::max());
+		if (hits[q].hit)
+		{
+			EXPECT_NEAR(hits[q].t, best, 1e-9);
+		}
+	}
+}
+
+TEST_F(BVHTest, FacesInSphere)
+{
+	BVH bvh(map_, position_);
+	for (uint32 q = 0u; q < 200u; ++q)
+	{
+		const Vec3 p = random_point();
+		const double r = 0.4;
+		std::vector<uint32> expected;
+		for (uint32 i = 0u; i < triangles_.size(); ++i)
+			if (geometry::squared_distance_point_triangle(p, triangles_[i][0], triangles_[i][1], triangles_[i][2]) <= r * r)
+				expected.push_back(triangle_face_[i]);
+		std::sort(expected.begin(), expected.end());
+		expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+
+		std::vector<uint32> found;
+		for (CMap2::Face f : bvh.faces_in_sphere(p, r))
+			found.push_back(index_of(map_, f));
+		std::sort(found.begin(), found.end());
+		EXPECT_EQ(found, expected);
+	}
+}
+
+TEST_F(BVHTest, Refit)
+{
+	BVH bvh(map_, position_);
+	for (Vec3& p : *position_)
+		p = 1.5 * p + Vec3(1.0, 2.0, 3.0);
+	bvh.refit();
+	BVH rebuilt(map_, position_);
+	for (uint32 q = 0u; q < 200u; ++q)
+	{
+		const Vec3 p = 1.5 * random_point() + Vec3(1.0, 2.0, 3.0);
+		EXPECT_NEAR(bvh.closest_point(p).squared_distance, rebuilt.closest_point(p).squared_distance, 1e-9);
+	}
+}
+
+} // namespace cgogn
@@ -0,0 +1,164 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <cgogn/core/types/cmap/cmap0.h>
+#include <cgogn/core/functions/attributes.h>
+
+#include <cgogn/geometry/types/kd_tree.h>
+
+#include <algorithm>
+#include <random>
+
+namespace cgogn
+{
+
+using Vec3 = Eigen::Vector3d;
+using KDTree = geometry::KDTree<CMap0, Vec3>;
+
+/**
+ * \brief fixture: a flat point cloud with duplicated points, queried by brute force
+ */
+class KDTreeTest : public ::testing::Test
+{
+protected:
+
+	CMap0 map_;
+	Attribute<Vec3>* position_;
+	std::mt19937 rng_;
+
+	KDTreeTest() : rng_(7u)
+	{
+		const uint32 n = 5000u;
+		for (uint32 i = 0u; i < n; ++i)
+			map_.add_dart();
+		position_ = add_attribute<Vec3, CMap0::Vertex>(map_, "position");
+		std::uniform_real_distribution<double> d(0.0, 1.0);
+		for (uint32 i = 0u; i < n; ++i)
+			(*position_)[i] = i % 10u == 9u ? (*position_)[i - 1u] : Vec3(d(rng_), d(rng_), 0.1 * d(rng_));
+	}
+
+	Vec3 random_point()
+	{
+		std::uniform_real_distribution<double> d(-0.1, 1.1);
+		return Vec3(d(rng_), d(rng_), 0.1 * d(rng_));
+	}
+
+	// squared distances from p to all the points, sorted
+	std::vector<double> sorted_squared_distances(const Vec3& p) const
+	{
+		std::vector<double> d2;
+		for (const Vec3& q : *position_)
+			d2.push_back((q - p).squaredNorm());
+		std::sort(d2.begin(), d2.end());
+		return d2;
+	}
+};
+
+TEST_F(KDTreeTest, Nearest)
+{
+	KDTree kd_tree(map_, position_);
+	EXPECT_EQ(kd_tree.nb_points(), map_.nb_darts());
+	for (uint32 q = 0u; q < 200u; ++q)
+	{
+		const Vec3 p = random_point();
+		double d2;
+		const CMap0::Vertex v = kd_tree.nearest(p, &d2);
+		const double expected = sorted_squared_distances(p).front();
+		EXPECT_DOUBLE_EQ(d2, expected);
+		EXPECT_DOUBLE_EQ((value<Vec3>(map_, position_, v) - p).squaredNorm(), expected);
+	}
+}
+
+TEST_F(KDTreeTest, KNearest)
+{
+	KDTree kd_tree(map_, position_, 4u);
+	const uint32 k = 12u;
+	for (uint32 q = 0u; q < 200u; ++q)
+	{
+		const Vec3 p = random_point();
+		std::vector<CMap0::Vertex> neighbors;
+		std::vector<double> d2;
+		kd_tree.knn(p, k, neighbors, &d2);
+		const std::vector<double> expected = sorted_squared_distances(p);
+		ASSERT_EQ(neighbors.size(), k);
+		for (uint32 i = 0u; i < k; ++i)
+		{
+			EXPECT_DOUBLE_EQ(d2[i], expected[i]);
+			EXPECT_DOUBLE_EQ((value<Vec3>(map_, position_, neighbors[i]) - p).squaredNorm(), expected[i]);
+		}
+	}
+}
+
+TEST_F(KDTreeTest, BatchedKNearest)
+{
+	KDTree kd_tree(map_, position_);
+	const uint32 k = 8u;
+	std::vector<Vec3> points;
+	for (uint32 q = 0u; q < 300u; ++q)
+		points.push_back(random_point());
+	std::vector<CMap0::Vertex> neighbors;
+	kd_tree.knn(points, k, neighbors);
+	ASSERT_EQ(neighbors.size(), points.size() * k);
+	for (uint32 q = 0u; q < points.size(); ++q)
+	{
+		const std::vector<double> expected = sorted_squared_distances(points[q]);
+		for (uint32 i = 0u; i < k; ++i)
+			EXPECT_DOUBLE_EQ((value<Vec3>(map_, position_, neighbors[q * k + i]) - points[q]).squaredNorm(), expected[i]);
+	}
+}
+
+TEST_F(KDTreeTest, Radius)
+{
+	KDTree kd_tree(map_, position_);
+	const double r = 0.05;
+	for (uint32 q = 0u; q < 200u; ++q)
+	{
+		const Vec3 p = random_point();
+		std::vector<CMap0::Vertex> neighbors;
+		std::vector<double> d2;
+		kd_tree.radius(p, r, neighbors, &d2);
+		const std::vector<double> all = sorted_squared_distances(p);
+		const std::vector<double> expected(all.begin(), std::upper_bound(all.begin(), all.end(), r * r));
+		EXPECT_EQ(d2, expected);
+	}
+}
+
+TEST_F(KDTreeTest, MorePointsThanTheTree)
+{
+	CMap0 small;
+	for (uint32 i = 0u; i < 3u; ++i)
+		small.add_dart();
+	Attribute<Vec3>* position = add_attribute<Vec3, CMap0::Vertex>(small, "position");
+	for (uint32 i = 0u; i < 3u; ++i)
+		(*position)[i] = Vec3(double(i), 0.0, 0.0);
+	KDTree kd_tree(small, position);
+	std::vector<CMap0::Vertex> neighbors;
+	std::vector<double> d2;
+	kd_tree.knn(Vec3(-1.0, 0.0, 0.0), 5u, neighbors, &d2);
+	ASSERT_EQ(neighbors.size(), 3u);
+	EXPECT_EQ(d2, std::vector<double>({1.0, 4.0, 9.0}));
+}
+
+} // namespace cgogn
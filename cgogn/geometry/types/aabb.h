@@ -0,0 +1,145 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_TYPES_AABB_H_
+#define CGOGN_GEOMETRY_TYPES_AABB_H_
+
+#include <cgogn/core/utils/numerics.h>
+
+#include <cgogn/geometry/types/vector_traits.h>
+
+#include <limits>
+#include <algorithm>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * \brief axis-aligned bounding box. A default constructed box is empty (min > max) and grows with extend.
+ */
+template <typename VEC>
+struct AABB
+{
+	using Scalar = typename vector_traits<VEC>::Scalar;
+	static const uint32 DIM = uint32(vector_traits<VEC>::SIZE);
+
+	VEC min;
+	VEC max;
+
+	AABB()
+	{
+		for (uint32 i = 0u; i < DIM; ++i)
+		{
+			min[i] = std::numeric_limits<Scalar>::max();
+			max[i] = std::numeric_limits<Scalar>::lowest();
+		}
+	}
+
+	AABB(const VEC& mi, const VEC& ma) : min(mi), max(ma)
+	{}
+
+	bool empty() const { return min[0] > max[0]; }
+
+	void extend(const VEC& p)
+	{
+		for (uint32 i = 0u; i < DIM; ++i)
+		{
+			min[i] = std::min(min[i], p[i]);
+			max[i] = std::max(max[i], p[i]);
+		}
+	}
+
+	void extend(const AABB& bb)
+	{
+		for (uint32 i = 0u; i < DIM; ++i)
+		{
+			min[i] = std::min(min[i], bb.min[i]);
+			max[i] = std::max(max[i], bb.max[i]);
+		}
+	}
+
+	VEC center() const { return (min + max) / Scalar(2); }
+	VEC diagonal() const { return max - min; }
+
+	/**
+	 * \brief index of the axis of largest extent
+	 */
+	uint32 largest_axis() const
+	{
+		uint32 axis = 0u;
+		for (uint32 i = 1u; i < DIM; ++i)
+			if (max[i] - min[i] > max[axis] - min[axis])
+				axis = i;
+		return axis;
+	}
+
+	/**
+	 * \brief half of the area of the surface of the box (3D), used by the surface area heuristic
+	 */
+	Scalar half_area() const
+	{
+		if (empty())
+			return Scalar(0);
+		const VEC d = max - min;
+		return d[0] * d[1] + d[1] * d[2] + d[2] * d[0];
+	}
+
+	bool contains(const VEC& p) const
+	{
+		for (uint32 i = 0u; i < DIM; ++i)
+			if (p[i] < min[i] || p[i] > max[i])
+				return false;
+		return true;
+	}
+
+	bool intersects(const AABB& bb) const
+	{
+		for (uint32 i = 0u; i < DIM; ++i)
+			if (bb.max[i] < min[i] || bb.min[i] > max[i])
+				return false;
+		return true;
+	}
+
+	/**
+	 * \brief squared distance from p to the box (0 if p is inside)
+	 */
+	Scalar squared_distance(const VEC& p) const
+	{
+		Scalar d2 = 0;
+		for (uint32 i = 0u; i < DIM; ++i)
+		{
+			const Scalar d = p[i] < min[i] ? min[i] - p[i] : (p[i] > max[i] ? p[i] - max[i] : Scalar(0));
+			d2 += d * d;
+		}
+		return d2;
+	}
+};
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_TYPES_AABB_H_
@@ -0,0 +1,179 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_TYPES_ATTRIBUTE_STATISTICS_H_
+#define CGOGN_GEOMETRY_TYPES_ATTRIBUTE_STATISTICS_H_
+
+#include <cgogn/core/types/cmap/attributes.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+#include <cgogn/geometry/types/vector_traits.h>
+#include <cgogn/geometry/types/aabb.h>
+#include <cgogn/geometry/functions/vector_ops.h>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * \brief cache of the statistics (bounding box, mean) of the values of a vector attribute.
+ *
+ * The statistics are computed over all the lines of the attribute with a (deterministic) parallel reduction,
+ * and recomputed lazily when the modification counter of the attribute changed since the last computation.
+ * When a few values are changed, value_changed updates the statistics incrementally instead: the mean is updated
+ * exactly and the box grows; it is only recomputed if an old value was on its boundary.
+ *
+ * An incremental update must follow this order:
+ *  1. value_changed(old_value, new_value) for each modified value, while the statistics are up to date
+ *  2. notify_modification() on the attribute (once)
+ *  3. modification_notified()
+ * If the modification counter of the attribute moved by more than one, or if its size changed (e.g. lines were
+ * added), some modifications were not given to value_changed: the statistics are then recomputed.
+ */
+template <typename VEC>
+class AttributeStatistics
+{
+public:
+
+	using Scalar = typename vector_traits<VEC>::Scalar;
+
+private:
+
+	struct Partial
+	{
+		AABB<VEC> bb;
+		VEC sum;
+	};
+
+	const Attribute<VEC>* attribute_;
+	uint64 modification_count_;
+	bool valid_;
+
+	AABB<VEC> bb_;
+	VEC sum_;
+	uint32 count_;
+
+	void compute()
+	{
+		count_ = attribute_->size();
+		const Attribute<VEC>& a = *attribute_;
+		Partial init;
+		set_zero(init.sum);
+		const Partial p = parallel_transform_reduce(count_, init,
+			[] (Partial x, const Partial& y) -> Partial { x.bb.extend(y.bb); x.sum += y.sum; return x; },
+			[&] (uint32 i) -> Partial { Partial r; r.bb = AABB<VEC>(a[i], a[i]); r.sum = a[i]; return r; });
+		bb_ = p.bb;
+		sum_ = p.sum;
+		modification_count_ = attribute_->modification_count();
+		valid_ = true;
+	}
+
+	bool on_boundary(const VEC& v) const
+	{
+		for (uint32 i = 0u; i < AABB<VEC>::DIM; ++i)
+			if (v[i] <= bb_.min[i] || v[i] >= bb_.max[i])
+				return true;
+		return false;
+	}
+
+public:
+
+	AttributeStatistics(const Attribute<VEC>* attribute) :
+		attribute_(attribute),
+		modification_count_(0u),
+		valid_(false),
+		count_(0u)
+	{}
+
+	/**
+	 * \brief true if the cached statistics correspond to the current values of the attribute
+	 */
+	bool is_valid() const
+	{
+		return valid_ && modification_count_ == attribute_->modification_count() && count_ == attribute_->size();
+	}
+
+	void invalidate() { valid_ = false; }
+
+	void update()
+	{
+		if (!is_valid())
+			compute();
+	}
+
+	const AABB<VEC>& bounding_box() { update(); return bb_; }
+	const VEC& min() { update(); return bb_.min; }
+	const VEC& max() { update(); return bb_.max; }
+
+	VEC mean()
+	{
+		update();
+		if (count_ == 0u)
+		{
+			VEC z;
+			set_zero(z);
+			return z;
+		}
+		return sum_ / Scalar(count_);
+	}
+
+	/**
+	 * \brief incremental update when one value of the attribute changed from old_value to new_value.
+	 * It must be called for each modified value, before notify_modification is called on the attribute:
+	 * the update is only done if the statistics were up to date, otherwise they are recomputed at the next query.
+	 */
+	void value_changed(const VEC& old_value, const VEC& new_value)
+	{
+		if (!is_valid())
+		{
+			valid_ = false;
+			return;
+		}
+		sum_ += new_value - old_value;
+		if (on_boundary(old_value))
+			valid_ = false;
+		else
+			bb_.extend(new_value);
+	}
+
+	/**
+	 * \brief to be called right after notify_modification on the attribute when all the modified values
+	 * were given to value_changed: the statistics then stay up to date.
+	 * The statistics are recomputed if other modifications happened since they were up to date.
+	 */
+	void modification_notified()
+	{
+		if (valid_ && modification_count_ + 1u == attribute_->modification_count() && count_ == attribute_->size())
+			modification_count_ = attribute_->modification_count();
+		else
+			compute();
+	}
+};
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_TYPES_ATTRIBUTE_STATISTICS_H_
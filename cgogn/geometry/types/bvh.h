@@ -0,0 +1,752 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_TYPES_BVH_H_
+#define CGOGN_GEOMETRY_TYPES_BVH_H_
+
+#include <cgogn/core/types/mesh_traits.h>
+#include <cgogn/core/functions/traversals/global.h>
+#include <cgogn/core/functions/traversals/vertex.h>
+#include <cgogn/core/functions/attributes.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+#include <cgogn/geometry/types/vector_traits.h>
+#include <cgogn/geometry/types/aabb.h>
+#include <cgogn/geometry/functions/distance.h>
+#include <cgogn/geometry/functions/intersection.h>
+
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <limits>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * \brief bounding volume hierarchy over the faces of a surface mesh (or mesh view).
+ *
+ * The faces are split into triangles (fans), that are organized in a binary tree of axis-aligned boxes
+ * built top-down with the surface area heuristic evaluated on NB_BINS bins. The top levels of the tree are split
+ * with parallel binning; the subtrees below PARALLEL_BUILD_SIZE triangles are then built in parallel.
+ *
+ * The positions are read from the given vertex attribute: after the positions changed (but not the topology),
+ * refit() recomputes the boxes bottom-up without changing the tree.
+ *
+ * All the queries are const and thread-safe; the batched versions run over the threads of the pool.
+ */
+template <typename MESH, typename VEC3>
+class BVH
+{
+public:
+
+	using Scalar = typename vector_traits<VEC3>::Scalar;
+	using Vertex = typename mesh_traits<MESH>::Vertex;
+	using Face = typename mesh_traits<MESH>::Face;
+	using Box = AABB<VEC3>;
+
+	static const uint32 NB_BINS = 16u;
+	static const uint32 MAX_LEAF_SIZE = 16u;
+	static const uint32 PARALLEL_BUILD_SIZE = 16384u;
+
+	/**
+	 * \brief ray origin + t direction, t in [0, t_max]
+	 */
+	struct Ray
+	{
+		VEC3 origin;
+		VEC3 direction;
+		Scalar t_max;
+
+		Ray() : t_max(std::numeric_limits<Scalar>::max()) {}
+		Ray(const VEC3& o, const VEC3& d, Scalar tm = std::numeric_limits<Scalar>::max()) : origin(o), direction(d), t_max(tm) {}
+	};
+
+	struct RayHit
+	{
+		bool hit;
+		Face face;
+		Scalar t;
+		VEC3 point;
+
+		RayHit() : hit(false), t(std::numeric_limits<Scalar>::max()) {}
+	};
+
+	struct ClosestPoint
+	{
+		bool found;
+		Face face;
+		VEC3 point;
+		Scalar squared_distance;
+
+		ClosestPoint() : found(false), squared_distance(std::numeric_limits<Scalar>::max()) {}
+	};
+
+private:
+
+	// leaf: count > 0 and the triangles are [index, index + count[; inner node: the children are index and index + 1
+	struct Node
+	{
+		Box bb;
+		uint32 index;
+		uint32 count;
+
+		bool is_leaf() const { return count > 0u; }
+	};
+
+	struct Triangle
+	{
+		std::array<uint32, 3> vertex; // attribute indices
+		uint32 face; // index in faces_
+	};
+
+	struct Bin
+	{
+		Box bb;
+		uint32 count;
+		Bin() : count(0u) {}
+	};
+	using Bins = std::array<Bin, NB_BINS>;
+
+	struct BuildTask
+	{
+		uint32 node;
+		uint32 begin;
+		uint32 end;
+		uint32 depth;
+	};
+
+	const MESH& m_;
+	const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position_;
+	uint32 leaf_size_;
+
+	std::vector<Face> faces_;
+	std::vector<Triangle> triangles_;
+	std::vector<Node> nodes_;
+	std::vector<std::vector<uint32>> levels_; // inner nodes by depth, for the bottom-up refit
+
+	// build workspace
+	std::vector<uint32> primitives_;
+	std::vector<Box> triangle_bb_;
+	std::vector<VEC3> centroids_;
+
+	const VEC3& position(uint32 index) const { return (*vertex_position_)[index]; }
+
+	Box triangle_box(const Triangle& t) const
+	{
+		Box bb;
+		for (uint32 k = 0u; k < 3u; ++k)
+			bb.extend(position(t.vertex[k]));
+		return bb;
+	}
+
+	void build();
+	Box range_box(uint32 begin, uint32 end, bool parallel) const;
+	bool split(uint32 begin, uint32 end, const Box& bb, bool parallel, uint32& mid);
+	void build_subtree(const BuildTask& root, std::vector<Node>& nodes, std::vector<uint32>& depths);
+
+public:
+
+	BVH(
+		const MESH& m,
+		const typename mesh_traits<MESH>::template Attribute<VEC3>* vertex_position,
+		uint32 leaf_size = 4u
+	) :
+		m_(m),
+		vertex_position_(vertex_position),
+		leaf_size_(std::max(1u, std::min(leaf_size, MAX_LEAF_SIZE)))
+	{
+		build();
+	}
+
+	BVH(const BVH&) = delete;
+	BVH& operator=(const BVH&) = delete;
+
+	uint32 nb_faces() const { return uint32(faces_.size()); }
+	uint32 nb_triangles() const { return uint32(triangles_.size()); }
+	uint32 nb_nodes() const { return uint32(nodes_.size()); }
+
+	Box bounding_box() const { return nodes_.empty() ? Box() : nodes_[0].bb; }
+
+	/**
+	 * \brief recomputes the boxes of the nodes from the current vertex positions (the tree is not rebuilt)
+	 */
+	void refit();
+
+	/**
+	 * \brief first intersection of the ray with the faces
+	 */
+	RayHit intersect(const Ray& ray) const;
+
+	/**
+	 * \brief closest point to p on the faces, among the points closer than max_distance
+	 */
+	ClosestPoint closest_point(const VEC3& p, Scalar max_distance = std::numeric_limits<Scalar>::max()) const;
+
+	/**
+	 * \brief faces that overlap the box bb (each face is reported once)
+	 */
+	std::vector<Face> faces_in_box(const Box& bb) const;
+
+	/**
+	 * \brief faces that overlap the sphere (each face is reported once)
+	 */
+	std::vector<Face> faces_in_sphere(const VEC3& center, Scalar radius) const;
+
+	// batched queries (parallel)
+
+	std::vector<RayHit> intersect(const std::vector<Ray>& rays) const
+	{
+		std::vector<RayHit> hits(rays.size());
+		parallel_for(uint32(rays.size()), [&] (uint32 i) { hits[i] = intersect(rays[i]); }, 64u);
+		return hits;
+	}
+
+	std::vector<ClosestPoint> closest_point(const std::vector<VEC3>& points, Scalar max_distance = std::numeric_limits<Scalar>::max()) const
+	{
+		std::vector<ClosestPoint> res(points.size());
+		parallel_for(uint32(points.size()), [&] (uint32 i) { res[i] = closest_point(points[i], max_distance); }, 64u);
+		return res;
+	}
+
+	std::vector<std::vector<Face>> faces_in_box(const std::vector<Box>& boxes) const
+	{
+		std::vector<std::vector<Face>> res(boxes.size());
+		parallel_for(uint32(boxes.size()), [&] (uint32 i) { res[i] = faces_in_box(boxes[i]); }, 64u);
+		return res;
+	}
+
+	std::vector<std::vector<Face>> faces_in_sphere(const std::vector<VEC3>& centers, Scalar radius) const
+	{
+		std::vector<std::vector<Face>> res(centers.size());
+		parallel_for(uint32(centers.size()), [&] (uint32 i) { res[i] = faces_in_sphere(centers[i], radius); }, 64u);
+		return res;
+	}
+
+private:
+
+	std::vector<Face> collect_faces(std::vector<uint32>& face_indices) const
+	{
+		std::sort(face_indices.begin(), face_indices.end());
+		face_indices.erase(std::unique(face_indices.begin(), face_indices.end()), face_indices.end());
+		std::vector<Face> res;
+		res.reserve(face_indices.size());
+		for (uint32 f : face_indices)
+			res.push_back(faces_[f]);
+		return res;
+	}
+};
+
+template <typename MESH, typename VEC3>
+const uint32 BVH<MESH, VEC3>::NB_BINS;
+template <typename MESH, typename VEC3>
+const uint32 BVH<MESH, VEC3>::MAX_LEAF_SIZE;
+template <typename MESH, typename VEC3>
+const uint32 BVH<MESH, VEC3>::PARALLEL_BUILD_SIZE;
+
+template <typename MESH, typename VEC3>
+void BVH<MESH, VEC3>::build()
+{
+	// markers are not thread-safe: faces are gathered sequentially and then processed in parallel
+	foreach_cell(m_, [&] (Face f) -> bool { faces_.push_back(f); return true; });
+	const uint32 nbf = nb_faces();
+
+	// faces are split into fans of triangles
+	std::vector<uint32> offsets(nbf + 1u);
+	offsets[0] = 0u;
+	parallel_for(nbf, [&] (uint32 f)
+	{
+		uint32 count = 0u;
+		foreach_incident_vertex(m_, faces_[f], [&] (Vertex) -> bool { ++count; return true; });
+		offsets[f + 1u] = count >= 3u ? count - 2u : 0u;
+	});
+	for (uint32 f = 0u; f < nbf; ++f)
+		offsets[f + 1u] += offsets[f];
+	const uint32 nbt = offsets[nbf];
+	if (nbt == 0u)
+		return;
+
+	std::vector<Triangle> triangles(nbt);
+	parallel_for(nbf, [&] (uint32 f)
+	{
+		uint32 t = offsets[f];
+		uint32 k = 0u;
+		uint32 first = INVALID_INDEX;
+		uint32 prev = INVALID_INDEX;
+		foreach_incident_vertex(m_, faces_[f], [&] (Vertex v) -> bool
+		{
+			const uint32 index = index_of(m_, v);
+			if (k == 0u)
+				first = index;
+			else if (k >= 2u)
+				triangles[t++] = Triangle{ { { first, prev, index } }, f };
+			prev = index;
+			++k;
+			return true;
+		});
+	});
+
+	triangle_bb_.resize(nbt);
+	centroids_.resize(nbt);
+	primitives_.resize(nbt);
+	parallel_for(nbt, [&] (uint32 t)
+	{
+		triangle_bb_[t] = triangle_box(triangles[t]);
+		centroids_[t] = triangle_bb_[t].center();
+		primitives_[t] = t;
+	});
+
+	// top levels: parallel binning of the large nodes
+	nodes_.push_back(Node{ range_box(0u, nbt, true), 0u, nbt });
+	std::vector<BuildTask> stack = { BuildTask{ 0u, 0u, nbt, 0u } };
+	std::vector<BuildTask> frontier;
+	std::vector<uint32> depths = { 0u };
+	while (!stack.empty())
+	{
+		BuildTask task = stack.back();
+		stack.pop_back();
+		if (task.end - task.begin <= PARALLEL_BUILD_SIZE)
+		{
+			frontier.push_back(task);
+			continue;
+		}
+		uint32 mid;
+		if (!split(task.begin, task.end, nodes_[task.node].bb, true, mid))
+			continue;
+		const uint32 left = uint32(nodes_.size());
+		nodes_.push_back(Node{ range_box(task.begin, mid, true), task.begin, mid - task.begin });
+		nodes_.push_back(Node{ range_box(mid, task.end, true), mid, task.end - mid });
+		depths.push_back(task.depth + 1u);
+		depths.push_back(task.depth + 1u);
+		nodes_[task.node].index = left;
+		nodes_[task.node].count = 0u;
+		stack.push_back(BuildTask{ left, task.begin, mid, task.depth + 1u });
+		stack.push_back(BuildTask{ left + 1u, mid, task.end, task.depth + 1u });
+	}
+
+	// subtrees of the frontier are built in parallel and then appended to the tree
+	std::vector<std::vector<Node>> subtrees(frontier.size());
+	std::vector<std::vector<uint32>> subtree_depths(frontier.size());
+	parallel_for(uint32(frontier.size()), [&] (uint32 i)
+	{
+		build_subtree(frontier[i], subtrees[i], subtree_depths[i]);
+	}, 1u);
+	for (uint32 i = 0u; i < uint32(frontier.size()); ++i)
+	{
+		const std::vector<Node>& sub = subtrees[i];
+		// local node 0 is the root of the subtree (already in the tree), the others are appended at offset - 1
+		const uint32 offset = uint32(nodes_.size()) - 1u;
+		auto relocate = [&] (Node n) -> Node
+		{
+			if (!n.is_leaf())
+				n.index += offset;
+			return n;
+		};
+		nodes_[frontier[i].node] = relocate(sub[0]);
+		for (uint32 j = 1u; j < uint32(sub.size()); ++j)
+		{
+			nodes_.push_back(relocate(sub[j]));
+			depths.push_back(subtree_depths[i][j]);
+		}
+	}
+
+	// the triangles are stored in the order of the leaves
+	triangles_.resize(nbt);
+	parallel_for(nbt, [&] (uint32 t) { triangles_[t] = triangles[primitives_[t]]; });
+
+	for (uint32 n = 0u; n < nb_nodes(); ++n)
+	{
+		if (nodes_[n].is_leaf())
+			continue;
+		if (depths[n] >= levels_.size())
+			levels_.resize(depths[n] + 1u);
+		levels_[depths[n]].push_back(n);
+	}
+
+	std::vector<uint32>().swap(primitives_);
+	std::vector<Box>().swap(triangle_bb_);
+	std::vector<VEC3>().swap(centroids_);
+}
+
+template <typename MESH, typename VEC3>
+typename BVH<MESH, VEC3>::Box BVH<MESH, VEC3>::range_box(uint32 begin, uint32 end, bool parallel) const
+{
+	auto transform = [&] (uint32 i) -> Box { return triangle_bb_[primitives_[begin + i]]; };
+	auto merge = [] (Box a, const Box& b) -> Box { a.extend(b); return a; };
+	if (parallel)
+		return parallel_transform_reduce(end - begin, Box(), merge, transform);
+	Box bb;
+	for (uint32 i = begin; i < end; ++i)
+		bb.extend(triangle_bb_[primitives_[i]]);
+	return bb;
+}
+
+template <typename MESH, typename VEC3>
+bool BVH<MESH, VEC3>::split(uint32 begin, uint32 end, const Box& bb, bool parallel, uint32& mid)
+{
+	const uint32 n = end - begin;
+	if (n <= leaf_size_)
+		return false;
+
+	// bounds of the centroids
+	Box cb;
+	auto merge_box = [] (Box a, const Box& b) -> Box { a.extend(b); return a; };
+	if (parallel)
+		cb = parallel_transform_reduce(n, Box(), merge_box, [&] (uint32 i) -> Box
+		{
+			const VEC3& c = centroids_[primitives_[begin + i]];
+			return Box(c, c);
+		});
+	else
+		for (uint32 i = begin; i < end; ++i)
+			cb.extend(centroids_[primitives_[i]]);
+
+	const uint32 axis = cb.largest_axis();
+	const Scalar extent = cb.max[axis] - cb.min[axis];
+	auto median_split = [&] () -> bool
+	{
+		if (n <= MAX_LEAF_SIZE)
+			return false;
+		mid = begin + n / 2u;
+		std::nth_element(primitives_.begin() + begin, primitives_.begin() + mid, primitives_.begin() + end,
+			[&] (uint32 a, uint32 b) { return centroids_[a][axis] < centroids_[b][axis]; });
+		return true;
+	};
+	if (!(extent > Scalar(0)))
+		return median_split();
+
+	// binning
+	const Scalar scale = Scalar(NB_BINS) / extent;
+	auto bin_of = [&] (uint32 t) -> uint32
+	{
+		return std::min(NB_BINS - 1u, uint32((centroids_[t][axis] - cb.min[axis]) * scale));
+	};
+	auto fill_bins = [&] (Bins& bins, uint32 b, uint32 e)
+	{
+		for (uint32 i = b; i < e; ++i)
+		{
+			const uint32 t = primitives_[i];
+			Bin& bin = bins[bin_of(t)];
+			bin.bb.extend(triangle_bb_[t]);
+			++bin.count;
+		}
+	};
+	Bins bins;
+	if (parallel)
+	{
+		std::vector<Bins> partials(nb_chunks(n));
+		parallel_foreach_chunk(n, [&] (uint32 c, uint32 b, uint32 e) { fill_bins(partials[c], begin + b, begin + e); });
+		for (const Bins& p : partials)
+			for (uint32 k = 0u; k < NB_BINS; ++k)
+			{
+				bins[k].bb.extend(p[k].bb);
+				bins[k].count += p[k].count;
+			}
+	}
+	else
+		fill_bins(bins, begin, end);
+
+	// sweep: cost of the splits between bins k and k + 1
+	std::array<Scalar, NB_BINS> right_cost;
+	Box acc;
+	uint32 count = 0u;
+	for (uint32 k = NB_BINS - 1u; k > 0u; --k)
+	{
+		acc.extend(bins[k].bb);
+		count += bins[k].count;
+		right_cost[k - 1u] = count > 0u ? acc.half_area() * Scalar(count) : std::numeric_limits<Scalar>::max();
+	}
+	Scalar best_cost = std::numeric_limits<Scalar>::max();
+	uint32 best = NB_BINS;
+	acc = Box();
+	count = 0u;
+	for (uint32 k = 0u; k + 1u < NB_BINS; ++k)
+	{
+		acc.extend(bins[k].bb);
+		count += bins[k].count;
+		if (count == 0u || count == n)
+			continue;
+		const Scalar cost = acc.half_area() * Scalar(count) + right_cost[k];
+		if (cost < best_cost)
+		{
+			best_cost = cost;
+			best = k;
+		}
+	}
+	if (best == NB_BINS)
+		return median_split();
+
+	// traversal cost of 1 against intersection cost of 1 per triangle
+	const Scalar area = bb.half_area();
+	const Scalar split_cost = area > Scalar(0) ? Scalar(1) + best_cost / area : Scalar(1);
+	if (split_cost >= Scalar(n) && n <= MAX_LEAF_SIZE)
+		return false;
+
+	mid = uint32(std::partition(primitives_.begin() + begin, primitives_.begin() + end,
+		[&] (uint32 t) { return bin_of(t) <= best; }) - primitives_.begin());
+	return true;
+}
+
+template <typename MESH, typename VEC3>
+void BVH<MESH, VEC3>::build_subtree(const BuildTask& root, std::vector<Node>& nodes, std::vector<uint32>& depths)
+{
+	nodes.push_back(Node{ nodes_[root.node].bb, root.begin, root.end - root.begin });
+	depths.push_back(root.depth);
+	std::vector<BuildTask> stack = { BuildTask{ 0u, root.begin, root.end, root.depth } };
+	while (!stack.empty())
+	{
+		BuildTask task = stack.back();
+		stack.pop_back();
+		uint32 mid;
+		if (!split(task.begin, task.end, nodes[task.node].bb, false, mid))
+			continue;
+		const uint32 left = uint32(nodes.size());
+		nodes.push_back(Node{ range_box(task.begin, mid, false), task.begin, mid - task.begin });
+		nodes.push_back(Node{ range_box(mid, task.end, false), mid, task.end - mid });
+		depths.push_back(task.depth + 1u);
+		depths.push_back(task.depth + 1u);
+		nodes[task.node].index = left;
+		nodes[task.node].count = 0u;
+		stack.push_back(BuildTask{ left, task.begin, mid, task.depth + 1u });
+		stack.push_back(BuildTask{ left + 1u, mid, task.end, task.depth + 1u });
+	}
+}
+
+template <typename MESH, typename VEC3>
+void BVH<MESH, VEC3>::refit()
+{
+	if (nodes_.empty())
+		return;
+	parallel_for(nb_nodes(), [&] (uint32 n)
+	{
+		Node& node = nodes_[n];
+		if (!node.is_leaf())
+			return;
+		node.bb = Box();
+		for (uint32 t = node.index; t < node.index + node.count; ++t)
+			node.bb.extend(triangle_box(triangles_[t]));
+	});
+	for (uint32 d = uint32(levels_.size()); d-- > 0u;)
+	{
+		const std::vector<uint32>& level = levels_[d];
+		parallel_for(uint32(level.size()), [&] (uint32 i)
+		{
+			Node& node = nodes_[level[i]];
+			node.bb = nodes_[node.index].bb;
+			node.bb.extend(nodes_[node.index + 1u].bb);
+		});
+	}
+}
+
+template <typename MESH, typename VEC3>
+typename BVH<MESH, VEC3>::RayHit BVH<MESH, VEC3>::intersect(const Ray& ray) const
+{
+	RayHit hit;
+	if (nodes_.empty())
+		return hit;
+
+	VEC3 inv_direction;
+	for (uint32 i = 0u; i < 3u; ++i)
+		inv_direction[i] = Scalar(1) / ray.direction[i];
+
+	Scalar t_max = ray.t_max;
+	uint32 hit_triangle = INVALID_INDEX;
+	Scalar t_entry;
+	if (!intersection_ray_aabb(ray.origin, inv_direction, t_max, nodes_[0].bb, t_entry))
+		return hit;
+
+	std::vector<uint32> stack;
+	stack.reserve(64u);
+	stack.push_back(0u);
+	while (!stack.empty())
+	{
+		const Node& node = nodes_[stack.back()];
+		stack.pop_back();
+		if (node.is_leaf())
+		{
+			for (uint32 t = node.index; t < node.index + node.count; ++t)
+			{
+				const Triangle& tri = triangles_[t];
+				Scalar tt;
+				if (intersection_ray_triangle(ray.origin, ray.direction, t_max,
+						position(tri.vertex[0]), position(tri.vertex[1]), position(tri.vertex[2]), tt))
+				{
+					t_max = tt;
+					hit_triangle = t;
+				}
+			}
+			continue;
+		}
+		// the nearest child is visited first
+		Scalar t0, t1;
+		const bool hit0 = intersection_ray_aabb(ray.origin, inv_direction, t_max, nodes_[node.index].bb, t0);
+		const bool hit1 = intersection_ray_aabb(ray.origin, inv_direction, t_max, nodes_[node.index + 1u].bb, t1);
+		if (hit0 && hit1)
+		{
+			const bool first_nearest = t0 <= t1;
+			stack.push_back(first_nearest ? node.index + 1u : node.index);
+			stack.push_back(first_nearest ? node.index : node.index + 1u);
+		}
+		else if (hit0)
+			stack.push_back(node.index);
+		else if (hit1)
+			stack.push_back(node.index + 1u);
+	}
+
+	if (hit_triangle != INVALID_INDEX)
+	{
+		hit.hit = true;
+		hit.face = faces_[triangles_[hit_triangle].face];
+		hit.t = t_max;
+		hit.point = ray.origin + ray.direction * t_max;
+	}
+	return hit;
+}
+
+template <typename MESH, typename VEC3>
+typename BVH<MESH, VEC3>::ClosestPoint BVH<MESH, VEC3>::closest_point(const VEC3& p, Scalar max_distance) const
+{
+	ClosestPoint res;
+	if (nodes_.empty())
+		return res;
+
+	Scalar best = max_distance < std::numeric_limits<Scalar>::max() ? max_distance * max_distance : max_distance;
+	uint32 best_triangle = INVALID_INDEX;
+	VEC3 best_point;
+
+	std::vector<uint32> stack;
+	stack.reserve(64u);
+	stack.push_back(0u);
+	while (!stack.empty())
+	{
+		const Node& node = nodes_[stack.back()];
+		stack.pop_back();
+		if (node.bb.squared_distance(p) >= best)
+			continue;
+		if (node.is_leaf())
+		{
+			for (uint32 t = node.index; t < node.index + node.count; ++t)
+			{
+				const Triangle& tri = triangles_[t];
+				const VEC3 q = closest_point_in_triangle(p, position(tri.vertex[0]), position(tri.vertex[1]), position(tri.vertex[2]));
+				const Scalar d2 = (q - p).squaredNorm();
+				if (d2 < best)
+				{
+					best = d2;
+					best_triangle = t;
+					best_point = q;
+				}
+			}
+			continue;
+		}
+		// the nearest child is visited first
+		const Scalar d0 = nodes_[node.index].bb.squared_distance(p);
+		const Scalar d1 = nodes_[node.index + 1u].bb.squared_distance(p);
+		const bool first_nearest = d0 <= d1;
+		stack.push_back(first_nearest ? node.index + 1u : node.index);
+		stack.push_back(first_nearest ? node.index : node.index + 1u);
+	}
+
+	if (best_triangle != INVALID_INDEX)
+	{
+		res.found = true;
+		res.face = faces_[triangles_[best_triangle].face];
+		res.point = best_point;
+		res.squared_distance = best;
+	}
+	return res;
+}
+
+template <typename MESH, typename VEC3>
+std::vector<typename BVH<MESH, VEC3>::Face> BVH<MESH, VEC3>::faces_in_box(const Box& bb) const
+{
+	std::vector<uint32> face_indices;
+	if (nodes_.empty())
+		return {};
+
+	std::vector<uint32> stack;
+	stack.reserve(64u);
+	stack.push_back(0u);
+	while (!stack.empty())
+	{
+		const Node& node = nodes_[stack.back()];
+		stack.pop_back();
+		if (!node.bb.intersects(bb))
+			continue;
+		if (node.is_leaf())
+		{
+			for (uint32 t = node.index; t < node.index + node.count; ++t)
+			{
+				const Triangle& tri = triangles_[t];
+				if (intersection_triangle_aabb(position(tri.vertex[0]), position(tri.vertex[1]), position(tri.vertex[2]), bb))
+					face_indices.push_back(tri.face);
+			}
+			continue;
+		}
+		stack.push_back(node.index + 1u);
+		stack.push_back(node.index);
+	}
+	return collect_faces(face_indices);
+}
+
+template <typename MESH, typename VEC3>
+std::vector<typename BVH<MESH, VEC3>::Face> BVH<MESH, VEC3>::faces_in_sphere(const VEC3& center, Scalar radius) const
+{
+	std::vector<uint32> face_indices;
+	if (nodes_.empty())
+		return {};
+
+	const Scalar r2 = radius * radius;
+	std::vector<uint32> stack;
+	stack.reserve(64u);
+	stack.push_back(0u);
+	while (!stack.empty())
+	{
+		const Node& node = nodes_[stack.back()];
+		stack.pop_back();
+		if (node.bb.squared_distance(center) > r2)
+			continue;
+		if (node.is_leaf())
+		{
+			for (uint32 t = node.index; t < node.index + node.count; ++t)
+			{
+				const Triangle& tri = triangles_[t];
+				if (squared_distance_point_triangle(center, position(tri.vertex[0]), position(tri.vertex[1]), position(tri.vertex[2])) <= r2)
+					face_indices.push_back(tri.face);
+			}
+			continue;
+		}
+		stack.push_back(node.index + 1u);
+		stack.push_back(node.index);
+	}
+	return collect_faces(face_indices);
+}
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_TYPES_BVH_H_
@@ -0,0 +1,368 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_GEOMETRY_TYPES_KD_TREE_H_
+#define CGOGN_GEOMETRY_TYPES_KD_TREE_H_
+
+#include <cgogn/core/types/mesh_traits.h>
+#include <cgogn/core/functions/traversals/global.h>
+#include <cgogn/core/functions/attributes.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+#include <cgogn/geometry/types/vector_traits.h>
+#include <cgogn/geometry/types/aabb.h>
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+namespace cgogn
+{
+
+namespace geometry
+{
+
+/**
+ * \brief k-d tree over the positions of the vertices of a mesh (or mesh view), e.g. a point cloud (CMap0).
+ *
+ * The tree is balanced: the points of a node are split at their median along the axis of largest extent,
+ * so that the nodes are stored implicitly as a heap (children of node i are 2i+1 and 2i+2) and only the
+ * splitting planes are stored. The nodes of a level are split in parallel.
+ *
+ * The positions are copied (in tree order) by the constructor: the tree must be rebuilt when they change.
+ * All the queries are const and thread-safe; the batched versions run over the threads of the pool.
+ */
+template <typename MESH, typename VEC>
+class KDTree
+{
+public:
+
+	using Scalar = typename vector_traits<VEC>::Scalar;
+	using Vertex = typename mesh_traits<MESH>::Vertex;
+
+	static const uint32 DIM = uint32(vector_traits<VEC>::SIZE);
+
+private:
+
+	struct Split
+	{
+		Scalar value;
+		uint32 axis;
+	};
+
+	struct Range
+	{
+		uint32 node;
+		uint32 begin;
+		uint32 end;
+		Scalar squared_distance; // lower bound of the distance from the query to the points of the node
+	};
+
+	uint32 leaf_size_;
+	std::vector<Vertex> vertices_;
+	std::vector<VEC> points_;
+	std::vector<Split> splits_;
+
+	bool is_leaf(uint32 begin, uint32 end) const { return end - begin <= leaf_size_; }
+	static uint32 middle(uint32 begin, uint32 end) { return begin + (end - begin) / 2u; }
+
+	template <typename FUNC>
+	void traverse(const VEC& p, const FUNC& visit_leaf, const Scalar& bound) const;
+
+public:
+
+	KDTree(
+		const MESH& m,
+		const typename mesh_traits<MESH>::template Attribute<VEC>* vertex_position,
+		uint32 leaf_size = 8u
+	);
+
+	KDTree(const KDTree&) = delete;
+	KDTree& operator=(const KDTree&) = delete;
+
+	uint32 nb_points() const { return uint32(points_.size()); }
+
+	/**
+	 * \brief nearest vertex to p (invalid if the tree is empty)
+	 */
+	Vertex nearest(const VEC& p, Scalar* squared_distance = nullptr) const;
+
+	/**
+	 * \brief k nearest vertices to p, sorted by increasing distance (less than k if the tree has less points)
+	 */
+	void knn(const VEC& p, uint32 k, std::vector<Vertex>& neighbors, std::vector<Scalar>* squared_distances = nullptr) const;
+
+	/**
+	 * \brief vertices closer than radius to p, sorted by increasing distance
+	 */
+	void radius(const VEC& p, Scalar radius, std::vector<Vertex>& neighbors, std::vector<Scalar>* squared_distances = nullptr) const;
+
+	// batched queries (parallel)
+
+	/**
+	 * \brief k nearest vertices of each point, stored in neighbors[i * k, (i + 1) * k[
+	 * (padded with invalid vertices if the tree has less than k points)
+	 */
+	void knn(const std::vector<VEC>& points, uint32 k, std::vector<Vertex>& neighbors) const
+	{
+		neighbors.assign(points.size() * k, Vertex());
+		parallel_foreach_chunk(uint32(points.size()), [&] (uint32, uint32 begin, uint32 end)
+		{
+			std::vector<Vertex> nb;
+			for (uint32 i = begin; i < end; ++i)
+			{
+				knn(points[i], k, nb);
+				std::copy(nb.begin(), nb.end(), neighbors.begin() + std::size_t(i) * k);
+			}
+		}, 256u);
+	}
+
+	void radius(const std::vector<VEC>& points, Scalar r, std::vector<std::vector<Vertex>>& neighbors) const
+	{
+		neighbors.resize(points.size());
+		parallel_for(uint32(points.size()), [&] (uint32 i) { radius(points[i], r, neighbors[i]); }, 256u);
+	}
+};
+
+template <typename MESH, typename VEC>
+const uint32 KDTree<MESH, VEC>::DIM;
+
+template <typename MESH, typename VEC>
+KDTree<MESH, VEC>::KDTree(
+	const MESH& m,
+	const typename mesh_traits<MESH>::template Attribute<VEC>* vertex_position,
+	uint32 leaf_size
+) :
+	leaf_size_(std::max(1u, leaf_size))
+{
+	// markers are not thread-safe: vertices are gathered sequentially and then processed in parallel
+	foreach_cell(m, [&] (Vertex v) -> bool { vertices_.push_back(v); return true; });
+	const uint32 n = uint32(vertices_.size());
+	if (n == 0u)
+		return;
+
+	std::vector<uint32> order(n);
+	parallel_for(n, [&] (uint32 i) { order[i] = index_of(m, vertices_[i]); });
+	std::vector<VEC> positions(n);
+	parallel_for(n, [&] (uint32 i) { positions[i] = (*vertex_position)[order[i]]; order[i] = i; });
+
+	// number of nodes of the implicit tree
+	uint32 nb_nodes = 1u;
+	uint32 nb_level_nodes = 1u;
+	uint32 level_size = n;
+	while (level_size > leaf_size_)
+	{
+		nb_level_nodes *= 2u;
+		nb_nodes += nb_level_nodes;
+		level_size = (level_size + 1u) / 2u;
+	}
+	splits_.resize(nb_nodes);
+
+	// nodes of the same level have disjoint ranges: they are split in parallel
+	std::vector<Range> level = { Range{ 0u, 0u, n, Scalar(0) } };
+	std::vector<Range> next_level;
+	while (!level.empty())
+	{
+		parallel_for(uint32(level.size()), [&] (uint32 i)
+		{
+			const Range& r = level[i];
+			if (is_leaf(r.begin, r.end))
+				return;
+			AABB<VEC> bb;
+			for (uint32 j = r.begin; j < r.end; ++j)
+				bb.extend(positions[order[j]]);
+			const uint32 axis = bb.largest_axis();
+			const uint32 mid = middle(r.begin, r.end);
+			std::nth_element(order.begin() + r.begin, order.begin() + mid, order.begin() + r.end,
+				[&] (uint32 a, uint32 b) { return positions[a][axis] < positions[b][axis]; });
+			splits_[r.node] = Split{ positions[order[mid]][axis], axis };
+		}, 1u);
+
+		next_level.clear();
+		for (const Range& r : level)
+		{
+			if (is_leaf(r.begin, r.end))
+				continue;
+			const uint32 mid = middle(r.begin, r.end);
+			next_level.push_back(Range{ 2u * r.node + 1u, r.begin, mid, Scalar(0) });
+			next_level.push_back(Range{ 2u * r.node + 2u, mid, r.end, Scalar(0) });
+		}
+		level.swap(next_level);
+	}
+
+	// the points and vertices are stored in tree order
+	std::vector<Vertex> vertices(n);
+	points_.resize(n);
+	parallel_for(n, [&] (uint32 i)
+	{
+		points_[i] = positions[order[i]];
+		vertices[i] = vertices_[order[i]];
+	});
+	vertices_.swap(vertices);
+}
+
+/**
+ * visits the leaves that may contain points closer than bound to p (nearest first):
+ * visit_leaf(begin, end) may decrease bound
+ */
+template <typename MESH, typename VEC>
+template <typename FUNC>
+void KDTree<MESH, VEC>::traverse(const VEC& p, const FUNC& visit_leaf, const Scalar& bound) const
+{
+	if (points_.empty())
+		return;
+
+	Range stack[64];
+	uint32 top = 0u;
+	stack[top++] = Range{ 0u, 0u, nb_points(), Scalar(0) };
+	while (top > 0u)
+	{
+		const Range r = stack[--top];
+		if (r.squared_distance > bound)
+			continue;
+		if (is_leaf(r.begin, r.end))
+		{
+			visit_leaf(r.begin, r.end);
+			continue;
+		}
+		const Split& s = splits_[r.node];
+		const uint32 mid = middle(r.begin, r.end);
+		const Scalar d = p[s.axis] - s.value;
+		const Scalar d2 = std::max(r.squared_distance, d * d);
+		// the far child is pushed first so that the near child is visited first
+		if (d < Scalar(0))
+		{
+			stack[top++] = Range{ 2u * r.node + 2u, mid, r.end, d2 };
+			stack[top++] = Range{ 2u * r.node + 1u, r.begin, mid, r.squared_distance };
+		}
+		else
+		{
+			stack[top++] = Range{ 2u * r.node + 1u, r.begin, mid, d2 };
+			stack[top++] = Range{ 2u * r.node + 2u, mid, r.end, r.squared_distance };
+		}
+	}
+}
+
+template <typename MESH, typename VEC>
+typename KDTree<MESH, VEC>::Vertex KDTree<MESH, VEC>::nearest(const VEC& p, Scalar* squared_distance) const
+{
+	Scalar best = std::numeric_limits<Scalar>::max();
+	uint32 best_index = INVALID_INDEX;
+	traverse(p, [&] (uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+		{
+			const Scalar d2 = (points_[i] - p).squaredNorm();
+			if (d2 < best)
+			{
+				best = d2;
+				best_index = i;
+			}
+		}
+	}, best);
+	if (squared_distance)
+		*squared_distance = best;
+	return best_index == INVALID_INDEX ? Vertex() : vertices_[best_index];
+}
+
+template <typename MESH, typename VEC>
+void KDTree<MESH, VEC>::knn(const VEC& p, uint32 k, std::vector<Vertex>& neighbors, std::vector<Scalar>* squared_distances) const
+{
+	using Candidate = std::pair<Scalar, uint32>;
+
+	neighbors.clear();
+	if (squared_distances)
+		squared_distances->clear();
+	if (k == 0u)
+		return;
+
+	// max-heap of the k best candidates
+	std::vector<Candidate> heap;
+	heap.reserve(k);
+	Scalar bound = std::numeric_limits<Scalar>::max();
+	traverse(p, [&] (uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+		{
+			const Scalar d2 = (points_[i] - p).squaredNorm();
+			if (heap.size() < k)
+			{
+				heap.push_back(Candidate(d2, i));
+				std::push_heap(heap.begin(), heap.end());
+				if (heap.size() == k)
+					bound = heap.front().first;
+			}
+			else if (d2 < bound)
+			{
+				std::pop_heap(heap.begin(), heap.end());
+				heap.back() = Candidate(d2, i);
+				std::push_heap(heap.begin(), heap.end());
+				bound = heap.front().first;
+			}
+		}
+	}, bound);
+
+	std::sort_heap(heap.begin(), heap.end());
+	neighbors.reserve(heap.size());
+	for (const Candidate& c : heap)
+		neighbors.push_back(vertices_[c.second]);
+	if (squared_distances)
+		for (const Candidate& c : heap)
+			squared_distances->push_back(c.first);
+}
+
+template <typename MESH, typename VEC>
+void KDTree<MESH, VEC>::radius(const VEC& p, Scalar radius, std::vector<Vertex>& neighbors, std::vector<Scalar>* squared_distances) const
+{
+	using Candidate = std::pair<Scalar, uint32>;
+
+	neighbors.clear();
+	if (squared_distances)
+		squared_distances->clear();
+
+	std::vector<Candidate> found;
+	const Scalar r2 = radius * radius;
+	traverse(p, [&] (uint32 begin, uint32 end)
+	{
+		for (uint32 i = begin; i < end; ++i)
+		{
+			const Scalar d2 = (points_[i] - p).squaredNorm();
+			if (d2 <= r2)
+				found.push_back(Candidate(d2, i));
+		}
+	}, r2);
+
+	std::sort(found.begin(), found.end());
+	neighbors.reserve(found.size());
+	for (const Candidate& c : found)
+		neighbors.push_back(vertices_[c.second]);
+	if (squared_distances)
+		for (const Candidate& c : found)
+			squared_distances->push_back(c.first);
+}
+
+} // namespace geometry
+
+} // namespace cgogn
+
+#endif // CGOGN_GEOMETRY_TYPES_KD_TREE_H_
@@ -0,0 +1,423 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_IO_MAP_SNAPSHOT_H_
+#define CGOGN_IO_MAP_SNAPSHOT_H_
+
+#include <cgogn/io/mapped_file.h>
+
+#include <cgogn/core/types/cmap/cmap_base.h>
+#include <cgogn/geometry/types/vector_traits.h>
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <string>
+#include <iostream>
+
+namespace cgogn
+{
+
+namespace io
+{
+
+/**
+ * A snapshot stores the dart container (relations, embeddings, boundary marker and the other dart attributes)
+ * and the cell attribute containers of a map as they are in memory: a header, a directory of the attribute blocks
+ * (container, type tag, size of the values, name) and the raw blocks, aligned on 64 bytes.
+ * It is written in the native byte order and is not meant to be exchanged between machines.
+ * Loading maps the file (copy-on-write) and the attributes use the mapped blocks without any copy.
+ */
+
+namespace internal
+{
+
+static const char SNAPSHOT_MAGIC[8] = { 'C', 'G', 'o', 'G', 'N', 'M', 'A', 'P' };
+static const uint32 SNAPSHOT_VERSION = 1u;
+static const uint32 SNAPSHOT_BYTE_ORDER = 0x01020304u;
+static const uint64 SNAPSHOT_ALIGNMENT = 64u;
+
+struct SnapshotHeader
+{
+	char magic[8];
+	uint32 version;
+	uint32 byte_order; // SNAPSHOT_BYTE_ORDER written natively
+	uint32 nb_relations; // identifies the type of map
+	uint32 nb_containers; // the dart container followed by the cell containers of each orbit
+	uint32 nb_blocks;
+	uint32 reserved;
+};
+
+// followed by the name of the attribute, padded to a multiple of 8 bytes
+struct SnapshotBlockHeader
+{
+	uint64 offset;
+	uint64 nb_bytes;
+	uint32 container;
+	uint32 type_tag;
+	uint32 value_size;
+	uint32 name_length;
+};
+
+inline uint64 snapshot_align(uint64 offset, uint64 alignment)
+{
+	return (offset + alignment - 1u) / alignment * alignment;
+}
+
+/**
+ * type tag of the attributes of T: kind of scalar (1: signed integer, 2: unsigned integer, 3: floating point, 4: dart),
+ * size of the scalar and number of components
+ */
+template <typename T>
+struct SnapshotType
+{
+	using Scalar = typename geometry::vector_traits<T>::Scalar;
+	static const uint32 kind = std::is_floating_point<Scalar>::value ? 3u : (std::is_signed<Scalar>::value ? 1u : 2u);
+	static const uint32 tag = (kind << 16) | (uint32(sizeof(Scalar)) << 8) | uint32(geometry::vector_traits<T>::SIZE);
+};
+
+template <>
+struct SnapshotType<Dart>
+{
+	static const uint32 tag = (4u << 16) | (uint32(sizeof(uint32)) << 8) | 1u;
+};
+
+struct SnapshotBlock
+{
+	uint32 container;
+	uint32 type_tag;
+	uint32 value_size;
+	std::string name;
+	const char* data;
+	uint64 nb_bytes;
+};
+
+/**
+ * calls func.template apply<T>() for the types T of the attributes that can be saved in a snapshot
+ * until one of these calls returns true
+ * \returns false if all the calls returned false
+ */
+template <typename FUNC>
+bool dispatch_snapshot_type(FUNC& func)
+{
+	return
+		func.template apply<Dart>() ||
+		func.template apply<uint32>() || func.template apply<uint8>() ||
+		func.template apply<float64>() || func.template apply<float32>() ||
+		func.template apply<int64>() || func.template apply<uint64>() ||
+		func.template apply<int32>() ||
+		func.template apply<int16>() || func.template apply<uint16>() ||
+		func.template apply<int8>() ||
+		func.template apply<Eigen::Vector3d>() || func.template apply<Eigen::Vector3f>() ||
+		func.template apply<Eigen::Vector2d>() || func.template apply<Eigen::Vector2f>() ||
+		func.template apply<Eigen::Vector4d>() || func.template apply<Eigen::Vector4f>();
+}
+
+// gets the type tag of an attribute (0 if its type is not supported)
+struct SnapshotTypeTag
+{
+	const AttributeGen* attribute;
+	uint32 tag;
+
+	template <typename T>
+	bool apply()
+	{
+		if (!dynamic_cast<const Attribute<T>*>(attribute))
+			return false;
+		tag = SnapshotType<T>::tag;
+		return true;
+	}
+};
+
+inline uint32 snapshot_type_tag(const AttributeGen* attribute)
+{
+	SnapshotTypeTag f = { attribute, 0u };
+	dispatch_snapshot_type(f);
+	return f.tag;
+}
+
+// adds the block of an attribute to the blocks to save
+struct SnapshotBlockSaver
+{
+	const AttributeGen* attribute;
+	uint32 container;
+	std::vector<SnapshotBlock>& blocks;
+
+	template <typename T>
+	bool apply()
+	{
+		const Attribute<T>* a = dynamic_cast<const Attribute<T>*>(attribute);
+		if (!a)
+			return false;
+		blocks.push_back({container, SnapshotType<T>::tag, uint32(sizeof(T)), a->name(),
+			static_cast<const char*>(a->data_ptr()), uint64(a->size()) * sizeof(T)});
+		return true;
+	}
+};
+
+/**
+ * makes the attribute of the given name (created if needed) use the values of the block if it is a block of T attribute.
+ * The values are copied only when the block is not suitably aligned in memory (file read into a buffer).
+ */
+struct SnapshotBlockLoader
+{
+	AttributeContainer& container;
+	const SnapshotBlockHeader& block;
+	const std::string& name;
+	char* data;
+	const std::shared_ptr<void>& owner;
+
+	template <typename T>
+	bool apply()
+	{
+		if (block.type_tag != SnapshotType<T>::tag || block.value_size != sizeof(T))
+			return false;
+		Attribute<T>* a = container.get_attribute<T>(name);
+		if (!a)
+			a = container.add_attribute<T>(name);
+		const uint32 n = uint32(block.nb_bytes / sizeof(T));
+		if (reinterpret_cast<std::uintptr_t>(data) % alignof(T) == 0u)
+			a->set_external_values(reinterpret_cast<T*>(data), n, owner);
+		else
+		{
+			std::shared_ptr<std::vector<T>> values = std::make_shared<std::vector<T>>(n);
+			if (n > 0u)
+				std::memcpy(static_cast<void*>(values->data()), data, block.nb_bytes);
+			a->set_external_values(values->data(), n, values);
+		}
+		return true;
+	}
+};
+
+// returns the attribute of the given name of the container, whatever its type (nullptr if there is none)
+inline const AttributeGen* find_snapshot_attribute(const AttributeContainer& container, const std::string& name)
+{
+	for (const AttributeGen* a : container)
+	{
+		if (a->name() == name)
+			return a;
+	}
+	return nullptr;
+}
+
+inline AttributeContainer& snapshot_container(const CMapBase& m, uint32 container)
+{
+	return container == 0u ? m.topology_ : m.attribute_containers_[container - 1u];
+}
+
+} // namespace internal
+
+/**
+ * \brief writes a snapshot of the map (see above): the attributes of the dart container and of the cell containers
+ * whose type is a scalar, a Dart or an Eigen vector of size 2 to 4; the others are skipped with a warning.
+ * The markers are not saved.
+ */
+inline bool save_map_snapshot(const CMapBase& m, const std::string& filename)
+{
+	const uint32 nb_containers = uint32(NB_ORBITS) + 1u;
+	std::vector<uint32> container_sizes(nb_containers);
+	std::vector<internal::SnapshotBlock> blocks;
+	for (uint32 c = 0u; c < nb_containers; ++c)
+	{
+		const AttributeContainer& container = internal::snapshot_container(m, c);
+		container_sizes[c] = container.size();
+		for (const AttributeGen* a : container)
+		{
+			internal::SnapshotBlockSaver saver = { a, c, blocks };
+			if (!internal::dispatch_snapshot_type(saver))
+				std::cerr << "save_map_snapshot: attribute \"" << a->name() << "\" has an unsupported type" << std::endl;
+		}
+	}
+
+	// header and directory
+	std::vector<char> directory(sizeof(internal::SnapshotHeader) + nb_containers * sizeof(uint32));
+	internal::SnapshotHeader header;
+	std::memcpy(header.magic, internal::SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = internal::SNAPSHOT_VERSION;
+	header.byte_order = internal::SNAPSHOT_BYTE_ORDER;
+	header.nb_relations = uint32(m.relations_.size());
+	header.nb_containers = nb_containers;
+	header.nb_blocks = uint32(blocks.size());
+	header.reserved = 0u;
+	std::memcpy(directory.data(), &header, sizeof(header));
+	std::memcpy(directory.data() + sizeof(header), container_sizes.data(), nb_containers * sizeof(uint32));
+
+	uint64 offset = directory.size();
+	for (const internal::SnapshotBlock& b : blocks)
+		offset += sizeof(internal::SnapshotBlockHeader) + internal::snapshot_align(b.name.size(), 8u);
+	for (const internal::SnapshotBlock& b : blocks)
+	{
+		offset = internal::snapshot_align(offset, internal::SNAPSHOT_ALIGNMENT);
+		internal::SnapshotBlockHeader bh = { offset, b.nb_bytes, b.container, b.type_tag, b.value_size, uint32(b.name.size()) };
+		const std::size_t pos = directory.size();
+		directory.resize(pos + sizeof(bh) + internal::snapshot_align(b.name.size(), 8u), 0);
+		std::memcpy(directory.data() + pos, &bh, sizeof(bh));
+		std::memcpy(directory.data() + pos + sizeof(bh), b.name.data(), b.name.size());
+		offset += b.nb_bytes;
+	}
+
+	FILE* fp = std::fopen(filename.c_str(), "wb");
+	if (!fp)
+	{
+		std::cerr << "Unable to open file \"" << filename << "\"." << std::endl;
+		return false;
+	}
+
+	// blocks
+	bool success = std::fwrite(directory.data(), 1u, directory.size(), fp) == directory.size();
+	static const char padding[internal::SNAPSHOT_ALIGNMENT] = {};
+	offset = directory.size();
+	for (const internal::SnapshotBlock& b : blocks)
+	{
+		const std::size_t nb_padding = std::size_t(internal::snapshot_align(offset, internal::SNAPSHOT_ALIGNMENT) - offset);
+		success = success && std::fwrite(padding, 1u, nb_padding, fp) == nb_padding;
+		success = success && (b.nb_bytes == 0u || std::fwrite(b.data, 1u, std::size_t(b.nb_bytes), fp) == b.nb_bytes);
+		offset += nb_padding + b.nb_bytes;
+	}
+	success = std::fclose(fp) == 0 && success;
+
+	if (!success)
+		std::cerr << "Error while writing file \"" << filename << "\"." << std::endl;
+	return success;
+}
+
+/**
+ * \brief loads a snapshot into an empty map of the type of the saved map.
+ * The attributes of the map that have the name of a saved attribute must have its type (the loading fails otherwise).
+ * The file is mapped in copy-on-write mode: the attributes use the mapped blocks, whose pages are loaded on demand,
+ * and the modified pages become private copies (the file is never written). The values of an attribute are
+ * copied in memory when lines are added to its container. The mapping is released with the last of these attributes.
+ */
+inline bool load_map_snapshot(CMapBase& m, const std::string& filename)
+{
+	std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+	if (!file->open(filename, true))
+	{
+		std::cerr << "Unable to open file \"" << filename << "\"." << std::endl;
+		return false;
+	}
+
+	const uint32 nb_containers = uint32(NB_ORBITS) + 1u;
+	for (uint32 c = 0u; c < nb_containers; ++c)
+	{
+		if (internal::snapshot_container(m, c).size() != 0u)
+		{
+			std::cerr << "load_map_snapshot: the map must be empty." << std::endl;
+			return false;
+		}
+	}
+
+	char* data = file->writable_data();
+	const uint64 size = file->size();
+	internal::SnapshotHeader header;
+	if (size >= sizeof(header))
+		std::memcpy(&header, data, sizeof(header));
+	if (size < sizeof(header) || std::memcmp(header.magic, internal::SNAPSHOT_MAGIC, sizeof(header.magic)) != 0)
+	{
+		std::cerr << "File \"" << filename << "\" is not a valid map snapshot." << std::endl;
+		return false;
+	}
+	if (header.version != internal::SNAPSHOT_VERSION || header.byte_order != internal::SNAPSHOT_BYTE_ORDER)
+	{
+		std::cerr << "File \"" << filename << "\": unsupported snapshot version or byte order." << std::endl;
+		return false;
+	}
+	if (header.nb_relations != m.relations_.size() || header.nb_containers != nb_containers)
+	{
+		std::cerr << "File \"" << filename << "\": the snapshot is not a snapshot of this type of map." << std::endl;
+		return false;
+	}
+
+	// directory
+	std::vector<uint32> container_sizes(nb_containers);
+	uint64 pos = sizeof(header) + nb_containers * sizeof(uint32);
+	bool valid = pos <= size;
+	if (valid)
+		std::memcpy(container_sizes.data(), data + sizeof(header), nb_containers * sizeof(uint32));
+	std::vector<internal::SnapshotBlockHeader> block_headers;
+	std::vector<std::string> names;
+	uint32 nb_relations = 0u;
+	for (uint32 i = 0u; valid && i < header.nb_blocks; ++i)
+	{
+		internal::SnapshotBlockHeader bh;
+		valid = pos + sizeof(bh) <= size;
+		if (!valid)
+			break;
+		std::memcpy(&bh, data + pos, sizeof(bh));
+		pos += sizeof(bh);
+		valid = pos + bh.name_length <= size && bh.container < nb_containers && bh.value_size > 0u &&
+			bh.offset % internal::SNAPSHOT_ALIGNMENT == 0u && bh.offset <= size && bh.nb_bytes <= size - bh.offset &&
+			bh.nb_bytes == uint64(container_sizes[bh.container]) * bh.value_size;
+		if (!valid)
+			break;
+		names.emplace_back(data + pos, bh.name_length);
+		pos += internal::snapshot_align(bh.name_length, 8u);
+		block_headers.push_back(bh);
+		if (bh.container == 0u && bh.type_tag == internal::SnapshotType<Dart>::tag)
+		{
+			for (Attribute<Dart>* r : m.relations_)
+				nb_relations += r->name() == names.back() ? 1u : 0u;
+		}
+	}
+	if (!valid || nb_relations != m.relations_.size())
+	{
+		std::cerr << "File \"" << filename << "\": invalid snapshot directory." << std::endl;
+		return false;
+	}
+
+	// an attribute of the map with the name of a block must have its type (the map is left unchanged otherwise)
+	for (uint32 i = 0u; i < block_headers.size(); ++i)
+	{
+		const AttributeGen* a = internal::find_snapshot_attribute(internal::snapshot_container(m, block_headers[i].container), names[i]);
+		if (a && internal::snapshot_type_tag(a) != block_headers[i].type_tag)
+		{
+			std::cerr << "File \"" << filename << "\": the map has an attribute \"" << names[i] << "\" of another type." << std::endl;
+			return false;
+		}
+	}
+
+	// the attributes use the blocks, then the lines are added to the containers (without resizing these attributes)
+	const std::shared_ptr<void> owner = file;
+	for (uint32 i = 0u; i < block_headers.size(); ++i)
+	{
+		const internal::SnapshotBlockHeader& bh = block_headers[i];
+		AttributeContainer& container = internal::snapshot_container(m, bh.container);
+		internal::SnapshotBlockLoader loader = { container, bh, names[i], data + bh.offset, owner };
+		if (!internal::dispatch_snapshot_type(loader))
+			std::cerr << "load_map_snapshot: attribute \"" << names[i] << "\" has an unsupported type" << std::endl;
+	}
+	for (uint32 c = 0u; c < nb_containers; ++c)
+		internal::snapshot_container(m, c).add_lines(container_sizes[c]);
+	for (uint32 orbit = 0u; orbit < NB_ORBITS; ++orbit)
+		m.embeddings_[orbit] = m.topology_.get_attribute<uint32>("emb_" + orbit_name(Orbit(orbit)));
+
+	return true;
+}
+
+} // namespace io
+
+} // namespace cgogn
+
+#endif // CGOGN_IO_MAP_SNAPSHOT_H_
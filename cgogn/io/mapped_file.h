@@ -0,0 +1,215 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_IO_MAPPED_FILE_H_
+#define CGOGN_IO_MAPPED_FILE_H_
+
+#include <cgogn/core/utils/numerics.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstddef>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace cgogn
+{
+
+namespace io
+{
+
+/**
+ * \brief read-only view of the content of a file, mapped in memory.
+ * The pages are loaded on demand by the system and no copy of the file is made.
+ * When the file cannot be mapped (e.g. special files), its content is read into a buffer.
+ * In copy-on-write mode, the view is writable and the modified pages are private copies (the file is never written).
+ */
+class MappedFile
+{
+	const char* data_;
+	std::size_t size_;
+	bool open_;
+	bool writable_;
+	std::vector<char> buffer_;
+
+#ifdef _WIN32
+	HANDLE file_;
+	HANDLE mapping_;
+#else
+	bool mapped_;
+#endif
+
+	bool read_into_buffer(const std::string& filename)
+	{
+		std::ifstream fp(filename.c_str(), std::ios::in | std::ios::binary);
+		if (!fp.good())
+			return false;
+		fp.seekg(0, std::ios::end);
+		const std::streamoff size = fp.tellg();
+		fp.seekg(0, std::ios::beg);
+		if (size < 0)
+			return false;
+		buffer_.resize(std::size_t(size));
+		if (size > 0)
+			fp.read(buffer_.data(), size);
+		data_ = buffer_.data();
+		size_ = buffer_.size();
+		return true;
+	}
+
+public:
+
+	inline MappedFile() :
+		data_(nullptr),
+		size_(0u),
+		open_(false),
+		writable_(false)
+#ifdef _WIN32
+		, file_(INVALID_HANDLE_VALUE), mapping_(nullptr)
+#else
+		, mapped_(false)
+#endif
+	{}
+
+	inline explicit MappedFile(const std::string& filename, bool copy_on_write = false) : MappedFile()
+	{
+		open(filename, copy_on_write);
+	}
+
+	inline ~MappedFile()
+	{
+		close();
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	/**
+	 * \brief maps the given file (sequential access is advised to the system, unless in copy-on-write mode)
+	 * \returns false if the file cannot be read
+	 */
+	inline bool open(const std::string& filename, bool copy_on_write = false)
+	{
+		close();
+#ifdef _WIN32
+		file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file_ != INVALID_HANDLE_VALUE)
+		{
+			LARGE_INTEGER size;
+			if (GetFileSizeEx(file_, &size) && size.QuadPart > 0)
+			{
+				mapping_ = CreateFileMappingA(file_, nullptr, copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, nullptr);
+				if (mapping_)
+				{
+					data_ = static_cast<const char*>(MapViewOfFile(mapping_, copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0));
+					size_ = std::size_t(size.QuadPart);
+				}
+			}
+			if (data_)
+				open_ = true;
+			else
+				close();
+		}
+#else
+		const int fd = ::open(filename.c_str(), O_RDONLY);
+		if (fd >= 0)
+		{
+			struct stat st;
+			if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0)
+			{
+				const int prot = copy_on_write ? PROT_READ | PROT_WRITE : PROT_READ;
+				void* p = mmap(nullptr, std::size_t(st.st_size), prot, MAP_PRIVATE, fd, 0);
+				if (p != MAP_FAILED)
+				{
+					if (!copy_on_write)
+						madvise(p, std::size_t(st.st_size), MADV_SEQUENTIAL);
+					data_ = static_cast<const char*>(p);
+					size_ = std::size_t(st.st_size);
+					mapped_ = true;
+					open_ = true;
+				}
+			}
+			::close(fd); // the mapping stays valid after the descriptor is closed
+		}
+#endif
+		if (!open_)
+			open_ = read_into_buffer(filename);
+		writable_ = open_ && copy_on_write;
+		return open_;
+	}
+
+	inline void close()
+	{
+#ifdef _WIN32
+		if (mapping_)
+		{
+			if (data_)
+				UnmapViewOfFile(data_);
+			CloseHandle(mapping_);
+			mapping_ = nullptr;
+		}
+		if (file_ != INVALID_HANDLE_VALUE)
+		{
+			CloseHandle(file_);
+			file_ = INVALID_HANDLE_VALUE;
+		}
+#else
+		if (mapped_)
+		{
+			munmap(const_cast<char*>(data_), size_);
+			mapped_ = false;
+		}
+#endif
+		buffer_.clear();
+		buffer_.shrink_to_fit();
+		data_ = nullptr;
+		size_ = 0u;
+		open_ = false;
+		writable_ = false;
+	}
+
+	inline bool is_open() const { return open_; }
+	inline const char* data() const { return data_; }
+	// writable view, only available in copy-on-write mode
+	inline char* writable_data() { return writable_ ? const_cast<char*>(data_) : nullptr; }
+	inline std::size_t size() const { return size_; }
+	inline const char* begin() const { return data_; }
+	inline const char* end() const { return data_ + size_; }
+};
+
+} // namespace io
+
+} // namespace cgogn
+
+#endif // CGOGN_IO_MAPPED_FILE_H_
@@ -0,0 +1,345 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_IO_SURFACE_EXPORT_H_
+#define CGOGN_IO_SURFACE_EXPORT_H_
+
+#include <cgogn/io/utils.h>
+
+#include <cgogn/core/types/cmap/cmap2.h>
+#include <cgogn/core/functions/traversals/global.h>
+#include <cgogn/core/functions/attributes.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/endian.h>
+#include <cgogn/geometry/functions/normal.h>
+#include <cgogn/geometry/functions/vector_ops.h>
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <iostream>
+
+namespace cgogn
+{
+
+namespace io
+{
+
+namespace internal
+{
+
+/**
+ * writes nb records by blocks: the blocks of a batch are formatted in parallel, each one in its own buffer,
+ * and the buffers are then written in order with one fwrite each
+ */
+template <typename FUNC>
+bool write_records(FILE* fp, uint32 nb, const FUNC& write_record)
+{
+	static const uint32 BLOCK_SIZE = 1u << 14u;
+	static const uint32 BATCH_SIZE = 64u;
+
+	const uint32 nb_blocks = (nb + BLOCK_SIZE - 1u) / BLOCK_SIZE;
+	std::vector<std::vector<char>> buffers(std::min(nb_blocks, BATCH_SIZE));
+	for (uint32 first = 0u; first < nb_blocks; first += BATCH_SIZE)
+	{
+		const uint32 n = std::min(BATCH_SIZE, nb_blocks - first);
+		parallel_for(n, [&] (uint32 b)
+		{
+			std::vector<char>& buffer = buffers[b];
+			buffer.clear();
+			const uint32 begin = (first + b) * BLOCK_SIZE;
+			const uint32 end = std::min(begin + BLOCK_SIZE, nb);
+			for (uint32 i = begin; i < end; ++i)
+				write_record(buffer, i);
+		}, 1u);
+		for (uint32 b = 0u; b < n; ++b)
+		{
+			if (std::fwrite(buffers[b].data(), 1u, buffers[b].size(), fp) != buffers[b].size())
+				return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * live cells of an exported surface, in traversal order.
+ * The vertices are numbered in this order: vertex_id gives the number of a vertex from its embedding,
+ * so that the unused lines of the vertex container are not written.
+ */
+struct SurfaceExportCells
+{
+	std::vector<CMap2::Vertex> vertices;
+	std::vector<CMap2::Face> faces;
+	std::vector<uint32> vertex_id;
+
+	explicit SurfaceExportCells(const CMap2& m)
+	{
+		foreach_cell(m, [&] (CMap2::Vertex v) -> bool { vertices.push_back(v); return true; });
+		foreach_cell(m, [&] (CMap2::Face f) -> bool { faces.push_back(f); return true; });
+		vertex_id.assign(m.attribute_containers_[CMap2::Vertex::ORBIT].size(), INVALID_INDEX);
+		parallel_for(uint32(vertices.size()), [&] (uint32 i) { vertex_id[index_of(m, vertices[i])] = i; });
+	}
+};
+
+inline uint32 face_degree(const CMap2& m, CMap2::Face f)
+{
+	uint32 n = 0u;
+	Dart d = f.dart;
+	do
+	{
+		++n;
+		d = m.phi1(d);
+	} while (d != f.dart);
+	return n;
+}
+
+inline uint32 nb_edges(const CMap2& m)
+{
+	uint32 n = 0u;
+	foreach_cell(m, [&] (CMap2::Edge) -> bool { ++n; return true; });
+	return n;
+}
+
+inline char* format_number(char* p, float64 value) { return format_double(p, value); }
+inline char* format_number(char* p, float32 value) { return format_float(p, value); }
+inline char* format_number(char* p, uint32 value) { return format_uint(p, value); }
+
+/**
+ * appends the text of a record made of a prefix and of the given values separated by spaces
+ */
+template <typename T>
+void write_text_record(std::vector<char>& buffer, const char* prefix, const T* values, uint32 nb)
+{
+	char text[32];
+	buffer.insert(buffer.end(), prefix, prefix + std::strlen(prefix));
+	for (uint32 k = 0u; k < nb; ++k)
+	{
+		char* end = format_number(text, values[k]);
+		if (k + 1u < nb)
+			*end++ = ' ';
+		buffer.insert(buffer.end(), text, end);
+	}
+	buffer.push_back('\n');
+}
+
+template <typename T>
+void write_binary_value(std::vector<char>& buffer, T value)
+{
+	const std::size_t s = buffer.size();
+	buffer.resize(s + sizeof(T));
+	std::memcpy(&buffer[s], &value, sizeof(T));
+}
+
+/**
+ * writes the records of the vertices (coordinates) and of the faces (vertex numbers) of an OFF or OBJ file
+ */
+template <typename VEC3>
+bool write_polygon_records(
+	FILE* fp,
+	const CMap2& m,
+	const Attribute<VEC3>* vertex_position,
+	const SurfaceExportCells& cells,
+	const char* vertex_prefix,
+	const char* face_prefix,
+	bool write_degree,
+	uint32 first_index
+)
+{
+	using Scalar = typename geometry::vector_traits<VEC3>::Scalar;
+	bool success = write_records(fp, uint32(cells.vertices.size()), [&] (std::vector<char>& buffer, uint32 i)
+	{
+		const VEC3& p = (*vertex_position)[index_of(m, cells.vertices[i])];
+		const Scalar coordinates[3] = { p[0], p[1], p[2] };
+		write_text_record(buffer, vertex_prefix, coordinates, 3u);
+	});
+	return success && write_records(fp, uint32(cells.faces.size()), [&] (std::vector<char>& buffer, uint32 i)
+	{
+		thread_local std::vector<uint32> indices;
+		indices.clear();
+		if (write_degree)
+			indices.push_back(0u);
+		Dart d = cells.faces[i].dart;
+		do
+		{
+			indices.push_back(cells.vertex_id[index_of(m, CMap2::Vertex(d))] + first_index);
+			d = m.phi1(d);
+		} while (d != cells.faces[i].dart);
+		if (write_degree)
+			indices[0] = uint32(indices.size() - 1u);
+		write_text_record(buffer, face_prefix, indices.data(), uint32(indices.size()));
+	});
+}
+
+} // namespace internal
+
+/**
+ * \brief writes a surface in an OFF file, as text or in the binary variant read by import_OFF
+ * (big endian counts and vertex indices, float32 coordinates).
+ * The vertices are numbered in traversal order; the records are formatted in parallel by blocks.
+ */
+template <typename VEC3>
+bool export_OFF(const CMap2& m, const Attribute<VEC3>* vertex_position, const std::string& filename, bool binary = false)
+{
+	const internal::SurfaceExportCells cells(m);
+	const uint32 nb_edges = internal::nb_edges(m);
+
+	FILE* fp = std::fopen(filename.c_str(), "wb");
+	if (!fp)
+	{
+		std::cerr << "Unable to open file \"" << filename << "\"." << std::endl;
+		return false;
+	}
+
+	bool success;
+	if (binary)
+	{
+		const uint32 counts[3] = {
+			swap_endianness_native_big(uint32(cells.vertices.size())),
+			swap_endianness_native_big(uint32(cells.faces.size())),
+			swap_endianness_native_big(nb_edges)
+		};
+		success = std::fputs("OFF BINARY\n", fp) >= 0 && std::fwrite(counts, sizeof(uint32), 3u, fp) == 3u;
+		success = success && internal::write_records(fp, uint32(cells.vertices.size()), [&] (std::vector<char>& buffer, uint32 i)
+		{
+			const VEC3& p = (*vertex_position)[index_of(m, cells.vertices[i])];
+			for (uint32 k = 0u; k < 3u; ++k)
+				internal::write_binary_value(buffer, swap_endianness_native_big(float32(p[k])));
+		});
+		success = success && internal::write_records(fp, uint32(cells.faces.size()), [&] (std::vector<char>& buffer, uint32 i)
+		{
+			internal::write_binary_value(buffer, swap_endianness_native_big(internal::face_degree(m, cells.faces[i])));
+			Dart d = cells.faces[i].dart;
+			do
+			{
+				internal::write_binary_value(buffer, swap_endianness_native_big(cells.vertex_id[index_of(m, CMap2::Vertex(d))]));
+				d = m.phi1(d);
+			} while (d != cells.faces[i].dart);
+		});
+	}
+	else
+	{
+		success = std::fprintf(fp, "OFF\n%u %u %u\n", uint32(cells.vertices.size()), uint32(cells.faces.size()), nb_edges) > 0;
+		success = success && internal::write_polygon_records(fp, m, vertex_position, cells, "", "", true, 0u);
+	}
+	success = std::fclose(fp) == 0 && success;
+
+	if (!success)
+		std::cerr << "Error while writing file \"" << filename << "\"." << std::endl;
+	return success;
+}
+
+/**
+ * \brief writes the vertices and the faces of a surface in an OBJ file (vertices numbered from 1 in traversal order)
+ */
+template <typename VEC3>
+bool export_OBJ(const CMap2& m, const Attribute<VEC3>* vertex_position, const std::string& filename)
+{
+	const internal::SurfaceExportCells cells(m);
+
+	FILE* fp = std::fopen(filename.c_str(), "wb");
+	if (!fp)
+	{
+		std::cerr << "Unable to open file \"" << filename << "\"." << std::endl;
+		return false;
+	}
+
+	bool success = std::fprintf(fp, "# %u vertices, %u faces\n", uint32(cells.vertices.size()), uint32(cells.faces.size())) > 0;
+	success = success && internal::write_polygon_records(fp, m, vertex_position, cells, "v ", "f ", false, 1u);
+	success = std::fclose(fp) == 0 && success;
+
+	if (!success)
+		std::cerr << "Error while writing file \"" << filename << "\"." << std::endl;
+	return success;
+}
+
+/**
+ * \brief writes a surface in a binary STL file.
+ * The faces are triangulated by fans from their first dart; each triangle is written with its unit normal
+ * (or a zero normal if it is degenerate).
+ */
+template <typename VEC3>
+bool export_STL(const CMap2& m, const Attribute<VEC3>* vertex_position, const std::string& filename)
+{
+	using Scalar = typename geometry::vector_traits<VEC3>::Scalar;
+
+	std::vector<CMap2::Face> faces;
+	foreach_cell(m, [&] (CMap2::Face f) -> bool { faces.push_back(f); return true; });
+	const uint64 nb_triangles = parallel_transform_reduce(uint32(faces.size()), uint64(0u),
+		[] (uint64 a, uint64 b) { return a + b; },
+		[&] (uint32 i) -> uint64 { return std::max(internal::face_degree(m, faces[i]), 2u) - 2u; });
+	if (nb_triangles > std::numeric_limits<uint32>::max())
+	{
+		std::cerr << "export_STL: too many triangles." << std::endl;
+		return false;
+	}
+
+	FILE* fp = std::fopen(filename.c_str(), "wb");
+	if (!fp)
+	{
+		std::cerr << "Unable to open file \"" << filename << "\"." << std::endl;
+		return false;
+	}
+
+	char header[80] = "binary STL written by CGoGN";
+	const uint32 count = swap_endianness_native_little(uint32(nb_triangles));
+	bool success = std::fwrite(header, 1u, 80u, fp) == 80u && std::fwrite(&count, sizeof(uint32), 1u, fp) == 1u;
+	success = success && internal::write_records(fp, uint32(faces.size()), [&] (std::vector<char>& buffer, uint32 i)
+	{
+		auto write_vector = [&] (const VEC3& v)
+		{
+			for (uint32 k = 0u; k < 3u; ++k)
+				internal::write_binary_value(buffer, swap_endianness_native_little(float32(v[k])));
+		};
+		const Dart d0 = faces[i].dart;
+		const VEC3& p0 = (*vertex_position)[index_of(m, CMap2::Vertex(d0))];
+		for (Dart d = m.phi1(d0); m.phi1(d) != d0; d = m.phi1(d))
+		{
+			const VEC3& p1 = (*vertex_position)[index_of(m, CMap2::Vertex(d))];
+			const VEC3& p2 = (*vertex_position)[index_of(m, CMap2::Vertex(m.phi1(d)))];
+			// the normal of a degenerate triangle (zero area up to rounding errors, or not finite) is written as (0, 0, 0)
+			VEC3 n = geometry::normal(p0, p1, p2);
+			if (n.squaredNorm() > Scalar(16) * std::numeric_limits<Scalar>::epsilon() * (p1 - p0).squaredNorm() * (p2 - p0).squaredNorm())
+				geometry::normalize(n);
+			else
+				geometry::set_zero(n);
+			write_vector(n);
+			write_vector(p0);
+			write_vector(p1);
+			write_vector(p2);
+			internal::write_binary_value(buffer, uint16(0u));
+		}
+	});
+	success = std::fclose(fp) == 0 && success;
+
+	if (!success)
+		std::cerr << "Error while writing file \"" << filename << "\"." << std::endl;
+	return success;
+}
+
+} // namespace io
+
+} // namespace cgogn
+
+#endif // CGOGN_IO_SURFACE_EXPORT_H_
@@ -27,14 +27,22 @@
 #include <Eigen/Dense>
 
 #include <cgogn/io/utils.h>
+#include <cgogn/io/mapped_file.h>
 
 #include <cgogn/core/utils/numerics.h>
 #include <cgogn/core/types/mesh_traits.h>
 #include <cgogn/core/functions/attributes.h>
 #include <cgogn/core/functions/mesh_ops/face.h>
+#include <cgogn/core/functions/mesh_ops/surface_builder.h>
+#include <cgogn/core/utils/thread_pool.h>
+#include <cgogn/core/utils/bounded_queue.h>
+#include <cgogn/core/utils/endian.h>
 
 #include <vector>
-#include <fstream>
+#include <string>
+#include <algorithm>
+#include <thread>
+#include <exception>
 
 namespace cgogn
 {
@@ -42,164 +50,654 @@ namespace cgogn
 namespace io
 {
 
-template <typename VEC3>
-void import_OFF(CMap2& m, const std::string& filename)
+/**
+ * \brief scalar type of an imported property (the type of the attribute it becomes)
+ */
+enum PropertyType : uint8
+{
+	PROPERTY_INT8 = 0,
+	PROPERTY_INT16,
+	PROPERTY_INT32,
+	PROPERTY_UINT8,
+	PROPERTY_UINT16,
+	PROPERTY_UINT32,
+	PROPERTY_FLOAT32,
+	PROPERTY_FLOAT64
+};
+
+/**
+ * \brief named scalar property of the vertices or faces of a file, one value per element in file order
+ * (the values of all the types are exactly represented by float64)
+ */
+struct ImportedProperty
 {
+	std::string name;
+	std::vector<float64> values;
+	PropertyType type;
+};
+
+/**
+ * \brief raw content of a surface mesh file: vertex coordinates (3 per vertex, in file order),
+ * number of vertices of each face and vertex indices of the faces (in file order)
+ * and the other properties of the vertices and faces (if the format has some)
+ */
+struct SurfaceImportData
+{
+	std::vector<float64> vertex_position;
 	std::vector<uint32> faces_nb_edges;
 	std::vector<uint32> faces_vertex_indices;
+	std::vector<ImportedProperty> vertex_properties;
+	std::vector<ImportedProperty> face_properties;
+
+	uint32 nb_vertices() const { return uint32(vertex_position.size() / 3u); }
+	uint32 nb_faces() const { return uint32(faces_nb_edges.size()); }
+};
 
-	std::ifstream fp(filename.c_str(), std::ios::in);
+namespace internal
+{
 
-	std::string line;
-	line.reserve(512);
+inline void print_sewing_report(const SewingReport& report)
+{
+	if (report.nb_boundary_edges > 0u)
+		std::cout << report.nb_boundary_edges << " boundary edges, " << report.nb_holes << " hole(s) have been closed" << std::endl;
+	if (report.nb_open_holes > 0u)
+		std::cout << report.nb_open_holes << " hole(s) could not be closed" << std::endl;
+	if (report.nb_non_manifold_edges > 0u)
+		std::cout << report.nb_non_manifold_edges << " non manifold edges" << std::endl;
+}
 
-	// read OFF header
-	getline_safe(fp, line);
-	if (line.rfind("OFF") == std::string::npos)
+// copies the values of the property into the attribute of type T of the same name (which is added if needed):
+// the i-th value goes to the line line(i), if valid
+template <typename T, typename CELL, typename LINE>
+void import_property(CMap2& m, const ImportedProperty& property, const LINE& line)
+{
+	Attribute<T>* a = get_attribute<T, CELL>(m, property.name);
+	if (!a)
+		a = add_attribute<T, CELL>(m, property.name);
+	parallel_for(uint32(property.values.size()), [&] (uint32 i)
 	{
-		std::cerr << "File \"" << filename << "\" is not a valid off file." << std::endl;
-		return;
+		const uint32 l = line(i);
+		if (l != INVALID_INDEX)
+			(*a)[l] = T(property.values[i]);
+	});
+	a->notify_modification();
+}
+
+template <typename CELL, typename LINE>
+void import_property(CMap2& m, const ImportedProperty& property, const LINE& line)
+{
+	switch (property.type)
+	{
+		case PROPERTY_INT8: import_property<int8, CELL>(m, property, line); break;
+		case PROPERTY_INT16: import_property<int16, CELL>(m, property, line); break;
+		case PROPERTY_INT32: import_property<int32, CELL>(m, property, line); break;
+		case PROPERTY_UINT8: import_property<uint8, CELL>(m, property, line); break;
+		case PROPERTY_UINT16: import_property<uint16, CELL>(m, property, line); break;
+		case PROPERTY_UINT32: import_property<uint32, CELL>(m, property, line); break;
+		case PROPERTY_FLOAT32: import_property<float32, CELL>(m, property, line); break;
+		case PROPERTY_FLOAT64: import_property<float64, CELL>(m, property, line); break;
 	}
+}
+
+} // namespace internal
+
+/**
+ * \brief builds a surface in the given map from imported data: the vertices get a "position" attribute
+ * and each vertex or face property becomes an attribute of the same name and of the type of the property
+ */
+template <typename VEC3>
+void import_surface_data(CMap2& m, const SurfaceImportData& data)
+{
+	const std::vector<uint32>& faces_nb_edges = data.faces_nb_edges;
+	const uint32 nb_vertices = data.nb_vertices();
+
+	auto position = get_attribute<VEC3, CMap2::Vertex>(m, "position");
+	if (!position)
+		position = add_attribute<VEC3, CMap2::Vertex>(m, "position");
 
-	// read number of vertices, edges, faces
-	const uint32 nb_vertices = read_uint(fp, line);
-	const uint32 nb_faces = read_uint(fp, line);
-	/*const uint32 nb_edges_ =*/ read_uint(fp, line);
+	std::vector<uint32> face_offsets(faces_nb_edges.size() + 1u);
+	face_offsets[0] = 0u;
+	for (uint32 f = 0u; f < faces_nb_edges.size(); ++f)
+		face_offsets[f + 1u] = face_offsets[f] + faces_nb_edges[f];
 
-	auto position = add_attribute<VEC3, CMap2::Vertex>(m, "position");
+	// the faces are embedded first: build_faces then embeds the new faces
+	if (!data.face_properties.empty() && !m.is_embedded<CMap2::Face>())
+	{
+		m.create_embedding<CMap2::Face>();
+		create_embeddings<CMap2::Face>(m);
+	}
 
-	// read vertices position
-	std::vector<uint32> vertices_id;
-	vertices_id.reserve(nb_vertices);
+	uint32 first_vertex = 0u;
+	std::vector<uint32> face_lines;
+	const SewingReport report = build_faces(m, nb_vertices, face_offsets, data.faces_vertex_indices, &first_vertex, &face_lines);
 
-	for (uint32 i = 0; i < nb_vertices; ++i)
+	parallel_for(nb_vertices, [&] (uint32 i)
 	{
-		float64 x = read_double(fp, line);
-		float64 y = read_double(fp, line);
-		float64 z = read_double(fp, line);
+		const float64* p = &data.vertex_position[3u * i];
+		(*position)[first_vertex + i] = VEC3{p[0], p[1], p[2]};
+	});
+	position->notify_modification();
 
-		VEC3 pos{x, y, z};
+	for (const ImportedProperty& property : data.vertex_properties)
+		internal::import_property<CMap2::Vertex>(m, property, [&] (uint32 i) { return first_vertex + i; });
+	for (const ImportedProperty& property : data.face_properties)
+		internal::import_property<CMap2::Face>(m, property, [&] (uint32 f) { return face_lines[f]; });
 
-		uint32 vertex_id = m.attribute_containers_[CMap2::Vertex::ORBIT].add_line();
-		(*position)[vertex_id] = pos;
+	internal::print_sewing_report(report);
+}
 
-		vertices_id.push_back(vertex_id);
-	}
+namespace internal
+{
 
-	// read faces (vertex indices)
-	for (uint32 i = 0u; i < nb_faces ; ++i)
+/**
+ * parses the vertices and faces of an ASCII OFF file after its header, as a stream of tokens
+ */
+inline bool parse_OFF_tokens(const char* p, const char* end, SurfaceImportData& data)
+{
+	const uint32 nb_vertices = data.nb_vertices();
+	for (uint32 i = 0u; i < 3u * nb_vertices; ++i)
 	{
-		uint32 n = read_uint(fp, line);
-		faces_nb_edges.push_back(n);
-		for (uint32 j = 0; j < n; ++j)
+		p = skip_to_token(p, end);
+		if (!parse_double(p, end, data.vertex_position[i]))
+			return false;
+	}
+	data.faces_vertex_indices.clear();
+	for (uint32& n : data.faces_nb_edges)
+	{
+		p = skip_to_token(p, end);
+		if (!parse_uint(p, end, n))
+			return false;
+		for (uint32 j = 0u; j < n; ++j)
 		{
-			uint32 index = read_uint(fp, line);
-			faces_vertex_indices.push_back(vertices_id[index]);
+			uint32 index;
+			p = skip_to_token(p, end);
+			if (!parse_uint(p, end, index) || index >= nb_vertices)
+				return false;
+			data.faces_vertex_indices.push_back(index);
 		}
 	}
+	return true;
+}
 
-	if (faces_nb_edges.size() == 0u)
-		return;
+// a prefix before OFF in the first line (e.g. COFF, NOFF) announces extra values on the vertex lines
+inline bool OFF_vertex_extras(const std::string& first_line)
+{
+	return first_line.find("OFF") > first_line.find_first_not_of(" \t");
+}
 
-	auto darts_per_vertex = add_attribute<std::vector<Dart>, CMap2::Vertex>(m, "darts_per_vertex");
+/**
+ * parses the vertices and faces of an ASCII OFF file after its header, in parallel:
+ * the data is split in chunks at line boundaries and the i-th non empty line (once comments are removed)
+ * is the i-th vertex or face. The values that follow the coordinates of a vertex are only ignored
+ * if vertex_extras is true (e.g. colors announced by a COFF header).
+ * \returns false if the data does not have exactly one element per line (e.g. a line carries more values than
+ * its element needs) or is invalid: the file must then be parsed as a stream of tokens
+ */
+inline bool parse_OFF_lines(const char* begin, const char* end, SurfaceImportData& data, bool vertex_extras = false)
+{
+	static const std::size_t CHUNK_SIZE = 1u << 22u;
 
-	uint32 faces_vertex_index = 0;
-	std::vector<uint32> vertices_buffer;
-	vertices_buffer.reserve(16);
+	const uint32 nb_vertices = data.nb_vertices();
+	const uint32 nb_faces = data.nb_faces();
+	const std::size_t size = std::size_t(end - begin);
+	const uint32 nbc = uint32((size + CHUNK_SIZE - 1u) / CHUNK_SIZE);
 
-	for (uint32 i = 0, end = faces_nb_edges.size(); i < end; ++i)
+	// a chunk starts at the first line beginning in its range of bytes
+	std::vector<const char*> chunk_begin(nbc + 1u);
+	chunk_begin[nbc] = end;
+	parallel_for(nbc, [&] (uint32 c)
 	{
-		uint32 nbe = faces_nb_edges[i];
+		chunk_begin[c] = c == 0u ? begin : next_line(begin + c * CHUNK_SIZE - 1u, end);
+	}, 1u);
 
-		vertices_buffer.clear();
-		uint32 prev = std::numeric_limits<uint32>::max();
-
-		for (uint32 j = 0; j < nbe; ++j)
+	// number of elements in each chunk
+	std::vector<uint32> chunk_first_line(nbc + 1u, 0u);
+	parallel_for(nbc, [&] (uint32 c)
+	{
+		uint32 count = 0u;
+		for (const char* p = chunk_begin[c]; p < chunk_begin[c + 1u]; p = next_line(p, end))
 		{
-			uint32 idx = faces_vertex_indices[faces_vertex_index++];
-			if (idx != prev)
+			const char* t = skip_to_token_in_line(p, end);
+			if (t < end && *t != '\n')
+				++count;
+		}
+		chunk_first_line[c + 1u] = count;
+	}, 1u);
+	for (uint32 c = 0u; c < nbc; ++c)
+		chunk_first_line[c + 1u] += chunk_first_line[c];
+	if (chunk_first_line[nbc] < nb_vertices + nb_faces)
+		return false;
+
+	// parse the elements: the faces of each chunk are stored apart and then concatenated in order
+	std::vector<std::vector<uint32>> chunk_indices(nbc);
+	std::vector<uint8> success(nbc, 1u);
+	parallel_for(nbc, [&] (uint32 c)
+	{
+		uint32 line = chunk_first_line[c];
+		std::vector<uint32>& indices = chunk_indices[c];
+		for (const char* p = chunk_begin[c]; p < chunk_begin[c + 1u] && line < nb_vertices + nb_faces; p = next_line(p, end))
+		{
+			const char* t = skip_to_token_in_line(p, end);
+			if (t == end || *t == '\n')
+				continue;
+			if (line < nb_vertices)
 			{
-				prev = idx;
-				vertices_buffer.push_back(idx);
+				float64* v = &data.vertex_position[3u * line];
+				for (uint32 k = 0u; k < 3u; ++k)
+				{
+					if (k > 0u)
+						t = skip_to_token_in_line(t, end);
+					if (t == end || *t == '\n' || !parse_double(t, end, v[k]))
+					{
+						success[c] = 0u;
+						return;
+					}
+				}
 			}
+			else
+			{
+				uint32& n = data.faces_nb_edges[line - nb_vertices];
+				if (!parse_uint(t, end, n))
+				{
+					success[c] = 0u;
+					return;
+				}
+				for (uint32 k = 0u; k < n; ++k)
+				{
+					uint32 index;
+					t = skip_to_token_in_line(t, end);
+					if (t == end || *t == '\n' || !parse_uint(t, end, index) || index >= nb_vertices)
+					{
+						success[c] = 0u;
+						return;
+					}
+					indices.push_back(index);
+				}
+			}
+			t = skip_to_token_in_line(t, end);
+			if (t < end && *t != '\n' && !(vertex_extras && line < nb_vertices))
+			{
+				success[c] = 0u;
+				return;
+			}
+			++line;
 		}
-		if (vertices_buffer.front() == vertices_buffer.back())
-			vertices_buffer.pop_back();
+	}, 1u);
+	if (std::find(success.begin(), success.end(), 0u) != success.end())
+		return false;
+
+	std::vector<uint32> chunk_offset(nbc + 1u, 0u);
+	for (uint32 c = 0u; c < nbc; ++c)
+		chunk_offset[c + 1u] = chunk_offset[c] + uint32(chunk_indices[c].size());
+	data.faces_vertex_indices.resize(chunk_offset[nbc]);
+	parallel_for(nbc, [&] (uint32 c)
+	{
+		std::copy(chunk_indices[c].begin(), chunk_indices[c].end(), data.faces_vertex_indices.begin() + chunk_offset[c]);
+	}, 1u);
+	return true;
+}
 
-		nbe = vertices_buffer.size();
-		if (nbe > 2)
+/**
+ * parses the content of a binary OFF file after its "OFF BINARY" line, as written by thirdparty/OffBinConverter:
+ * big endian uint32 numbers of vertices, faces and edges, float32 vertex coordinates
+ * and, for each face, its uint32 number of vertices followed by its vertex indices
+ */
+inline bool parse_OFF_binary(const char* p, const char* end, SurfaceImportData& data)
+{
+	if (end - p < 12)
+		return false;
+	uint32 counts[3];
+	std::memcpy(counts, p, 12u);
+	swap_endianness_native_big(counts, 3u);
+	p += 12;
+
+	const uint32 nb_vertices = counts[0];
+	const uint32 nb_faces = counts[1];
+	if (std::size_t(end - p) / 12u < nb_vertices)
+		return false;
+
+	// bulk copy of the blocks (the data in the file is not aligned), then byte swap and conversion in parallel
+	std::vector<float32> coordinates(3u * std::size_t(nb_vertices));
+	std::memcpy(coordinates.data(), p, 12u * std::size_t(nb_vertices));
+	p += 12u * std::size_t(nb_vertices);
+	data.vertex_position.resize(coordinates.size());
+	parallel_foreach_chunk(nb_vertices, [&] (uint32, uint32 begin, uint32 end)
+	{
+		swap_endianness_native_big(&coordinates[3u * begin], 3u * (end - begin));
+		for (uint32 i = 3u * begin; i < 3u * end; ++i)
+			data.vertex_position[i] = float64(coordinates[i]);
+	}, 1u << 16u);
+
+	const std::size_t nb_words = std::size_t(end - p) / 4u;
+	std::vector<uint32> words(nb_words);
+	std::memcpy(words.data(), p, 4u * nb_words);
+	parallel_foreach_chunk(uint32(std::min<std::size_t>(nb_words, std::numeric_limits<uint32>::max())),
+		[&] (uint32, uint32 begin, uint32 end) { swap_endianness_native_big(&words[begin], end - begin); }, 1u << 18u);
+
+	// the faces have variable sizes: find their beginnings, then copy their indices in parallel
+	data.faces_nb_edges.resize(nb_faces);
+	std::vector<std::size_t> face_word(nb_faces);
+	std::size_t w = 0u;
+	for (uint32 f = 0u; f < nb_faces; ++f)
+	{
+		if (w >= nb_words || words[w] > nb_words - w - 1u)
+			return false;
+		face_word[f] = w;
+		data.faces_nb_edges[f] = words[w];
+		w += std::size_t(words[w]) + 1u;
+	}
+	if (w - nb_faces > std::numeric_limits<uint32>::max())
+		return false;
+	data.faces_vertex_indices.resize(w - nb_faces);
+	std::vector<uint8> success(nb_chunks(nb_faces), 1u);
+	parallel_foreach_chunk(nb_faces, [&] (uint32 c, uint32 begin, uint32 end)
+	{
+		for (uint32 f = begin; f < end; ++f)
 		{
-			CMap1::Face f = add_face(static_cast<CMap1&>(m), nbe, false);
-			Dart d = f.dart;
-			for (uint32 j = 0u; j < nbe; ++j)
+			const std::size_t first = face_word[f] + 1u;
+			const std::size_t last = first + data.faces_nb_edges[f];
+			for (std::size_t k = first; k < last; ++k)
 			{
-				const uint32 vertex_index = vertices_buffer[j];
-				m.set_embedding<CMap2::Vertex>(d, vertex_index);
-				(*darts_per_vertex)[vertex_index].push_back(d);
-				d = m.phi1(d);
+				if (words[k] >= nb_vertices)
+					success[c] = 0u;
+				data.faces_vertex_indices[k - f - 1u] = words[k];
 			}
 		}
+	});
+	return std::find(success.begin(), success.end(), 0u) == success.end();
+}
+
+} // namespace internal
+
+/**
+ * \brief reads an OFF file into data
+ * The file is mapped in memory. The binary variant ("OFF BINARY" header) is loaded with bulk copies and byte swaps.
+ * For ASCII files with exactly one vertex or face per line (as usual), the lines are parsed in parallel,
+ * otherwise the file is parsed as a stream of tokens.
+ */
+inline bool parse_OFF(const std::string& filename, SurfaceImportData& data)
+{
+	MappedFile file;
+	if (!file.open(filename))
+	{
+		std::cerr << "Unable to open file \"" << filename << "\"." << std::endl;
+		return false;
 	}
 
-	bool need_vertex_unicity_check = false;
-	uint32 nb_boundary_edges = 0;
+	const char* end = file.end();
+	const char* first_line_end = next_line(file.begin(), end);
+	const std::string first_line(file.begin(), first_line_end);
+	if (first_line.rfind("OFF") == std::string::npos)
+	{
+		std::cerr << "File \"" << filename << "\" is not a valid off file." << std::endl;
+		return false;
+	}
 
-	m.foreach_dart([&] (Dart d) -> bool
+	if (first_line.find("BINARY") != std::string::npos)
 	{
-		if (m.phi2(d) == d)
+		if (!internal::parse_OFF_binary(first_line_end, end, data))
 		{
-			uint32 vertex_index = m.embedding(CMap2::Vertex(d));
+			std::cerr << "File \"" << filename << "\": invalid binary off data." << std::endl;
+			return false;
+		}
+		return true;
+	}
 
-			std::vector<Dart>& next_vertex_darts = value<std::vector<Dart>>(m, darts_per_vertex, CMap2::Vertex(m.phi1(d)));
-			bool phi2_found = false;
-			bool first_OK = true;
+	// read number of vertices, faces, edges
+	uint32 counts[3];
+	const char* p = first_line_end;
+	for (uint32 i = 0u; i < 3u; ++i)
+	{
+		p = skip_to_token(p, end);
+		if (!parse_uint(p, end, counts[i]))
+		{
+			std::cerr << "File \"" << filename << "\": invalid header." << std::endl;
+			return false;
+		}
+	}
+
+	data.vertex_position.resize(3u * counts[0]);
+	data.faces_nb_edges.resize(counts[1]);
+
+	const char* body = p;
+	if (!internal::parse_OFF_lines(next_line(body, end), end, data, internal::OFF_vertex_extras(first_line)) &&
+		!internal::parse_OFF_tokens(body, end, data))
+	{
+		std::cerr << "File \"" << filename << "\": invalid vertex or face data." << std::endl;
+		return false;
+	}
+	return true;
+}
 
-			for (auto it = next_vertex_darts.begin();
-				 it != next_vertex_darts.end() && !phi2_found;
-				 ++it)
+template <typename VEC3>
+void import_OFF(CMap2& m, const std::string& filename)
+{
+	SurfaceImportData data;
+	if (parse_OFF(filename, data))
+		import_surface_data<VEC3>(m, data);
+}
+
+namespace internal
+{
+
+/**
+ * consecutive elements of an OFF file: vertices (the first one being the vertex first_vertex), then faces
+ */
+struct OFFChunk
+{
+	uint32 first_vertex;
+	std::vector<float64> vertex_position;
+	std::vector<uint32> face_offsets;
+	std::vector<uint32> face_indices;
+};
+
+/**
+ * parses the vertices and faces of an ASCII OFF file after its header and pushes them in the queue by chunks:
+ * an element starts on a new line and may continue on the following ones. The values that follow an element
+ * on its last line are only ignored for the vertices if vertex_extras is true (see parse_OFF_lines).
+ * \returns false if the data is invalid or does not follow these lines (or if the queue was closed by the consumer)
+ */
+inline bool stream_OFF_lines(const char* p, const char* end, uint32 nb_vertices, uint32 nb_faces, bool vertex_extras, BoundedQueue<OFFChunk>& queue)
+{
+	static const uint32 CHUNK_SIZE = 1u << 16u;
+
+	const uint32 nb_elements = nb_vertices + nb_faces;
+	uint32 line = 0u;
+	while (line < nb_elements)
+	{
+		OFFChunk chunk;
+		chunk.first_vertex = std::min(line, nb_vertices);
+		chunk.face_offsets.push_back(0u);
+		for (const uint32 last = std::min(nb_elements, line + CHUNK_SIZE); line < last; ++line)
+		{
+			if (line < nb_vertices)
 			{
-				if (m.embedding(CMap2::Vertex(m.phi1(*it))) == vertex_index)
+				for (uint32 k = 0u; k < 3u; ++k)
 				{
-					if (m.phi2(*it) == *it)
-					{
-						m.phi2_sew(d, *it);
-						phi2_found = true;
-					}
-					else
-						first_OK = false;
+					float64 x;
+					p = skip_to_token(p, end);
+					if (!parse_double(p, end, x))
+						return false;
+					chunk.vertex_position.push_back(x);
 				}
 			}
+			else
+			{
+				uint32 n;
+				p = skip_to_token(p, end);
+				if (!parse_uint(p, end, n))
+					return false;
+				for (uint32 k = 0u; k < n; ++k)
+				{
+					uint32 index;
+					p = skip_to_token(p, end);
+					if (!parse_uint(p, end, index) || index >= nb_vertices)
+						return false;
+					chunk.face_indices.push_back(index);
+				}
+				chunk.face_offsets.push_back(uint32(chunk.face_indices.size()));
+			}
+			const char* t = skip_to_token_in_line(p, end);
+			if (t < end && *t != '\n' && !(vertex_extras && line < nb_vertices))
+				return false;
+			p = next_line(p, end);
+		}
+		if (!queue.push(std::move(chunk)))
+			return false;
+	}
+	return true;
+}
 
-			if (!phi2_found)
-				++nb_boundary_edges;
+} // namespace internal
+
+/**
+ * \brief imports an OFF file with a pipeline: a reader thread parses the file
+ * into chunks of vertices and faces passed through a bounded queue, while the calling thread stores the positions
+ * and adds the darts and embeddings of each received chunk (in parallel, see cgogn::internal::add_face_block).
+ * The faces are sewn once the whole file is read. The load time thus approaches the largest of the parse
+ * and build times instead of their sum. Binary OFF files are imported by import_OFF.
+ * If the data is invalid or does not have one element per line (or if the construction throws), the import
+ * is rolled back: the darts and cells it added are removed, as well as the "position" attribute and the vertex
+ * embedding if it created them. The files whose elements do not follow the lines are then imported by import_OFF.
+ */
+template <typename VEC3>
+void import_OFF_streaming(CMap2& m, const std::string& filename)
+{
+	MappedFile file;
+	if (!file.open(filename))
+	{
+		std::cerr << "Unable to open file \"" << filename << "\"." << std::endl;
+		return;
+	}
 
-			if (!first_OK)
-				need_vertex_unicity_check = true;
-		}
-		return true;
-	});
+	const char* end = file.end();
+	const char* first_line_end = next_line(file.begin(), end);
+	const std::string first_line(file.begin(), first_line_end);
+	if (first_line.rfind("OFF") == std::string::npos)
+	{
+		std::cerr << "File \"" << filename << "\" is not a valid off file." << std::endl;
+		return;
+	}
+	if (first_line.find("BINARY") != std::string::npos)
+	{
+		file.close();
+		import_OFF<VEC3>(m, filename);
+		return;
+	}
 
-	if (nb_boundary_edges > 0)
+	uint32 counts[3];
+	const char* p = first_line_end;
+	for (uint32 i = 0u; i < 3u; ++i)
 	{
-//		uint32 nb_holes = mbuild_.close_map();
-//		std::cout << nb_holes << " hole(s) have been closed" << std::endl;;
-		std::cout << nb_boundary_edges << " boundary edges" << std::endl;
+		p = skip_to_token(p, end);
+		if (!parse_uint(p, end, counts[i]))
+		{
+			std::cerr << "File \"" << filename << "\": invalid header." << std::endl;
+			return;
+		}
 	}
+	const uint32 nb_vertices = counts[0];
+	const uint32 nb_faces = counts[1];
+	const bool vertex_extras = internal::OFF_vertex_extras(first_line);
+
+	AttributeContainer& vertex_container = m.attribute_containers_[CMap2::Vertex::ORBIT];
+	const bool vertex_embedded = m.is_embedded<CMap2::Vertex>();
+	const uint32 vertex_size = vertex_container.size();
+	auto position = get_attribute<VEC3, CMap2::Vertex>(m, "position");
+	const bool position_added = position == nullptr;
+	if (!position)
+		position = add_attribute<VEC3, CMap2::Vertex>(m, "position");
+	if (!m.is_embedded<CMap2::Vertex>())
+	{
+		m.create_embedding<CMap2::Vertex>();
+		create_embeddings<CMap2::Vertex>(m);
+	}
+	const uint32 vertex_base = vertex_container.add_lines(nb_vertices);
+	const uint32 dart_base = m.nb_darts();
+	const uint32 face_base = m.attribute_containers_[CMap2::Face::ORBIT].size();
 
-//		if (need_vertex_unicity_check)
-//		{
-//			map_.template enforce_unique_orbit_embedding<Vertex::ORBIT>();
-//			cgogn_log_warning("create_map") << "Import Surface: non manifold vertices detected and corrected";
-//		}
+	// removes what the import added (before the faces are sewn, only darts, vertices and faces are added)
+	auto rollback = [&] ()
+	{
+		m.topology_.truncate(dart_base);
+		vertex_container.truncate(vertex_size);
+		m.attribute_containers_[CMap2::Face::ORBIT].truncate(face_base);
+		if (position_added)
+			vertex_container.remove_attribute(position);
+		if (!vertex_embedded)
+		{
+			m.topology_.remove_attribute(m.embeddings_[CMap2::Vertex::ORBIT]);
+			m.embeddings_[CMap2::Vertex::ORBIT] = nullptr;
+		}
+	};
 
-	delete darts_per_vertex;
+	// stops the reader (a blocked push fails once the queue is closed) and waits for it,
+	// also when the construction throws
+	struct ReaderGuard
+	{
+		BoundedQueue<internal::OFFChunk>& queue_;
+		std::thread& reader_;
+		~ReaderGuard()
+		{
+			queue_.close();
+			reader_.join();
+		}
+	};
+
+	BoundedQueue<internal::OFFChunk> queue(4u);
+	bool valid = true;
+	std::exception_ptr reader_error;
+	try
+	{
+		std::thread reader([&] ()
+		{
+			try
+			{
+				valid = internal::stream_OFF_lines(next_line(p, end), end, nb_vertices, nb_faces, vertex_extras, queue);
+			}
+			catch (...)
+			{
+				valid = false;
+				reader_error = std::current_exception();
+			}
+			queue.close();
+		});
+		ReaderGuard guard{queue, reader};
+
+		internal::OFFChunk chunk;
+		while (queue.pop(chunk))
+		{
+			parallel_for(uint32(chunk.vertex_position.size() / 3u), [&] (uint32 i)
+			{
+				const float64* v = &chunk.vertex_position[3u * i];
+				(*position)[vertex_base + chunk.first_vertex + i] = VEC3{v[0], v[1], v[2]};
+			});
+			if (chunk.face_offsets.size() > 1u)
+				cgogn::internal::add_face_block(m, vertex_base, nb_vertices, chunk.face_offsets, chunk.face_indices);
+		}
+	}
+	catch (...)
+	{
+		rollback();
+		throw;
+	}
+
+	if (reader_error)
+	{
+		rollback();
+		std::rethrow_exception(reader_error);
+	}
+	if (!valid)
+	{
+		// the file is parsed again by parse_OFF, which reports the invalid data
+		rollback();
+		file.close();
+		import_OFF<VEC3>(m, filename);
+		return;
+	}
 
-//		cgogn_assert(map_.template is_well_embedded<Vertex>());
-//		if (map_.template is_embedded<Face::ORBIT>())
-//		{
-//			cgogn_assert(map_.template is_well_embedded<Face>());
-//		}
-//	}
+	position->notify_modification();
+	internal::print_sewing_report(cgogn::internal::sew_face_blocks(m, dart_base));
 }
 
 } // namespace io
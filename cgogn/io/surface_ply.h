@@ -0,0 +1,663 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_IO_SURFACE_PLY_H_
+#define CGOGN_IO_SURFACE_PLY_H_
+
+#include <cgogn/io/surface_import.h>
+#include <cgogn/io/surface_export.h>
+
+#include <cgogn/core/functions/traversals/global.h>
+#include <cgogn/geometry/types/vector_traits.h>
+
+#include <ply.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <string>
+
+namespace cgogn
+{
+
+namespace io
+{
+
+namespace internal
+{
+
+struct PLYProperty
+{
+	std::string name;
+	int32 type;
+	int32 count_type; // type of the number of values of a list
+	bool is_list;
+};
+
+struct PLYElement
+{
+	std::string name;
+	uint32 nb;
+	std::vector<PLYProperty> properties;
+};
+
+inline uint32 PLY_type_size(int32 type)
+{
+	static const uint32 sizes[] = { 0u, 1u, 2u, 4u, 1u, 2u, 4u, 4u, 8u };
+	return type > PLY_StartType && type < PLY_EndType ? sizes[type] : 0u;
+}
+
+template <typename T> struct PLYType;
+template <> struct PLYType<int8> { static const int32 value = PLY_Int8; };
+template <> struct PLYType<int16> { static const int32 value = PLY_Int16; };
+template <> struct PLYType<int32> { static const int32 value = PLY_Int32; };
+template <> struct PLYType<uint8> { static const int32 value = PLY_Uint8; };
+template <> struct PLYType<uint16> { static const int32 value = PLY_Uint16; };
+template <> struct PLYType<uint32> { static const int32 value = PLY_Uint32; };
+template <> struct PLYType<float32> { static const int32 value = PLY_Float32; };
+template <> struct PLYType<float64> { static const int32 value = PLY_Float64; };
+
+inline PropertyType PLY_property_type(int32 type)
+{
+	switch (type)
+	{
+		case PLY_Int8: return PROPERTY_INT8;
+		case PLY_Int16: return PROPERTY_INT16;
+		case PLY_Int32: return PROPERTY_INT32;
+		case PLY_Uint8: return PROPERTY_UINT8;
+		case PLY_Uint16: return PROPERTY_UINT16;
+		case PLY_Uint32: return PROPERTY_UINT32;
+		case PLY_Float32: return PROPERTY_FLOAT32;
+		default: return PROPERTY_FLOAT64;
+	}
+}
+
+/**
+ * reads the header of a PLY file with the ply library
+ * \returns false if the file cannot be opened or its header is invalid
+ */
+inline bool read_PLY_header(const std::string& filename, int32& format, std::vector<PLYElement>& elements, std::size_t& header_size)
+{
+	FILE* fp = std::fopen(filename.c_str(), "rb");
+	if (!fp)
+		return false;
+	PlyFile* ply = read_ply(fp);
+	if (!ply)
+	{
+		std::fclose(fp);
+		return false;
+	}
+
+	format = ply->file_type;
+	const long position = std::ftell(fp);
+	header_size = position < 0 ? 0u : std::size_t(position);
+
+	bool valid = position >= 0;
+	elements.clear();
+	for (int32 i = 0; i < ply->num_elem_types; ++i)
+	{
+		const PlyElement* elem = ply->elems[i];
+		elements.push_back({elem->name, uint32(std::max(elem->num, 0)), {}});
+		for (int32 j = 0; j < elem->nprops; ++j)
+		{
+			const PlyProperty* prop = elem->props[j];
+			const bool is_list = prop->is_list != PLY_SCALAR;
+			elements.back().properties.push_back({prop->name, prop->external_type, is_list ? prop->count_external : 0, is_list});
+			valid &= PLY_type_size(prop->external_type) > 0u && (!is_list || PLY_type_size(prop->count_external) > 0u);
+		}
+	}
+
+	close_ply(ply);
+	free_ply(ply);
+	return valid;
+}
+
+template <typename T>
+inline bool read_PLY_binary_value(const char*& p, const char* end, bool swap, float64& value)
+{
+	if (std::size_t(end - p) < sizeof(T))
+		return false;
+	T x;
+	std::memcpy(&x, p, sizeof(T));
+	if (swap)
+		x = swap_endianness(x);
+	value = float64(x);
+	p += sizeof(T);
+	return true;
+}
+
+/**
+ * reads the values of binary PLY records (swap tells if the byte order of the file is not the native one)
+ */
+struct PLYBinaryReader
+{
+	bool swap;
+
+	bool read(const char*& p, const char* end, int32 type, float64& value) const
+	{
+		switch (type)
+		{
+			case PLY_Int8: return read_PLY_binary_value<int8>(p, end, swap, value);
+			case PLY_Int16: return read_PLY_binary_value<int16>(p, end, swap, value);
+			case PLY_Int32: return read_PLY_binary_value<int32>(p, end, swap, value);
+			case PLY_Uint8: return read_PLY_binary_value<uint8>(p, end, swap, value);
+			case PLY_Uint16: return read_PLY_binary_value<uint16>(p, end, swap, value);
+			case PLY_Uint32: return read_PLY_binary_value<uint32>(p, end, swap, value);
+			case PLY_Float32: return read_PLY_binary_value<float32>(p, end, swap, value);
+			case PLY_Float64: return read_PLY_binary_value<float64>(p, end, swap, value);
+			default: return false;
+		}
+	}
+
+	const char* record_begin(const char* p, const char*) const
+	{
+		return p;
+	}
+
+	// returns the end of the record that starts at p, or nullptr if the data is truncated
+	const char* record_end(const char* p, const char* end, const PLYElement& e) const
+	{
+		for (const PLYProperty& prop : e.properties)
+		{
+			std::size_t size = PLY_type_size(prop.type);
+			if (prop.is_list)
+			{
+				float64 n;
+				if (!read(p, end, prop.count_type, n) || n < 0.0)
+					return nullptr;
+				size *= std::size_t(n);
+			}
+			if (std::size_t(end - p) < size)
+				return nullptr;
+			p += size;
+		}
+		return p;
+	}
+};
+
+/**
+ * reads the values of ASCII PLY records (one record per line)
+ */
+struct PLYASCIIReader
+{
+	bool read(const char*& p, const char* end, int32, float64& value) const
+	{
+		p = skip_to_token_in_line(p, end);
+		return p < end && *p != '\n' && parse_double(p, end, value);
+	}
+
+	const char* record_begin(const char* p, const char* end) const
+	{
+		return skip_to_token(p, end);
+	}
+
+	const char* record_end(const char* p, const char* end, const PLYElement&) const
+	{
+		return next_line(p, end);
+	}
+};
+
+inline bool PLY_index(float64 value, uint32& index)
+{
+	if (!(value >= 0.0 && value <= float64(std::numeric_limits<uint32>::max())) || value != std::floor(value))
+		return false;
+	index = uint32(value);
+	return true;
+}
+
+/**
+ * destination of the values of a scalar property: the value of the i-th record goes to values[i * stride]
+ */
+struct PLYPropertyTarget
+{
+	float64* values;
+	uint32 stride;
+};
+
+/**
+ * parses the records of an element in parallel (records holds their beginnings):
+ * the scalar properties are stored in their targets (if not null) and the values of the list property
+ * index_list (if valid) are stored in list_sizes and list_values (the other lists are skipped)
+ */
+template <typename READER>
+bool parse_PLY_records(
+	const READER& reader,
+	const char* end,
+	const PLYElement& e,
+	const std::vector<const char*>& records,
+	const std::vector<PLYPropertyTarget>& targets,
+	uint32 index_list,
+	std::vector<uint32>& list_sizes,
+	std::vector<uint32>& list_values
+)
+{
+	const uint32 nbc = nb_chunks(e.nb);
+	std::vector<std::vector<uint32>> chunk_values(nbc);
+	std::vector<uint8> success(nbc, 1u);
+	if (index_list != INVALID_INDEX)
+		list_sizes.resize(e.nb);
+
+	parallel_foreach_chunk(e.nb, [&] (uint32 c, uint32 begin, uint32 last)
+	{
+		for (uint32 i = begin; i < last; ++i)
+		{
+			const char* p = records[i];
+			for (uint32 j = 0u; j < e.properties.size(); ++j)
+			{
+				const PLYProperty& prop = e.properties[j];
+				float64 value;
+				if (!prop.is_list)
+				{
+					if (!reader.read(p, end, prop.type, value))
+					{
+						success[c] = 0u;
+						return;
+					}
+					if (targets[j].values)
+						targets[j].values[std::size_t(i) * targets[j].stride] = value;
+					continue;
+				}
+				uint32 n;
+				if (!reader.read(p, end, prop.count_type, value) || !PLY_index(value, n))
+				{
+					success[c] = 0u;
+					return;
+				}
+				if (j == index_list)
+					list_sizes[i] = n;
+				for (uint32 k = 0u; k < n; ++k)
+				{
+					uint32 index;
+					if (!reader.read(p, end, prop.type, value) || (j == index_list && !PLY_index(value, index)))
+					{
+						success[c] = 0u;
+						return;
+					}
+					if (j == index_list)
+						chunk_values[c].push_back(index);
+				}
+			}
+		}
+	});
+	if (std::find(success.begin(), success.end(), 0u) != success.end())
+		return false;
+	if (index_list == INVALID_INDEX)
+		return true;
+
+	std::vector<std::size_t> chunk_offset(nbc + 1u, 0u);
+	for (uint32 c = 0u; c < nbc; ++c)
+		chunk_offset[c + 1u] = chunk_offset[c] + chunk_values[c].size();
+	list_values.resize(chunk_offset[nbc]);
+	parallel_for(nbc, [&] (uint32 c)
+	{
+		std::copy(chunk_values[c].begin(), chunk_values[c].end(), list_values.begin() + chunk_offset[c]);
+	}, 1u);
+	return true;
+}
+
+/**
+ * parses the body of a PLY file: the records of each element are first located sequentially
+ * (a line in ASCII, a fixed or list dependent number of bytes in binary) and then parsed in parallel.
+ * The "vertex" element gives the positions (x, y, z) and the other scalar vertex properties,
+ * the "face" element gives the faces (vertex_indices or vertex_index list) and the other scalar face properties.
+ * The other elements and list properties are skipped.
+ */
+template <typename READER>
+bool parse_PLY_body(const READER& reader, const char* p, const char* end, const std::vector<PLYElement>& elements, SurfaceImportData& data)
+{
+	bool has_vertices = false;
+	bool has_faces = false;
+	std::vector<const char*> records;
+	for (const PLYElement& e : elements)
+	{
+		records.resize(e.nb);
+		for (uint32 i = 0u; i < e.nb; ++i)
+		{
+			p = reader.record_begin(p, end);
+			records[i] = p;
+			p = reader.record_end(p, end, e);
+			if (!p)
+				return false;
+		}
+
+		const bool is_vertex = e.name == "vertex" && !has_vertices;
+		const bool is_face = e.name == "face" && !has_faces;
+		if (!is_vertex && !is_face)
+			continue;
+
+		std::vector<ImportedProperty>& properties = is_vertex ? data.vertex_properties : data.face_properties;
+		std::vector<PLYPropertyTarget> targets(e.properties.size(), PLYPropertyTarget{nullptr, 1u});
+		std::vector<uint32> property_index(e.properties.size(), INVALID_INDEX);
+		uint32 index_list = INVALID_INDEX;
+		uint32 nb_coordinates = 0u;
+		if (is_vertex)
+			data.vertex_position.assign(3u * std::size_t(e.nb), 0.0);
+
+		for (uint32 j = 0u; j < e.properties.size(); ++j)
+		{
+			const PLYProperty& prop = e.properties[j];
+			if (prop.is_list)
+			{
+				if (is_face && index_list == INVALID_INDEX && (prop.name == "vertex_indices" || prop.name == "vertex_index"))
+					index_list = j;
+				continue;
+			}
+			const uint32 coordinate = is_vertex && prop.name.size() == 1u ? uint32(std::string("xyz").find(prop.name[0])) : INVALID_INDEX;
+			if (coordinate < 3u)
+			{
+				targets[j] = PLYPropertyTarget{data.vertex_position.data() + coordinate, 3u};
+				++nb_coordinates;
+			}
+			else
+			{
+				property_index[j] = uint32(properties.size());
+				properties.push_back({prop.name, std::vector<float64>(e.nb), PLY_property_type(prop.type)});
+			}
+		}
+		for (uint32 j = 0u; j < e.properties.size(); ++j)
+		{
+			if (property_index[j] != INVALID_INDEX)
+				targets[j] = PLYPropertyTarget{properties[property_index[j]].values.data(), 1u};
+		}
+
+		if ((is_vertex && nb_coordinates < 3u) || (is_face && index_list == INVALID_INDEX))
+			return false;
+		if (!parse_PLY_records(reader, end, e, records, targets, index_list, data.faces_nb_edges, data.faces_vertex_indices))
+			return false;
+
+		has_vertices |= is_vertex;
+		has_faces |= is_face;
+	}
+	if (!has_vertices || !has_faces)
+		return false;
+
+	const uint32 nb_vertices = data.nb_vertices();
+	const std::vector<uint32>& indices = data.faces_vertex_indices;
+	return parallel_transform_reduce(uint32(indices.size()), true,
+		[] (bool a, bool b) { return a && b; },
+		[&] (uint32 i) { return indices[i] < nb_vertices; });
+}
+
+} // namespace internal
+
+/**
+ * \brief reads a PLY file (ASCII, binary little or big endian) into data
+ * The header is read by the ply library, the body is mapped in memory and parsed by internal::parse_PLY_body.
+ */
+inline bool parse_PLY(const std::string& filename, SurfaceImportData& data)
+{
+	int32 format;
+	std::vector<internal::PLYElement> elements;
+	std::size_t header_size;
+	if (!internal::read_PLY_header(filename, format, elements, header_size))
+	{
+		std::cerr << "File \"" << filename << "\" is not a valid ply file." << std::endl;
+		return false;
+	}
+
+	MappedFile file;
+	if (!file.open(filename) || file.size() < header_size)
+	{
+		std::cerr << "Unable to open file \"" << filename << "\"." << std::endl;
+		return false;
+	}
+
+	const char* body = file.begin() + header_size;
+	const bool success = format == PLY_ASCII ?
+		internal::parse_PLY_body(internal::PLYASCIIReader(), body, file.end(), elements, data) :
+		internal::parse_PLY_body(internal::PLYBinaryReader{(format == PLY_BINARY_LE) != CGOGN_NATIVE_LITTLE_ENDIAN}, body, file.end(), elements, data);
+	if (!success)
+	{
+		std::cerr << "File \"" << filename << "\": invalid vertex or face data." << std::endl;
+		return false;
+	}
+	return true;
+}
+
+template <typename VEC3>
+void import_PLY(CMap2& m, const std::string& filename)
+{
+	SurfaceImportData data;
+	if (parse_PLY(filename, data))
+		import_surface_data<VEC3>(m, data);
+}
+
+namespace internal
+{
+
+/**
+ * scalar column of the exported records: the value of the cell of index l is at data + l * stride
+ */
+struct PLYColumn
+{
+	std::string name;
+	int32 type;
+	const char* data;
+	uint32 stride;
+};
+
+/**
+ * adds a column per component of the given attribute if it is an attribute of T
+ * (the components of vectors are named name_x, name_y, name_z)
+ */
+template <typename T>
+bool add_PLY_columns(const AttributeGen* attribute, std::vector<PLYColumn>& columns)
+{
+	using Scalar = typename geometry::vector_traits<T>::Scalar;
+	static const uint32 SIZE = uint32(geometry::vector_traits<T>::SIZE);
+	static_assert(SIZE <= 3u, "PLY export: unsupported vector size");
+
+	const Attribute<T>* a = dynamic_cast<const Attribute<T>*>(attribute);
+	if (!a)
+		return false;
+	const char* data = static_cast<const char*>(a->data_ptr());
+	for (uint32 k = 0u; k < SIZE; ++k)
+	{
+		const std::string name = SIZE == 1u ? a->name() : a->name() + "_" + "xyz"[k];
+		columns.push_back({name, PLYType<Scalar>::value, data + k * sizeof(Scalar), uint32(sizeof(T))});
+	}
+	return true;
+}
+
+template <typename VEC3>
+bool add_PLY_attribute_columns(const AttributeGen* attribute, std::vector<PLYColumn>& columns)
+{
+	return
+		add_PLY_columns<float64>(attribute, columns) || add_PLY_columns<float32>(attribute, columns) ||
+		add_PLY_columns<int32>(attribute, columns) || add_PLY_columns<uint32>(attribute, columns) ||
+		add_PLY_columns<int16>(attribute, columns) || add_PLY_columns<uint16>(attribute, columns) ||
+		add_PLY_columns<int8>(attribute, columns) || add_PLY_columns<uint8>(attribute, columns) ||
+		add_PLY_columns<VEC3>(attribute, columns);
+}
+
+template <typename T>
+T PLY_value(const char* value)
+{
+	T x;
+	std::memcpy(&x, value, sizeof(T));
+	return x;
+}
+
+/**
+ * appends values to the buffer of a block of records, as text or as binary data in the byte order of the file
+ */
+struct PLYRecordWriter
+{
+	int32 format;
+	bool swap;
+
+	void write(std::vector<char>& buffer, const char* value, int32 type, bool first) const
+	{
+		if (format == PLY_ASCII)
+		{
+			char text[32];
+			char* end = text;
+			switch (type)
+			{
+				case PLY_Int8: end = format_int(text, PLY_value<int8>(value)); break;
+				case PLY_Int16: end = format_int(text, PLY_value<int16>(value)); break;
+				case PLY_Int32: end = format_int(text, PLY_value<int32>(value)); break;
+				case PLY_Uint8: end = format_uint(text, PLY_value<uint8>(value)); break;
+				case PLY_Uint16: end = format_uint(text, PLY_value<uint16>(value)); break;
+				case PLY_Uint32: end = format_uint(text, PLY_value<uint32>(value)); break;
+				case PLY_Float32: end = format_float(text, PLY_value<float32>(value)); break;
+				case PLY_Float64: end = format_double(text, PLY_value<float64>(value)); break;
+			}
+			if (!first)
+				buffer.push_back(' ');
+			buffer.insert(buffer.end(), text, end);
+		}
+		else
+		{
+			const uint32 size = PLY_type_size(type);
+			const std::size_t s = buffer.size();
+			buffer.resize(s + size);
+			if (swap)
+				std::reverse_copy(value, value + size, &buffer[s]);
+			else
+				std::memcpy(&buffer[s], value, size);
+		}
+	}
+
+	void end_record(std::vector<char>& buffer) const
+	{
+		if (format == PLY_ASCII)
+			buffer.push_back('\n');
+	}
+};
+
+} // namespace internal
+
+/**
+ * \brief writes a surface in a PLY file of the given format (PLY_ASCII, PLY_BINARY_LE or PLY_BINARY_BE)
+ * The vertices are numbered in traversal order and the given vertex and face attributes are written as properties:
+ * scalar attributes (of the PLY types) keep their type and name, the VEC3 ones give 3 properties name_x, name_y, name_z.
+ * The header is written by the ply library; the records are formatted in parallel by blocks (see internal::write_records).
+ */
+template <typename VEC3>
+bool export_PLY(
+	const CMap2& m,
+	const Attribute<VEC3>* vertex_position,
+	const std::string& filename,
+	int32 format = PLY_BINARY_LE,
+	const std::vector<const AttributeGen*>& vertex_attributes = {},
+	const std::vector<const AttributeGen*>& face_attributes = {}
+)
+{
+	std::vector<internal::PLYColumn> vertex_columns;
+	internal::add_PLY_columns<VEC3>(vertex_position, vertex_columns);
+	vertex_columns[0].name = "x";
+	vertex_columns[1].name = "y";
+	vertex_columns[2].name = "z";
+	std::vector<internal::PLYColumn> face_columns;
+	for (uint32 k = 0u; k < 2u; ++k)
+	{
+		for (const AttributeGen* a : k == 0u ? vertex_attributes : face_attributes)
+		{
+			if (!internal::add_PLY_attribute_columns<VEC3>(a, k == 0u ? vertex_columns : face_columns))
+				std::cerr << "export_PLY: attribute \"" << a->name() << "\" has an unsupported type" << std::endl;
+		}
+	}
+
+	const internal::SurfaceExportCells cells(m);
+	const std::vector<CMap2::Vertex>& vertices = cells.vertices;
+	const std::vector<CMap2::Face>& faces = cells.faces;
+	const std::vector<uint32>& vertex_id = cells.vertex_id;
+	auto face_degree = [&] (uint32 i) -> uint32 { return internal::face_degree(m, faces[i]); };
+	const uint32 max_degree = parallel_transform_reduce(uint32(faces.size()), 0u,
+		[] (uint32 a, uint32 b) { return std::max(a, b); }, face_degree);
+	const int32 count_type = max_degree < 256u ? PLY_Uint8 : PLY_Uint32;
+
+	FILE* fp = std::fopen(filename.c_str(), "wb");
+	if (!fp)
+	{
+		std::cerr << "Unable to open file \"" << filename << "\"." << std::endl;
+		return false;
+	}
+
+	// header
+	char vertex_name[] = "vertex";
+	char face_name[] = "face";
+	char indices_name[] = "vertex_indices";
+	char* element_names[] = { vertex_name, face_name };
+	PlyFile* ply = write_ply(fp, 2, element_names, format);
+	auto describe_columns = [&] (const std::vector<internal::PLYColumn>& columns)
+	{
+		for (const internal::PLYColumn& column : columns)
+		{
+			PlyProperty prop = { const_cast<char*>(column.name.c_str()), column.type, column.type, 0, PLY_SCALAR, 0, 0, 0 };
+			describe_property_ply(ply, &prop);
+		}
+	};
+	describe_element_ply(ply, vertex_name, int32(vertices.size()));
+	describe_columns(vertex_columns);
+	describe_element_ply(ply, face_name, int32(faces.size()));
+	PlyProperty indices_prop = { indices_name, PLY_Uint32, PLY_Uint32, 0, PLY_LIST, count_type, count_type, 0 };
+	describe_property_ply(ply, &indices_prop);
+	describe_columns(face_columns);
+	header_complete_ply(ply);
+
+	// records
+	const internal::PLYRecordWriter writer{format, (format == PLY_BINARY_LE) != CGOGN_NATIVE_LITTLE_ENDIAN};
+	bool success = internal::write_records(fp, uint32(vertices.size()), [&] (std::vector<char>& buffer, uint32 i)
+	{
+		const std::size_t line = index_of(m, vertices[i]);
+		for (uint32 j = 0u; j < vertex_columns.size(); ++j)
+			writer.write(buffer, vertex_columns[j].data + line * vertex_columns[j].stride, vertex_columns[j].type, j == 0u);
+		writer.end_record(buffer);
+	});
+	success = success && internal::write_records(fp, uint32(faces.size()), [&] (std::vector<char>& buffer, uint32 i)
+	{
+		const uint32 n = face_degree(i);
+		const uint8 n8 = uint8(n);
+		writer.write(buffer, count_type == PLY_Uint8 ? reinterpret_cast<const char*>(&n8) : reinterpret_cast<const char*>(&n), count_type, true);
+		Dart d = faces[i].dart;
+		do
+		{
+			const uint32 id = vertex_id[index_of(m, CMap2::Vertex(d))];
+			writer.write(buffer, reinterpret_cast<const char*>(&id), PLY_Uint32, false);
+			d = m.phi1(d);
+		} while (d != faces[i].dart);
+		if (!face_columns.empty())
+		{
+			const std::size_t line = index_of(m, faces[i]);
+			for (const internal::PLYColumn& column : face_columns)
+				writer.write(buffer, column.data + line * column.stride, column.type, false);
+		}
+		writer.end_record(buffer);
+	});
+	success = success && !std::ferror(fp);
+
+	close_ply(ply);
+	free_ply(ply);
+	if (!success)
+		std::cerr << "Error while writing file \"" << filename << "\"." << std::endl;
+	return success;
+}
+
+} // namespace io
+
+} // namespace cgogn
+
+#endif // CGOGN_IO_SURFACE_PLY_H_
@@ -0,0 +1,337 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_IO_SURFACE_STL_H_
+#define CGOGN_IO_SURFACE_STL_H_
+
+#include <cgogn/io/surface_import.h>
+
+#include <cgogn/core/utils/radix_sort.h>
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+
+namespace cgogn
+{
+
+namespace io
+{
+
+namespace internal
+{
+
+inline uint64 hash_combine(uint64 h, uint64 v)
+{
+	// splitmix64 finalizer
+	h ^= v + 0x9e3779b97f4a7c15ull + (h << 6u) + (h >> 2u);
+	h = (h ^ (h >> 30u)) * 0xbf58476d1ce4e5b9ull;
+	h = (h ^ (h >> 27u)) * 0x94d049bb133111ebull;
+	return h ^ (h >> 31u);
+}
+
+inline uint64 hash_coordinates(const float64* p)
+{
+	uint64 h = 0u;
+	for (uint32 k = 0u; k < 3u; ++k)
+	{
+		const float64 x = p[k] == 0.0 ? 0.0 : p[k]; // -0 and +0
+		uint64 bits;
+		std::memcpy(&bits, &x, sizeof(bits));
+		h = hash_combine(h, bits);
+	}
+	return h;
+}
+
+// cell coordinates packed on 21 bits each: the cells of far away points may share a key
+// (weld_points then compares points of distinct cells, which it filters by distance)
+inline uint64 cell_key(int64 x, int64 y, int64 z)
+{
+	static const uint64 MASK = (uint64(1) << 21u) - 1u;
+	return ((uint64(x) & MASK) << 42u) | ((uint64(y) & MASK) << 21u) | (uint64(z) & MASK);
+}
+
+/**
+ * \brief welds the given points (3 coordinates each): two points at most epsilon apart belong to the same vertex,
+ * as well as the points connected by such pairs (with epsilon = 0, the points with the same coordinates).
+ * point_vertex receives the vertex of each point, the vertices being numbered in order of their first point,
+ * whose coordinates they take.
+ * The points with the same coordinates are first merged by sorting the hashes of their coordinates (parallel radix sort).
+ * The remaining distinct points are then sorted by cells of size 2 * epsilon: each one is compared to the points
+ * of the cells that are at most epsilon away (its own cell and usually 7 neighbors, on the closest side along each axis),
+ * found by binary search in the sorted cell keys. The points are visited in the order of their cells,
+ * so that the successive searches access neighboring parts of the keys.
+ */
+inline void weld_points(
+	const std::vector<float64>& points,
+	float64 epsilon,
+	std::vector<uint32>& point_vertex,
+	std::vector<float64>& vertex_position
+)
+{
+	const uint32 nb_points = uint32(points.size() / 3u);
+	auto same_coordinates = [&] (uint32 a, uint32 b) -> bool
+	{
+		return points[3u * a] == points[3u * b] && points[3u * a + 1u] == points[3u * b + 1u] && points[3u * a + 2u] == points[3u * b + 2u];
+	};
+
+	// first point of each point with the same coordinates
+	std::vector<uint64> keys(nb_points);
+	std::vector<uint32> point_index(nb_points);
+	parallel_for(nb_points, [&] (uint32 i)
+	{
+		keys[i] = hash_coordinates(&points[3u * i]);
+		point_index[i] = i;
+	});
+	parallel_radix_sort(keys, point_index);
+
+	// each group of equal hashes is processed by the chunk in which it begins;
+	// the sort is stable: the points of a group are in increasing order
+	std::vector<uint32> first_point(nb_points);
+	parallel_foreach_chunk(nb_points, [&] (uint32, uint32 begin, uint32 end)
+	{
+		std::vector<uint32> firsts;
+		for (uint32 i = begin; i < end; ++i)
+		{
+			if (i > 0u && keys[i] == keys[i - 1u])
+				continue;
+			firsts.clear();
+			for (uint32 j = i; j < nb_points && keys[j] == keys[i]; ++j)
+			{
+				const uint32 p = point_index[j];
+				auto it = std::find_if(firsts.begin(), firsts.end(), [&] (uint32 f) { return same_coordinates(f, p); });
+				if (it == firsts.end())
+				{
+					firsts.push_back(p);
+					first_point[p] = p;
+				}
+				else
+					first_point[p] = *it;
+			}
+		}
+	});
+	std::vector<uint64>().swap(keys);
+	std::vector<uint32>().swap(point_index);
+
+	// distinct points, in increasing order; first_point then gives the distinct point of each point
+	std::vector<uint32> distinct;
+	for (uint32 i = 0u; i < nb_points; ++i)
+	{
+		if (first_point[i] == i)
+		{
+			first_point[i] = uint32(distinct.size());
+			distinct.push_back(i);
+		}
+		else
+			first_point[i] = first_point[first_point[i]];
+	}
+	const uint32 nb_distinct = uint32(distinct.size());
+
+	// representative of each distinct point (the smallest one of its cluster)
+	std::vector<uint32> root(nb_distinct);
+	for (uint32 i = 0u; i < nb_distinct; ++i)
+		root[i] = i;
+	if (epsilon > 0.0)
+	{
+		const float64 cell_size = 2.0 * epsilon;
+		auto cell = [&] (uint32 i, uint32 k) -> int64 { return int64(std::floor(points[3u * distinct[i] + k] / cell_size)); };
+		std::vector<uint64> cell_keys(nb_distinct);
+		std::vector<uint32> cell_index(nb_distinct);
+		parallel_for(nb_distinct, [&] (uint32 i)
+		{
+			cell_keys[i] = cell_key(cell(i, 0u), cell(i, 1u), cell(i, 2u));
+			cell_index[i] = i;
+		});
+		parallel_radix_sort(cell_keys, cell_index, 63u);
+
+		// pairs (a, b), a < b, of distinct points at most epsilon apart;
+		// each cell (group of equal keys) is processed by the chunk in which it begins
+		const float64 epsilon2 = epsilon * epsilon;
+		std::vector<std::vector<std::pair<uint32, uint32>>> chunk_pairs(nb_chunks(nb_distinct));
+		parallel_foreach_chunk(nb_distinct, [&] (uint32 c, uint32 begin, uint32 end)
+		{
+			auto compare = [&] (uint32 a, uint32 b)
+			{
+				const float64* pa = &points[3u * distinct[a]];
+				const float64* pb = &points[3u * distinct[b]];
+				const float64 d2 = (pa[0] - pb[0]) * (pa[0] - pb[0]) + (pa[1] - pb[1]) * (pa[1] - pb[1]) + (pa[2] - pb[2]) * (pa[2] - pb[2]);
+				if (d2 <= epsilon2)
+					chunk_pairs[c].emplace_back(std::min(a, b), std::max(a, b));
+			};
+			for (uint32 i = begin; i < end; ++i)
+			{
+				if (i > 0u && cell_keys[i] == cell_keys[i - 1u])
+					continue;
+				uint32 j = i + 1u;
+				while (j < nb_distinct && cell_keys[j] == cell_keys[i])
+					++j;
+
+				// pairs within the cell
+				for (uint32 k = i; k < j; ++k)
+					for (uint32 l = k + 1u; l < j; ++l)
+						compare(cell_index[k], cell_index[l]);
+
+				// neighbor cells closer than epsilon to each point: along each axis, a point is compared to the points
+				// of the previous (resp. next) cell if it is at most epsilon from the lower (resp. upper) side of its cell.
+				// The neighbor keys are computed from the cell of the point: the points of the group may come from
+				// other cells whose key collides with this one (the collisions only add candidates)
+				for (uint32 k = i; k < j; ++k)
+				{
+					const uint32 a = cell_index[k];
+					const float64* p = &points[3u * distinct[a]];
+					int64 x[3];
+					bool lower[3], upper[3];
+					for (uint32 axis = 0u; axis < 3u; ++axis)
+					{
+						x[axis] = cell(a, axis);
+						const float64 offset = p[axis] - float64(x[axis]) * cell_size;
+						lower[axis] = offset <= epsilon;
+						upper[axis] = cell_size - offset <= epsilon;
+					}
+					for (uint32 n = 0u; n < 27u; ++n)
+					{
+						const int64 d[3] = { int64(n % 3u) - 1, int64(n / 3u % 3u) - 1, int64(n / 9u) - 1 };
+						if (n == 13u || (d[0] < 0 && !lower[0]) || (d[0] > 0 && !upper[0]) ||
+							(d[1] < 0 && !lower[1]) || (d[1] > 0 && !upper[1]) || (d[2] < 0 && !lower[2]) || (d[2] > 0 && !upper[2]))
+							continue;
+						const uint64 key = cell_key(x[0] + d[0], x[1] + d[1], x[2] + d[2]);
+						auto range = std::equal_range(cell_keys.begin(), cell_keys.end(), key);
+						// each pair of neighbor points is usually found from both points (union-find ignores the repeated pairs)
+						for (auto it = range.first; it != range.second; ++it)
+						{
+							const uint32 b = cell_index[std::size_t(it - cell_keys.begin())];
+							if (b != a)
+								compare(a, b);
+						}
+					}
+				}
+			}
+		});
+
+		// clusters: union-find, the root of a set being its smallest point
+		auto find = [&] (uint32 i) -> uint32
+		{
+			while (root[i] != i)
+			{
+				root[i] = root[root[i]];
+				i = root[i];
+			}
+			return i;
+		};
+		for (const std::vector<std::pair<uint32, uint32>>& pairs : chunk_pairs)
+		{
+			for (const std::pair<uint32, uint32>& p : pairs)
+			{
+				const uint32 a = find(p.first);
+				const uint32 b = find(p.second);
+				if (a != b)
+					root[std::max(a, b)] = std::min(a, b);
+			}
+		}
+		for (uint32 i = 0u; i < nb_distinct; ++i)
+			root[i] = root[root[i]]; // the roots are smaller: they are already final
+	}
+
+	// vertices: the roots, in increasing order
+	std::vector<uint32> distinct_vertex(nb_distinct);
+	uint32 nb_vertices = 0u;
+	for (uint32 i = 0u; i < nb_distinct; ++i)
+		distinct_vertex[i] = root[i] == i ? nb_vertices++ : distinct_vertex[root[i]];
+	vertex_position.resize(3u * std::size_t(nb_vertices));
+	parallel_for(nb_distinct, [&] (uint32 i)
+	{
+		if (root[i] == i)
+			std::copy(&points[3u * distinct[i]], &points[3u * distinct[i]] + 3u, &vertex_position[3u * distinct_vertex[i]]);
+	});
+
+	point_vertex.resize(nb_points);
+	parallel_for(nb_points, [&] (uint32 i) { point_vertex[i] = distinct_vertex[first_point[i]]; });
+}
+
+} // namespace internal
+
+/**
+ * \brief reads a binary STL file into data: the corners of the triangles are welded by internal::weld_points
+ * (epsilon = 0 welds the corners with the same coordinates). The normals of the file are ignored.
+ * The file is mapped in memory and the triangles are decoded in parallel.
+ */
+inline bool parse_STL(const std::string& filename, SurfaceImportData& data, float64 epsilon = 0.0)
+{
+	MappedFile file;
+	if (!file.open(filename))
+	{
+		std::cerr << "Unable to open file \"" << filename << "\"." << std::endl;
+		return false;
+	}
+
+	uint32 nb_triangles = 0u;
+	if (file.size() >= 84u)
+	{
+		std::memcpy(&nb_triangles, file.data() + 80, sizeof(uint32));
+		nb_triangles = swap_endianness_native_little(nb_triangles);
+	}
+	if (file.size() < 84u || (file.size() - 84u) / 50u < nb_triangles)
+	{
+		std::cerr << "File \"" << filename << "\" is not a valid binary stl file." << std::endl;
+		return false;
+	}
+
+	// record of a triangle: normal, 3 corners (float32 coordinates, little endian) and a 16 bits attribute
+	std::vector<float64> points(9u * std::size_t(nb_triangles));
+	parallel_foreach_chunk(nb_triangles, [&] (uint32, uint32 begin, uint32 end)
+	{
+		for (uint32 t = begin; t < end; ++t)
+		{
+			float32 corners[9];
+			std::memcpy(corners, file.data() + 84u + 50u * std::size_t(t) + 12u, sizeof(corners));
+			swap_endianness_native_little(corners, 9u);
+			for (uint32 k = 0u; k < 9u; ++k)
+				points[9u * std::size_t(t) + k] = float64(corners[k]);
+		}
+	}, 1u << 14u);
+
+	internal::weld_points(points, epsilon, data.faces_vertex_indices, data.vertex_position);
+	data.faces_nb_edges.assign(nb_triangles, 3u);
+	return true;
+}
+
+/**
+ * \brief imports a binary STL file: the corners of the triangles at most epsilon apart are welded into vertices
+ * and the faces are built by build_faces (the faces that become degenerate are skipped)
+ */
+template <typename VEC3>
+void import_STL(CMap2& m, const std::string& filename, float64 epsilon = 0.0)
+{
+	SurfaceImportData data;
+	if (parse_STL(filename, data, epsilon))
+		import_surface_data<VEC3>(m, data);
+}
+
+} // namespace io
+
+} // namespace cgogn
+
+#endif // CGOGN_IO_SURFACE_STL_H_
@@ -0,0 +1,144 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <cgogn/io/map_snapshot.h>
+
+#include "test_meshes.h"
+
+#include <cstdio>
+
+namespace cgogn
+{
+
+using test::Vec3;
+
+/**
+ * \brief fixture: a closed grid (with boundary faces) with vertex, edge and face attributes
+ */
+class MapSnapshotTest : public ::testing::Test
+{
+protected:
+
+	CMap2 map_;
+	Attribute<Vec3>* position_;
+	Attribute<uint8>* flag_;
+	Attribute<float32>* area_;
+	std::string filename_;
+
+	MapSnapshotTest() : filename_(test::temporary_file("snapshot.map"))
+	{
+		position_ = test::build_grid(map_, 30u, 20u);
+		flag_ = add_attribute<uint8, CMap2::Edge>(map_, "flag");
+		area_ = add_attribute<float32, CMap2::Face>(map_, "area");
+		uint32 i = 0u;
+		foreach_cell(map_, [&] (CMap2::Edge e) -> bool { value<uint8>(map_, flag_, e) = uint8(i++ % 3u); return true; });
+		foreach_cell(map_, [&] (CMap2::Face f) -> bool { value<float32>(map_, area_, f) = float32(i++) / 3.0f; return true; });
+	}
+
+	~MapSnapshotTest() override
+	{
+		std::remove(filename_.c_str());
+	}
+};
+
+TEST_F(MapSnapshotTest, RoundTrip)
+{
+	ASSERT_TRUE(io::save_map_snapshot(map_, filename_));
+
+	CMap2 m;
+	ASSERT_TRUE(io::load_map_snapshot(m, filename_));
+	EXPECT_EQ(m.nb_darts(), map_.nb_darts());
+	for (uint32 i = 0u; i < map_.nb_darts(); ++i)
+	{
+		const Dart d(i);
+		EXPECT_EQ(m.phi1(d), map_.phi1(d));
+		EXPECT_EQ(m.phi2(d), map_.phi2(d));
+		EXPECT_EQ(m.is_boundary(d), map_.is_boundary(d));
+	}
+	EXPECT_EQ(nb_cells<CMap2::Vertex>(m), nb_cells<CMap2::Vertex>(map_));
+	EXPECT_EQ(nb_cells<CMap2::Edge>(m), nb_cells<CMap2::Edge>(map_));
+	EXPECT_EQ(nb_cells<CMap2::Face>(m), nb_cells<CMap2::Face>(map_));
+
+	Attribute<Vec3>* position = get_attribute<Vec3, CMap2::Vertex>(m, "position");
+	Attribute<uint8>* flag = get_attribute<uint8, CMap2::Edge>(m, "flag");
+	Attribute<float32>* area = get_attribute<float32, CMap2::Face>(m, "area");
+	ASSERT_NE(position, nullptr);
+	ASSERT_NE(flag, nullptr);
+	ASSERT_NE(area, nullptr);
+	EXPECT_EQ(test::face_positions(m, position), test::face_positions(map_, position_));
+	EXPECT_EQ(test::face_values(m, area), test::face_values(map_, area_));
+	foreach_cell(m, [&] (CMap2::Edge e) -> bool
+	{
+		EXPECT_EQ(value<uint8>(m, flag, e), value<uint8>(map_, flag_, e));
+		return true;
+	});
+
+	// the loaded map can be modified and grown
+	const uint32 nb_darts = m.nb_darts();
+	add_face(m, 4u);
+	EXPECT_EQ(m.nb_darts(), nb_darts + 8u);
+	EXPECT_EQ(test::face_positions(m, position).size(), test::face_positions(map_, position_).size() + 1u);
+}
+
+TEST_F(MapSnapshotTest, ExistingAttributes)
+{
+	ASSERT_TRUE(io::save_map_snapshot(map_, filename_));
+
+	// an attribute of the same name and type is used
+	CMap2 m;
+	Attribute<Vec3>* position = add_attribute<Vec3, CMap2::Vertex>(m, "position");
+	ASSERT_TRUE(io::load_map_snapshot(m, filename_));
+	EXPECT_EQ((get_attribute<Vec3, CMap2::Vertex>(m, "position")), position);
+	EXPECT_EQ(test::face_positions(m, position), test::face_positions(map_, position_));
+	uint32 nb_position = 0u;
+	for (const AttributeGen* a : m.attribute_containers_[CMap2::Vertex::ORBIT])
+		nb_position += a->name() == "position" ? 1u : 0u;
+	EXPECT_EQ(nb_position, 1u);
+
+	// an attribute of the same name and of another type makes the loading fail without changing the map
+	CMap2 m2;
+	add_attribute<float64, CMap2::Face>(m2, "area");
+	EXPECT_FALSE(io::load_map_snapshot(m2, filename_));
+	EXPECT_EQ(m2.nb_darts(), 0u);
+	EXPECT_EQ((get_attribute<Vec3, CMap2::Vertex>(m2, "position")), nullptr);
+	EXPECT_EQ((get_attribute<float32, CMap2::Face>(m2, "area")), nullptr);
+}
+
+TEST_F(MapSnapshotTest, NonEmptyMap)
+{
+	ASSERT_TRUE(io::save_map_snapshot(map_, filename_));
+	CMap2 m;
+	add_face(m, 3u);
+	EXPECT_FALSE(io::load_map_snapshot(m, filename_));
+}
+
+TEST_F(MapSnapshotTest, OtherMapType)
+{
+	ASSERT_TRUE(io::save_map_snapshot(map_, filename_));
+	CMap3 m;
+	EXPECT_FALSE(io::load_map_snapshot(m, filename_));
+}
+
+} // namespace cgogn
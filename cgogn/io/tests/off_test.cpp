@@ -0,0 +1,215 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <cgogn/io/surface_import.h>
+#include <cgogn/io/surface_export.h>
+
+#include "test_meshes.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+namespace cgogn
+{
+
+using test::Vec3;
+
+namespace
+{
+
+void write_file(const std::string& filename, const std::string& content)
+{
+	std::ofstream out(filename.c_str(), std::ios::binary);
+	out << content;
+}
+
+} // namespace
+
+TEST(OFFTest, RoundTrip)
+{
+	CMap2 m;
+	Attribute<Vec3>* position = test::build_grid(m, 30u, 20u);
+	const std::string filename = test::temporary_file("round_trip.off");
+	ASSERT_TRUE(io::export_OFF(m, position, filename));
+
+	CMap2 m2;
+	io::import_OFF<Vec3>(m2, filename);
+	Attribute<Vec3>* position2 = get_attribute<Vec3, CMap2::Vertex>(m2, "position");
+	ASSERT_NE(position2, nullptr);
+	EXPECT_EQ(nb_cells<CMap2::Vertex>(m2), nb_cells<CMap2::Vertex>(m));
+	// the coordinates are written with Grisu2: they are read back exactly
+	EXPECT_EQ(test::face_positions(m2, position2), test::face_positions(m, position));
+	std::remove(filename.c_str());
+}
+
+TEST(OFFTest, BinaryRoundTrip)
+{
+	CMap2 m;
+	Attribute<Vec3>* position = test::build_grid(m, 30u, 20u);
+	const std::string filename = test::temporary_file("round_trip_binary.off");
+	ASSERT_TRUE(io::export_OFF(m, position, filename, true));
+
+	CMap2 m2;
+	io::import_OFF<Vec3>(m2, filename);
+	Attribute<Vec3>* position2 = get_attribute<Vec3, CMap2::Vertex>(m2, "position");
+	ASSERT_NE(position2, nullptr);
+	EXPECT_EQ(nb_cells<CMap2::Vertex>(m2), nb_cells<CMap2::Vertex>(m));
+	// the binary variant stores float32 coordinates
+	const std::vector<std::vector<Vec3>> expected = test::face_positions(m, position);
+	const std::vector<std::vector<Vec3>> imported = test::face_positions(m2, position2);
+	ASSERT_EQ(imported.size(), expected.size());
+	for (std::size_t i = 0u; i < expected.size(); ++i)
+	{
+		ASSERT_EQ(imported[i].size(), expected[i].size());
+		for (std::size_t j = 0u; j < expected[i].size(); ++j)
+			for (int32 k = 0; k < 3; ++k)
+				EXPECT_EQ(imported[i][j][k], float64(float32(expected[i][j][k])));
+	}
+	std::remove(filename.c_str());
+}
+
+TEST(OFFTest, TruncatedBinary)
+{
+	CMap2 m;
+	Attribute<Vec3>* position = test::build_grid(m, 4u, 4u);
+	const std::string filename = test::temporary_file("truncated_binary.off");
+	ASSERT_TRUE(io::export_OFF(m, position, filename, true));
+	std::string content;
+	{
+		std::ifstream in(filename.c_str(), std::ios::binary);
+		content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+	write_file(filename, content.substr(0u, content.size() - 5u));
+	io::SurfaceImportData data;
+	EXPECT_FALSE(io::parse_OFF(filename, data));
+	std::remove(filename.c_str());
+}
+
+TEST(OFFTest, SeveralElementsPerLine)
+{
+	// the line parser must not take the second vertex of a line for extra values
+	const std::string filename = test::temporary_file("tokens.off");
+	write_file(filename, "OFF\n4 2 0\n0 0 0 1 0 0\n0 1 0\n1 1 0\n3 0 1 2 3 1 3 2\n");
+	io::SurfaceImportData data;
+	ASSERT_TRUE(io::parse_OFF(filename, data));
+	ASSERT_EQ(data.nb_vertices(), 4u);
+	EXPECT_EQ(data.vertex_position, std::vector<float64>({0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0}));
+	EXPECT_EQ(data.faces_nb_edges, std::vector<uint32>({3u, 3u}));
+	EXPECT_EQ(data.faces_vertex_indices, std::vector<uint32>({0u, 1u, 2u, 1u, 3u, 2u}));
+	std::remove(filename.c_str());
+}
+
+TEST(OFFTest, SplitElementsAndComments)
+{
+	const std::string filename = test::temporary_file("split.off");
+	write_file(filename, "OFF # comment\n4 2 0\n0 0\n0\n1 0 0 # comment\n\n0 1 0\n1 1 0\n3 0 1\n 2\n3 1 3 2\n");
+	io::SurfaceImportData data;
+	ASSERT_TRUE(io::parse_OFF(filename, data));
+	EXPECT_EQ(data.vertex_position, std::vector<float64>({0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0}));
+	EXPECT_EQ(data.faces_vertex_indices, std::vector<uint32>({0u, 1u, 2u, 1u, 3u, 2u}));
+	std::remove(filename.c_str());
+}
+
+TEST(OFFTest, VertexColors)
+{
+	const std::string filename = test::temporary_file("colors.off");
+	write_file(filename, "COFF\n4 2 0\n0 0 0 255 0 0 255\n1 0 0 255 0 0 255\n0 1 0 0 255 0 255\n1 1 0 0 0 255 255\n3 0 1 2\n3 1 3 2\n");
+	io::SurfaceImportData data;
+	ASSERT_TRUE(io::parse_OFF(filename, data));
+	EXPECT_EQ(data.vertex_position, std::vector<float64>({0, 0, 0, 1, 0, 0, 0, 1, 0, 1, 1, 0}));
+	EXPECT_EQ(data.faces_vertex_indices, std::vector<uint32>({0u, 1u, 2u, 1u, 3u, 2u}));
+	std::remove(filename.c_str());
+}
+
+TEST(OFFTest, InvalidIndex)
+{
+	const std::string filename = test::temporary_file("invalid.off");
+	write_file(filename, "OFF\n3 1 0\n0 0 0\n1 0 0\n0 1 0\n3 0 1 3\n");
+	io::SurfaceImportData data;
+	EXPECT_FALSE(io::parse_OFF(filename, data));
+	std::remove(filename.c_str());
+}
+
+TEST(OFFTest, StreamingRoundTrip)
+{
+	CMap2 m;
+	Attribute<Vec3>* position = test::build_grid(m, 30u, 20u);
+	const std::string filename = test::temporary_file("streaming.off");
+	ASSERT_TRUE(io::export_OFF(m, position, filename));
+
+	CMap2 m2;
+	io::import_OFF_streaming<Vec3>(m2, filename);
+	std::remove(filename.c_str());
+	Attribute<Vec3>* position2 = get_attribute<Vec3, CMap2::Vertex>(m2, "position");
+	ASSERT_NE(position2, nullptr);
+	EXPECT_EQ(nb_cells<CMap2::Vertex>(m2), nb_cells<CMap2::Vertex>(m));
+	EXPECT_EQ(test::face_positions(m2, position2), test::face_positions(m, position));
+}
+
+TEST(OFFTest, StreamingSeveralElementsPerLine)
+{
+	// the lines do not hold one element each: the file is imported by import_OFF
+	const std::string filename = test::temporary_file("streaming_tokens.off");
+	write_file(filename, "OFF\n4 2 0\n0 0 0 1 0 0\n0 1 0\n1 1 0\n3 0 1 2 3 1 3 2\n");
+	CMap2 m;
+	io::import_OFF_streaming<Vec3>(m, filename);
+	std::remove(filename.c_str());
+	Attribute<Vec3>* position = get_attribute<Vec3, CMap2::Vertex>(m, "position");
+	ASSERT_NE(position, nullptr);
+	EXPECT_EQ(nb_cells<CMap2::Vertex>(m), 4u);
+	EXPECT_EQ(test::face_positions(m, position), std::vector<std::vector<Vec3>>({
+		{Vec3(0, 0, 0), Vec3(1, 0, 0), Vec3(0, 1, 0)}, {Vec3(1, 0, 0), Vec3(1, 1, 0), Vec3(0, 1, 0)}
+	}));
+}
+
+TEST(OFFTest, StreamingInvalidIndex)
+{
+	const std::string filename = test::temporary_file("streaming_invalid.off");
+	write_file(filename, "OFF\n3 2 0\n0 0 0\n1 0 0\n0 1 0\n3 0 1 2\n3 0 1 3\n");
+
+	// the map is left unchanged: no darts, no position attribute and no vertex embedding
+	CMap2 m;
+	io::import_OFF_streaming<Vec3>(m, filename);
+	EXPECT_EQ(m.nb_darts(), 0u);
+	EXPECT_EQ((get_attribute<Vec3, CMap2::Vertex>(m, "position")), nullptr);
+	EXPECT_FALSE(m.is_embedded<CMap2::Vertex>());
+	EXPECT_EQ(m.attribute_containers_[CMap2::Vertex::ORBIT].size(), 0u);
+
+	// the existing cells and attributes are kept
+	CMap2 m2;
+	Attribute<Vec3>* position = test::build_grid(m2, 3u, 2u);
+	const std::vector<std::vector<Vec3>> faces = test::face_positions(m2, position);
+	const uint32 nb_darts = m2.nb_darts();
+	const uint32 nb_vertex_lines = m2.attribute_containers_[CMap2::Vertex::ORBIT].size();
+	io::import_OFF_streaming<Vec3>(m2, filename);
+	EXPECT_EQ(m2.nb_darts(), nb_darts);
+	EXPECT_EQ(m2.attribute_containers_[CMap2::Vertex::ORBIT].size(), nb_vertex_lines);
+	EXPECT_EQ((get_attribute<Vec3, CMap2::Vertex>(m2, "position")), position);
+	EXPECT_EQ(test::face_positions(m2, position), faces);
+	std::remove(filename.c_str());
+}
+
+} // namespace cgogn
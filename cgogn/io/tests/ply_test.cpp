@@ -0,0 +1,141 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <cgogn/io/surface_ply.h>
+
+#include "test_meshes.h"
+
+#include <cstdio>
+
+namespace cgogn
+{
+
+using test::Vec3;
+
+/**
+ * \brief fixture: a grid with vertex and face attributes of several PLY types
+ */
+class PLYTest : public ::testing::Test
+{
+protected:
+
+	CMap2 map_;
+	Attribute<Vec3>* position_;
+	Attribute<uint8>* red_;
+	Attribute<float32>* quality_;
+	Attribute<int32>* label_;
+	Attribute<Vec3>* normal_;
+
+	PLYTest()
+	{
+		position_ = test::build_grid(map_, 30u, 20u);
+		red_ = add_attribute<uint8, CMap2::Vertex>(map_, "red");
+		quality_ = add_attribute<float32, CMap2::Vertex>(map_, "quality");
+		label_ = add_attribute<int32, CMap2::Face>(map_, "label");
+		normal_ = add_attribute<Vec3, CMap2::Face>(map_, "normal");
+		uint32 i = 0u;
+		foreach_cell(map_, [&] (CMap2::Vertex v) -> bool
+		{
+			value<uint8>(map_, red_, v) = uint8(i * 37u);
+			value<float32>(map_, quality_, v) = float32(i) / 7.0f;
+			++i;
+			return true;
+		});
+		foreach_cell(map_, [&] (CMap2::Face f) -> bool
+		{
+			value<int32>(map_, label_, f) = int32(i % 11u) - 5;
+			value<Vec3>(map_, normal_, f) = Vec3(0.1 * i, -1.0 / (i + 1.0), 3.0);
+			++i;
+			return true;
+		});
+	}
+
+	void check_round_trip(int32 format, const std::string& name)
+	{
+		const std::string filename = test::temporary_file(name);
+		ASSERT_TRUE(io::export_PLY(map_, position_, filename, format, {red_, quality_}, {label_, normal_}));
+
+		CMap2 m;
+		io::import_PLY<Vec3>(m, filename);
+		std::remove(filename.c_str());
+
+		// the properties keep their declared type
+		Attribute<Vec3>* position = get_attribute<Vec3, CMap2::Vertex>(m, "position");
+		Attribute<uint8>* red = get_attribute<uint8, CMap2::Vertex>(m, "red");
+		Attribute<float32>* quality = get_attribute<float32, CMap2::Vertex>(m, "quality");
+		Attribute<int32>* label = get_attribute<int32, CMap2::Face>(m, "label");
+		Attribute<float64>* normal_y = get_attribute<float64, CMap2::Face>(m, "normal_y");
+		ASSERT_NE(position, nullptr);
+		ASSERT_NE(red, nullptr);
+		ASSERT_NE(quality, nullptr);
+		ASSERT_NE(label, nullptr);
+		ASSERT_NE(normal_y, nullptr);
+
+		EXPECT_EQ(nb_cells<CMap2::Vertex>(m), nb_cells<CMap2::Vertex>(map_));
+		EXPECT_EQ(test::face_positions(m, position), test::face_positions(map_, position_));
+		EXPECT_EQ(test::face_vertex_values(m, red), test::face_vertex_values(map_, red_));
+		EXPECT_EQ(test::face_vertex_values(m, quality), test::face_vertex_values(map_, quality_));
+		EXPECT_EQ(test::face_values(m, label), test::face_values(map_, label_));
+		std::vector<float64> expected_y;
+		for (const Vec3& n : test::face_values(map_, normal_))
+			expected_y.push_back(n[1]);
+		EXPECT_EQ(test::face_values(m, normal_y), expected_y);
+	}
+};
+
+TEST_F(PLYTest, ASCIIRoundTrip)
+{
+	check_round_trip(PLY_ASCII, "round_trip_ascii.ply");
+}
+
+TEST_F(PLYTest, BinaryLittleEndianRoundTrip)
+{
+	check_round_trip(PLY_BINARY_LE, "round_trip_le.ply");
+}
+
+TEST_F(PLYTest, BinaryBigEndianRoundTrip)
+{
+	check_round_trip(PLY_BINARY_BE, "round_trip_be.ply");
+}
+
+TEST_F(PLYTest, IndexListType)
+{
+	const std::string filename = test::temporary_file("index_list.ply");
+	ASSERT_TRUE(io::export_PLY(map_, position_, filename, PLY_ASCII));
+	int32 format;
+	std::vector<io::internal::PLYElement> elements;
+	std::size_t header_size;
+	ASSERT_TRUE(io::internal::read_PLY_header(filename, format, elements, header_size));
+	std::remove(filename.c_str());
+	ASSERT_EQ(elements.size(), 2u);
+	ASSERT_EQ(elements[1].name, "face");
+	ASSERT_EQ(elements[1].properties.size(), 1u);
+	EXPECT_EQ(elements[1].properties[0].name, "vertex_indices");
+	EXPECT_TRUE(elements[1].properties[0].is_list);
+	EXPECT_EQ(elements[1].properties[0].type, PLY_Uint32);
+	EXPECT_EQ(elements[1].properties[0].count_type, PLY_Uint8);
+}
+
+} // namespace cgogn
@@ -0,0 +1,231 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <cgogn/io/surface_stl.h>
+#include <cgogn/io/surface_export.h>
+
+#include "test_meshes.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace cgogn
+{
+
+using test::Vec3;
+
+namespace
+{
+
+// positions of the vertices (rounded to float32 if asked), in lexicographic order
+std::vector<std::array<float64, 3>> sorted_positions(const CMap2& m, const Attribute<Vec3>* position, bool round)
+{
+	std::vector<std::array<float64, 3>> res;
+	foreach_cell(m, [&] (CMap2::Vertex v) -> bool
+	{
+		const Vec3& p = value<Vec3>(m, position, v);
+		res.push_back(round ?
+			std::array<float64, 3>{{float64(float32(p[0])), float64(float32(p[1])), float64(float32(p[2]))}} :
+			std::array<float64, 3>{{p[0], p[1], p[2]}});
+		return true;
+	});
+	std::sort(res.begin(), res.end());
+	return res;
+}
+
+// normals of the triangles of a binary STL file
+std::vector<std::array<float32, 3>> STL_normals(const std::string& filename)
+{
+	std::ifstream in(filename.c_str(), std::ios::binary);
+	const std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+	std::vector<std::array<float32, 3>> res;
+	for (std::size_t offset = 84u; offset + 50u <= content.size(); offset += 50u)
+	{
+		res.emplace_back();
+		std::memcpy(res.back().data(), content.data() + offset, 3u * sizeof(float32));
+		swap_endianness_native_little(res.back().data(), 3u);
+	}
+	return res;
+}
+
+// vertices of the points: clusters of the points connected by pairs at most epsilon apart (brute force)
+std::vector<uint32> brute_force_weld(const std::vector<float64>& points, float64 epsilon)
+{
+	const uint32 n = uint32(points.size() / 3u);
+	std::vector<uint32> root(n);
+	for (uint32 i = 0u; i < n; ++i)
+		root[i] = i;
+	auto find = [&] (uint32 i) -> uint32 { while (root[i] != i) i = root[i]; return i; };
+	for (uint32 i = 0u; i < n; ++i)
+		for (uint32 j = i + 1u; j < n; ++j)
+		{
+			float64 d2 = 0.0;
+			for (uint32 k = 0u; k < 3u; ++k)
+				d2 += (points[3u * i + k] - points[3u * j + k]) * (points[3u * i + k] - points[3u * j + k]);
+			if (d2 <= epsilon * epsilon)
+			{
+				const uint32 a = find(i), b = find(j);
+				root[std::max(a, b)] = std::min(a, b);
+			}
+		}
+	// vertices numbered in order of their first point
+	std::vector<uint32> vertex(n), root_vertex(n, INVALID_INDEX);
+	uint32 nb_vertices = 0u;
+	for (uint32 i = 0u; i < n; ++i)
+	{
+		const uint32 r = find(i);
+		if (root_vertex[r] == INVALID_INDEX)
+			root_vertex[r] = nb_vertices++;
+		vertex[i] = root_vertex[r];
+	}
+	return vertex;
+}
+
+} // namespace
+
+TEST(STLTest, WeldExactPoints)
+{
+	// -0 and +0 are the same coordinate
+	const std::vector<float64> points = { 0, 0, 0, 1, 2, 3, -0.0, 0, 0, 1, 2, 3, 1, 2, 3.5 };
+	std::vector<uint32> point_vertex;
+	std::vector<float64> vertex_position;
+	io::internal::weld_points(points, 0.0, point_vertex, vertex_position);
+	EXPECT_EQ(point_vertex, std::vector<uint32>({0u, 1u, 0u, 1u, 2u}));
+	EXPECT_EQ(vertex_position, std::vector<float64>({0, 0, 0, 1, 2, 3, 1, 2, 3.5}));
+}
+
+TEST(STLTest, WeldNearPoints)
+{
+	// clusters of points around random centers (some of them chained) compared to brute force
+	std::mt19937 rng(5u);
+	std::uniform_real_distribution<float64> center(-3.0, 3.0);
+	std::uniform_real_distribution<float64> jitter(-0.02, 0.02);
+	std::vector<float64> points;
+	for (uint32 i = 0u; i < 400u; ++i)
+	{
+		const float64 c[3] = { center(rng), center(rng), center(rng) };
+		for (uint32 j = 0u; j < 1u + i % 4u; ++j)
+			for (uint32 k = 0u; k < 3u; ++k)
+				points.push_back(c[k] + jitter(rng) + (k == 0u ? 0.03 * j : 0.0));
+	}
+	for (float64 epsilon : { 0.01, 0.03, 0.05, 0.2 })
+	{
+		std::vector<uint32> point_vertex;
+		std::vector<float64> vertex_position;
+		io::internal::weld_points(points, epsilon, point_vertex, vertex_position);
+		EXPECT_EQ(point_vertex, brute_force_weld(points, epsilon)) << "epsilon " << epsilon;
+	}
+}
+
+TEST(STLTest, WeldCollidingCells)
+{
+	// with epsilon = 0.5 (cells of size 1), the cells (0, 0, 0) and (2^21, 0, 0) have the same key:
+	// the points 0 and 2 are in the same group of keys but only the points 0 and 1 are welded
+	const float64 far = float64(1u << 21u);
+	const std::vector<float64> points = {
+		0.9, 0.5, 0.5,
+		1.1, 0.5, 0.5,
+		far + 0.1, 0.5, 0.5
+	};
+	std::vector<uint32> point_vertex;
+	std::vector<float64> vertex_position;
+	io::internal::weld_points(points, 0.5, point_vertex, vertex_position);
+	EXPECT_EQ(point_vertex, std::vector<uint32>({0u, 0u, 1u}));
+	EXPECT_EQ(io::internal::cell_key(0, 0, 0), io::internal::cell_key(int64(far), 0, 0));
+}
+
+TEST(STLTest, WeldAtEpsilon)
+{
+	// points exactly epsilon apart across a side of a cell are welded
+	const std::vector<float64> points = { 0.5, 0.25, 0.25, 1.0, 0.25, 0.25, 0.75, 0.25, 0.25 };
+	std::vector<uint32> point_vertex;
+	std::vector<float64> vertex_position;
+	io::internal::weld_points(std::vector<float64>(points.begin(), points.begin() + 6), 0.5, point_vertex, vertex_position);
+	EXPECT_EQ(point_vertex, std::vector<uint32>({0u, 0u}));
+	io::internal::weld_points(std::vector<float64>(points.begin() + 3, points.end()), 0.25, point_vertex, vertex_position);
+	EXPECT_EQ(point_vertex, std::vector<uint32>({0u, 0u}));
+}
+
+TEST(STLTest, RoundTrip)
+{
+	CMap2 m;
+	Attribute<Vec3>* position = test::build_grid(m, 30u, 20u);
+	const std::string filename = test::temporary_file("round_trip.stl");
+	ASSERT_TRUE(io::export_STL(m, position, filename));
+
+	// the faces are triangulated and the coordinates are rounded to float32
+	uint32 nb_triangles = 0u;
+	foreach_cell(m, [&] (CMap2::Face f) -> bool { nb_triangles += codegree(m, f) - 2u; return true; });
+	CMap2 m2;
+	io::import_STL<Vec3>(m2, filename);
+	std::remove(filename.c_str());
+	Attribute<Vec3>* position2 = get_attribute<Vec3, CMap2::Vertex>(m2, "position");
+	ASSERT_NE(position2, nullptr);
+	EXPECT_EQ(nb_cells<CMap2::Face>(m2), nb_triangles);
+	EXPECT_EQ(sorted_positions(m2, position2, false), sorted_positions(m, position, true));
+}
+
+TEST(STLTest, DegenerateNormals)
+{
+	// a triangle, a flat triangle and a triangle with two equal corners
+	CMap2 m;
+	const std::vector<Vec3> positions = {
+		Vec3(0, 0, 0), Vec3(1, 0, 0), Vec3(0, 1, 0),
+		Vec3(0, 0, 1), Vec3(1, 1, 1), Vec3(2, 2, 1),
+		Vec3(0, 0, 2), Vec3(1, 0, 2), Vec3(0, 0, 2)
+	};
+	build_from_faces(m, positions, {0u, 3u, 6u, 9u}, {0u, 1u, 2u, 3u, 4u, 5u, 6u, 7u, 8u});
+	Attribute<Vec3>* position = get_attribute<Vec3, CMap2::Vertex>(m, "position");
+	const std::string filename = test::temporary_file("degenerate.stl");
+	ASSERT_TRUE(io::export_STL(m, position, filename));
+	const std::vector<std::array<float32, 3>> normals = STL_normals(filename);
+	std::remove(filename.c_str());
+
+	uint32 nb_unit = 0u;
+	uint32 nb_zero = 0u;
+	for (const std::array<float32, 3>& n : normals)
+	{
+		for (float32 x : n)
+			EXPECT_FALSE(std::isnan(x));
+		const float32 norm2 = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+		if (norm2 == 0.0f)
+			++nb_zero;
+		else
+		{
+			EXPECT_NEAR(norm2, 1.0f, 1e-6f);
+			++nb_unit;
+		}
+	}
+	EXPECT_EQ(nb_unit, 1u);
+	EXPECT_EQ(nb_zero, 2u);
+}
+
+} // namespace cgogn
@@ -0,0 +1,147 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_IO_TESTS_TEST_MESHES_H_
+#define CGOGN_IO_TESTS_TEST_MESHES_H_
+
+#include <cgogn/core/types/cmap/cmap2.h>
+#include <cgogn/core/functions/mesh_ops/surface_builder.h>
+#include <cgogn/core/functions/traversals/global.h>
+#include <cgogn/core/functions/traversals/vertex.h>
+#include <cgogn/core/functions/attributes.h>
+#include <cgogn/core/functions/mesh_info.h>
+
+#include <Eigen/Dense>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace cgogn
+{
+
+namespace test
+{
+
+using Vec3 = Eigen::Vector3d;
+
+/**
+ * builds an open grid of nx * ny cells made of quads, pairs of triangles and pentagons,
+ * with random coordinates (all the bits of the doubles are used)
+ */
+inline Attribute<Vec3>* build_grid(CMap2& m, uint32 nx, uint32 ny, uint32 seed = 1u)
+{
+	std::mt19937 rng(seed);
+	std::uniform_real_distribution<double> noise(-0.25, 0.25);
+	std::vector<Vec3> positions;
+	for (uint32 j = 0u; j <= ny; ++j)
+		for (uint32 i = 0u; i <= nx; ++i)
+			positions.emplace_back(i + noise(rng), j + noise(rng), 1e-3 * noise(rng));
+	auto id = [&] (uint32 i, uint32 j) -> uint32 { return j * (nx + 1u) + i; };
+
+	std::vector<uint32> offsets(1u, 0u);
+	std::vector<uint32> indices;
+	auto add = [&] (std::initializer_list<uint32> face)
+	{
+		indices.insert(indices.end(), face);
+		offsets.push_back(uint32(indices.size()));
+	};
+	for (uint32 j = 0u; j < ny; ++j)
+	{
+		for (uint32 i = 0u; i < nx; ++i)
+		{
+			const uint32 a = id(i, j), b = id(i + 1u, j), c = id(i + 1u, j + 1u), d = id(i, j + 1u);
+			switch ((i + 2u * j) % 3u)
+			{
+				case 0u: add({a, b, c, d}); break;
+				case 1u: add({a, b, c}); add({a, c, d}); break;
+				default:
+				{
+					// pentagon with a vertex in the middle of its bottom edge
+					// (a T-junction with the cell below, which keeps the whole edge: the mesh has inner boundaries)
+					const uint32 mid = uint32(positions.size());
+					positions.push_back(0.5 * (positions[a] + positions[b]));
+					add({a, mid, b, c, d});
+				}
+			}
+		}
+	}
+	build_from_faces(m, positions, offsets, indices);
+	return get_attribute<Vec3, CMap2::Vertex>(m, "position");
+}
+
+/**
+ * values of a vertex attribute at the vertices of each face, in traversal order of the faces
+ */
+template <typename T>
+std::vector<std::vector<T>> face_vertex_values(const CMap2& m, const Attribute<T>* attribute)
+{
+	std::vector<std::vector<T>> res;
+	foreach_cell(m, [&] (CMap2::Face f) -> bool
+	{
+		res.emplace_back();
+		foreach_incident_vertex(m, f, [&] (CMap2::Vertex v) -> bool
+		{
+			res.back().push_back(value<T>(m, attribute, v));
+			return true;
+		});
+		return true;
+	});
+	return res;
+}
+
+/**
+ * positions of the vertices of each face, in traversal order of the faces
+ */
+inline std::vector<std::vector<Vec3>> face_positions(const CMap2& m, const Attribute<Vec3>* position)
+{
+	return face_vertex_values(m, position);
+}
+
+/**
+ * values of a face attribute, in traversal order of the faces
+ */
+template <typename T>
+std::vector<T> face_values(const CMap2& m, const Attribute<T>* attribute)
+{
+	std::vector<T> res;
+	foreach_cell(m, [&] (CMap2::Face f) -> bool
+	{
+		res.push_back(value<T>(m, attribute, f));
+		return true;
+	});
+	return res;
+}
+
+inline std::string temporary_file(const std::string& name)
+{
+	return testing::TempDir() + "cgogn_io_test_" + name;
+}
+
+} // namespace test
+
+} // namespace cgogn
+
+#endif // CGOGN_IO_TESTS_TEST_MESHES_H_
@@ -0,0 +1,180 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#include <gtest/gtest.h>
+
+#include <cgogn/io/utils.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace cgogn
+{
+
+namespace
+{
+
+// formats x, checks that the text is not longer than 32 chars and parses it back
+float64 round_trip(float64 x, std::string* text = nullptr)
+{
+	char buffer[64];
+	char* end = io::format_double(buffer, x);
+	EXPECT_LE(end - buffer, 32);
+	if (text)
+		text->assign(buffer, end);
+	const char* p = buffer;
+	float64 y = 0.0;
+	EXPECT_TRUE(io::parse_double(p, end, y)) << std::string(buffer, end);
+	EXPECT_EQ(p, end);
+	return y;
+}
+
+bool same_bits(float64 a, float64 b)
+{
+	return std::memcmp(&a, &b, sizeof(float64)) == 0;
+}
+
+} // namespace
+
+TEST(Grisu2Test, CachedPowers)
+{
+	// 10^k for k = -300, -292, ..., 324 as normalized f * 2^e
+	const std::vector<io::internal::CachedPower>& powers = io::internal::cached_powers_of_10();
+	ASSERT_FALSE(powers.empty());
+	for (std::size_t i = 0u; i < powers.size(); ++i)
+	{
+		const io::internal::CachedPower& c = powers[i];
+		EXPECT_EQ(c.k, -300 + 8 * int32(i));
+		EXPECT_NE(c.f >> 63u, 0u);
+		// f * 2^e / 10^k is 1 up to the rounding of f
+		const long double ratio = std::ldexp(static_cast<long double>(c.f), c.e) / std::pow(10.0L, c.k);
+		EXPECT_NEAR(double(ratio), 1.0, 1e-15) << "k = " << c.k;
+	}
+	// exact powers
+	for (const io::internal::CachedPower& c : powers)
+	{
+		if (c.k < 0 || c.k > 16)
+			continue;
+		uint64 p = 1u;
+		for (int32 i = 0; i < c.k; ++i)
+			p *= 10u;
+		int32 shift = 0;
+		while ((p << shift) >> 63u == 0u)
+			++shift;
+		EXPECT_EQ(c.f, p << shift);
+		EXPECT_EQ(c.e, -shift);
+	}
+}
+
+TEST(Grisu2Test, EdgeCases)
+{
+	const float64 values[] = {
+		0.0, 1.0, -1.0, 0.1, 0.2, 0.3, 1.0 / 3.0, 2.0 / 3.0, 123456789.0, 1e15, 1e16, 1e17, 1e22, 1e23, 9007199254740993.0,
+		5e-324, -5e-324, 2.2250738585072009e-308, std::numeric_limits<float64>::min(), std::numeric_limits<float64>::max(),
+		std::numeric_limits<float64>::lowest(), std::numeric_limits<float64>::epsilon(), 1.7976931348623157e308,
+		4.9406564584124654e-324, 1e-5, 1e-4, 1e-3, 123.456, 0.000123, 9.999999999999999e22, 2.0, 1024.0, 0.5
+	};
+	for (float64 x : values)
+	{
+		std::string text;
+		const float64 y = round_trip(x, &text);
+		EXPECT_TRUE(same_bits(x, y)) << x << " written as " << text;
+	}
+
+	std::string text;
+	round_trip(100.0, &text);
+	EXPECT_EQ(text, "100");
+	round_trip(0.1, &text);
+	EXPECT_EQ(text, "0.1");
+	round_trip(-2.5, &text);
+	EXPECT_EQ(text, "-2.5");
+}
+
+TEST(Grisu2Test, RandomDoubles)
+{
+	std::mt19937_64 rng(12345u);
+	uint32 nb_errors = 0u;
+	for (uint32 i = 0u; i < 1000000u; ++i)
+	{
+		// random bit patterns cover all the exponents (and thus all the cached powers)
+		uint64 bits = rng();
+		float64 x;
+		std::memcpy(&x, &bits, sizeof(float64));
+		if (!std::isfinite(x))
+			continue;
+		const float64 y = round_trip(x);
+		if (!same_bits(x, y) && ++nb_errors < 10u)
+			ADD_FAILURE() << "round trip of " << x << " gives " << y;
+	}
+	EXPECT_EQ(nb_errors, 0u);
+
+	// usual coordinates
+	std::uniform_real_distribution<float64> d(-1000.0, 1000.0);
+	for (uint32 i = 0u; i < 100000u; ++i)
+	{
+		const float64 x = d(rng);
+		EXPECT_TRUE(same_bits(x, round_trip(x)));
+	}
+}
+
+TEST(Grisu2Test, Floats)
+{
+	std::mt19937 rng(7u);
+	for (uint32 i = 0u; i < 100000u; ++i)
+	{
+		uint32 bits = rng();
+		float32 x;
+		std::memcpy(&x, &bits, sizeof(float32));
+		if (!std::isfinite(x))
+			continue;
+		char buffer[64];
+		char* end = io::format_float(buffer, x);
+		const char* p = buffer;
+		float64 y;
+		ASSERT_TRUE(io::parse_double(p, end, y));
+		EXPECT_EQ(float32(y), x) << std::string(buffer, end);
+	}
+}
+
+TEST(ParseDoubleTest, Tokens)
+{
+	const char* texts[] = { "1e5", "-0.0", "+3.25", "1.5E-3", "00012", ".5", "5.", "12345678901234567890123", "1e400" };
+	for (const char* t : texts)
+	{
+		const char* p = t;
+		const char* end = t + std::strlen(t);
+		float64 x;
+		ASSERT_TRUE(io::parse_double(p, end, x)) << t;
+		EXPECT_EQ(x, std::strtod(t, nullptr)) << t;
+		EXPECT_EQ(p, end);
+	}
+	const char* bad = "abc";
+	const char* p = bad;
+	float64 x;
+	EXPECT_FALSE(io::parse_double(p, bad + 3, x));
+}
+
+} // namespace cgogn
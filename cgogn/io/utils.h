@@ -29,6 +29,13 @@
 #include <cgogn/core/utils/numerics.h>
 
 #include <iostream>
+#include <string>
+#include <limits>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <type_traits>
 
 namespace cgogn
 {
@@ -36,7 +43,7 @@ namespace cgogn
 namespace io
 {
 
-std::istream& getline_safe(std::istream& is, std::string& str)
+inline std::istream& getline_safe(std::istream& is, std::string& str)
 {
 	str.clear();
 	std::istream::sentry se(is, true); // http://en.cppreference.com/w/cpp/io/basic_istream/sentry
@@ -63,7 +70,7 @@ std::istream& getline_safe(std::istream& is, std::string& str)
 	}
 }
 
-float64 read_double(std::istream& fp, std::string& line)
+inline float64 read_double(std::istream& fp, std::string& line)
 {
 	fp >> line;
 	while (line[0] == '#')
@@ -74,7 +81,7 @@ float64 read_double(std::istream& fp, std::string& line)
 	return std::stod(line);
 }
 
-uint32 read_uint(std::istream& fp, std::string& line)
+inline uint32 read_uint(std::istream& fp, std::string& line)
 {
 	fp >> line;
 	while (line[0] == '#')
@@ -85,6 +92,536 @@ uint32 read_uint(std::istream& fp, std::string& line)
 	return uint32((std::stoul(line)));
 }
 
+/**
+ * Scanners of ASCII data in memory (e.g. in a MappedFile).
+ * They follow the token rules of read_double / read_uint: tokens are separated by white spaces
+ * and a token starting with '#' comments out the rest of its line.
+ * Numbers are parsed in place, without building any string.
+ */
+
+inline bool is_space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool is_digit(char c)
+{
+	return uint32(c - '0') < 10u;
+}
+
+/**
+ * \brief returns the beginning of the line that follows the one containing p (or end)
+ */
+inline const char* next_line(const char* p, const char* end)
+{
+	const char* n = static_cast<const char*>(std::memchr(p, '\n', std::size_t(end - p)));
+	return n ? n + 1 : end;
+}
+
+/**
+ * \brief skips white spaces and comments, possibly over several lines
+ * \returns the beginning of the next token (or end)
+ */
+inline const char* skip_to_token(const char* p, const char* end)
+{
+	while (p < end)
+	{
+		if (is_space(*p))
+			++p;
+		else if (*p == '#')
+			p = next_line(p, end);
+		else
+			break;
+	}
+	return p;
+}
+
+/**
+ * \brief skips white spaces and comments without leaving the current line
+ * \returns the beginning of the next token of the line, or the position of its end of line (or end)
+ */
+inline const char* skip_to_token_in_line(const char* p, const char* end)
+{
+	while (p < end && *p != '\n')
+	{
+		if (is_space(*p))
+			++p;
+		else if (*p == '#')
+		{
+			const char* n = static_cast<const char*>(std::memchr(p, '\n', std::size_t(end - p)));
+			return n ? n : end;
+		}
+		else
+			break;
+	}
+	return p;
+}
+
+inline const char* skip_token(const char* p, const char* end)
+{
+	while (p < end && !is_space(*p))
+		++p;
+	return p;
+}
+
+/**
+ * \brief parses an unsigned integer token starting at p and moves p after the token
+ */
+inline bool parse_uint(const char*& p, const char* end, uint32& value)
+{
+	const char* q = p;
+	if (q < end && *q == '+')
+		++q;
+	if (q == end || !is_digit(*q))
+		return false;
+	uint64 v = 0u;
+	for (; q < end && is_digit(*q); ++q)
+	{
+		v = v * 10u + uint64(*q - '0');
+		if (v > std::numeric_limits<uint32>::max())
+			return false;
+	}
+	value = uint32(v);
+	p = skip_token(q, end);
+	return true;
+}
+
+/**
+ * \brief parses a floating point token starting at p and moves p after the token.
+ * Decimal numbers with at most 19 significant digits and a small exponent are converted exactly
+ * by a single multiplication or division by a power of 10; the other ones go through strtod.
+ */
+inline bool parse_double(const char*& p, const char* end, float64& value)
+{
+	static const float64 powers_of_10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+
+	const char* q = p;
+	bool negative = false;
+	if (q < end && (*q == '-' || *q == '+'))
+		negative = *q++ == '-';
+
+	uint64 mantissa = 0u;
+	uint32 nb_digits = 0u; // significant digits kept in the mantissa
+	int32 exponent = 0;
+	bool truncated = false;
+	bool has_digits = false;
+
+	for (; q < end && is_digit(*q); ++q)
+	{
+		has_digits = true;
+		if (nb_digits < 19u)
+		{
+			mantissa = mantissa * 10u + uint64(*q - '0');
+			if (mantissa != 0u)
+				++nb_digits;
+		}
+		else
+		{
+			++exponent;
+			truncated |= *q != '0';
+		}
+	}
+	if (q < end && *q == '.')
+	{
+		for (++q; q < end && is_digit(*q); ++q)
+		{
+			has_digits = true;
+			if (nb_digits < 19u)
+			{
+				mantissa = mantissa * 10u + uint64(*q - '0');
+				if (mantissa != 0u)
+					++nb_digits;
+				--exponent;
+			}
+			else
+				truncated |= *q != '0';
+		}
+	}
+	if (has_digits && q < end && (*q == 'e' || *q == 'E'))
+	{
+		const char* e = q + 1;
+		bool negative_exponent = false;
+		if (e < end && (*e == '-' || *e == '+'))
+			negative_exponent = *e++ == '-';
+		if (e < end && is_digit(*e))
+		{
+			int32 x = 0;
+			for (; e < end && is_digit(*e); ++e)
+				x = x < 100000 ? x * 10 + (*e - '0') : x;
+			exponent += negative_exponent ? -x : x;
+			q = e;
+		}
+	}
+
+	if (has_digits && !truncated && mantissa < (uint64(1) << 53) && exponent >= -22 && exponent <= 22)
+	{
+		float64 v = float64(mantissa);
+		v = exponent < 0 ? v / powers_of_10[-exponent] : v * powers_of_10[exponent];
+		value = negative ? -v : v;
+		p = skip_token(q, end);
+		return true;
+	}
+
+	// slow path (long mantissas, large exponents, inf, nan): strtod on a null terminated copy of the token
+	// (in a local buffer, or in a string for the very long tokens)
+	const char* token_end = skip_token(p, end);
+	const std::size_t length = std::size_t(token_end - p);
+	if (length == 0u)
+		return false;
+	char local_buffer[128];
+	std::string long_buffer;
+	char* buffer = local_buffer;
+	if (length >= sizeof(local_buffer))
+	{
+		long_buffer.assign(p, length);
+		buffer = &long_buffer[0];
+	}
+	else
+	{
+		std::memcpy(buffer, p, length);
+		buffer[length] = '\0';
+	}
+	char* parsed_end;
+	value = std::strtod(buffer, &parsed_end);
+	if (parsed_end == buffer)
+		return false;
+	p = token_end;
+	return true;
+}
+
+/**
+ * Formatters of ASCII data into buffers (e.g. the blocks of an export).
+ * They write the text of a number at p, where at least 32 chars must be available,
+ * and return the end of the written text (no null character is added).
+ * Floating point numbers are written with the Grisu2 algorithm (F. Loitsch, Printing floating-point numbers
+ * quickly and accurately with integers, 2010): the digits are short (most often the shortest ones)
+ * and are always read back to the same value.
+ */
+
+inline char* format_uint(char* p, uint64 value)
+{
+	char digits[20];
+	uint32 n = 0u;
+	do
+	{
+		digits[n++] = char('0' + value % 10u);
+		value /= 10u;
+	} while (value != 0u);
+	while (n > 0u)
+		*p++ = digits[--n];
+	return p;
+}
+
+inline char* format_int(char* p, int64 value)
+{
+	if (value < 0)
+	{
+		*p++ = '-';
+		return format_uint(p, uint64(0) - uint64(value));
+	}
+	return format_uint(p, uint64(value));
+}
+
+namespace internal
+{
+
+// floating point number f * 2^e
+struct DiyFp
+{
+	uint64 f;
+	int32 e;
+};
+
+// product rounded to 64 bits
+inline DiyFp diy_fp_mul(const DiyFp& x, const DiyFp& y)
+{
+	const uint64 a = x.f >> 32u, b = x.f & 0xFFFFFFFFu;
+	const uint64 c = y.f >> 32u, d = y.f & 0xFFFFFFFFu;
+	const uint64 ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+	const uint64 middle = (bd >> 32u) + (ad & 0xFFFFFFFFu) + (bc & 0xFFFFFFFFu) + (uint64(1) << 31u);
+	return { ac + (ad >> 32u) + (bc >> 32u) + (middle >> 32u), x.e + y.e + 64 };
+}
+
+inline DiyFp diy_fp_normalize(DiyFp x)
+{
+	while ((x.f >> 63u) == 0u)
+	{
+		x.f <<= 1u;
+		--x.e;
+	}
+	return x;
+}
+
+struct CachedPower
+{
+	uint64 f;
+	int32 e;
+	int32 k;
+};
+
+/**
+ * normalized approximations f * 2^e, rounded to nearest, of 10^k for k = -300, -292, ..., 324
+ * (computed once with exact big integer arithmetic)
+ */
+inline const std::vector<CachedPower>& cached_powers_of_10()
+{
+	static const std::vector<CachedPower> powers = [] () -> std::vector<CachedPower>
+	{
+		// little endian big integers on 32 bits limbs
+		auto mul_small = [] (std::vector<uint32>& x, uint32 m)
+		{
+			uint64 carry = 0u;
+			for (uint32& l : x)
+			{
+				carry += uint64(l) * m;
+				l = uint32(carry);
+				carry >>= 32u;
+			}
+			if (carry)
+				x.push_back(uint32(carry));
+		};
+		auto div_small = [] (std::vector<uint32>& x, uint32 d)
+		{
+			uint64 remainder = 0u;
+			for (std::size_t i = x.size(); i-- > 0u;)
+			{
+				remainder = (remainder << 32u) | x[i];
+				x[i] = uint32(remainder / d);
+				remainder %= d;
+			}
+			while (!x.empty() && x.back() == 0u)
+				x.pop_back();
+		};
+		auto bit_length = [] (const std::vector<uint32>& x) -> int32
+		{
+			int32 n = 32 * int32(x.size());
+			for (uint32 top = x.back(); (top & 0x80000000u) == 0u; top <<= 1u)
+				--n;
+			return n;
+		};
+		auto bit = [] (const std::vector<uint32>& x, int32 i) -> uint64
+		{
+			return i >= 0 && std::size_t(i / 32) < x.size() ? (x[std::size_t(i / 32)] >> (i % 32)) & 1u : 0u;
+		};
+		// rounds the bits of x from bit 'low' (excluded) to bit 'low + 64' to a normalized CachedPower
+		auto round_bits = [&] (const std::vector<uint32>& x, int32 low, int32 e, int32 k) -> CachedPower
+		{
+			uint64 f = 0u;
+			for (int32 i = low + 64; i > low; --i)
+				f = (f << 1u) | bit(x, i);
+			const uint64 r = f + bit(x, low);
+			return r == 0u ? CachedPower{ uint64(1) << 63u, e + 1, k } : CachedPower{ r, e, k };
+		};
+
+		std::vector<CachedPower> result;
+		for (int32 k = -300; k <= 324; k += 8)
+		{
+			std::vector<uint32> x(1u, 1u);
+			if (k >= 0)
+			{
+				// 10^k = x, rounded to its 64 leading bits
+				for (int32 i = 0; i < k; ++i)
+					mul_small(x, 10u);
+				const int32 length = bit_length(x);
+				result.push_back(round_bits(x, length - 65, length - 64, k));
+			}
+			else
+			{
+				// 10^k ~ floor(2^(s+1) / 10^-k) / 2^(s+1), with s such that the quotient has 65 bits
+				std::vector<uint32> p(1u, 1u);
+				for (int32 i = 0; i < -k; ++i)
+					mul_small(p, 10u);
+				const int32 s = bit_length(p) + 63;
+				x.assign(std::size_t(s + 1) / 32u + 1u, 0u);
+				x.back() = 1u << uint32((s + 1) % 32);
+				int32 n = -k;
+				for (; n >= 9; n -= 9)
+					div_small(x, 1000000000u);
+				for (; n > 0; --n)
+					div_small(x, 10u);
+				result.push_back(round_bits(x, 0, -s, k));
+			}
+		}
+		return result;
+	}();
+	return powers;
+}
+
+/**
+ * Grisu2 digit generation of the decimal representation of the positive finite value:
+ * writes its digits in buffer and returns their number, the value being digits * 10^decimal_exponent
+ */
+template <typename T>
+inline uint32 grisu2(char* buffer, int32& decimal_exponent, T value)
+{
+	using Bits = typename std::conditional<sizeof(T) == 4u, uint32, uint64>::type;
+	static const int32 PRECISION = std::numeric_limits<T>::digits; // with the hidden bit
+	static const int32 BIAS = std::numeric_limits<T>::max_exponent - 1 + (PRECISION - 1);
+	static const uint64 HIDDEN_BIT = uint64(1) << (PRECISION - 1);
+	static const int32 ALPHA = -60;
+
+	// value and boundaries of its rounding interval
+	Bits bits;
+	std::memcpy(&bits, &value, sizeof(T));
+	const uint64 exponent_bits = uint64(bits) >> (PRECISION - 1);
+	const uint64 fraction = uint64(bits) & (HIDDEN_BIT - 1u);
+	const DiyFp v = exponent_bits == 0u ?
+		DiyFp{ fraction, 1 - BIAS } : DiyFp{ fraction + HIDDEN_BIT, int32(exponent_bits) - BIAS };
+	const bool lower_boundary_is_closer = fraction == 0u && exponent_bits > 1u;
+	const DiyFp m_plus = diy_fp_normalize(DiyFp{ 2u * v.f + 1u, v.e - 1 });
+	DiyFp m_minus = lower_boundary_is_closer ? DiyFp{ 4u * v.f - 1u, v.e - 2 } : DiyFp{ 2u * v.f - 1u, v.e - 1 };
+	m_minus = DiyFp{ m_minus.f << uint32(m_minus.e - m_plus.e), m_plus.e };
+
+	// scaling by a cached power of 10 so that the exponent of the products is in [ALPHA, ALPHA + 28]
+	const int32 f = ALPHA - m_plus.e - 1;
+	const int32 k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);
+	const CachedPower& cached = cached_powers_of_10()[std::size_t((300 + k + 7) / 8)];
+	const DiyFp c = { cached.f, cached.e };
+	const DiyFp w = diy_fp_mul(diy_fp_normalize(v), c);
+	const DiyFp w_minus = diy_fp_mul(m_minus, c);
+	const DiyFp w_plus = diy_fp_mul(m_plus, c);
+	const DiyFp low = { w_minus.f + 1u, w_minus.e };
+	const DiyFp high = { w_plus.f - 1u, w_plus.e };
+	decimal_exponent = -cached.k;
+
+	// digits of high, until they are in the interval [low, high]
+	uint64 delta = high.f - low.f;
+	uint64 dist = high.f - w.f;
+	const uint32 shift = uint32(-high.e);
+	const uint64 one = uint64(1) << shift;
+	uint32 p1 = uint32(high.f >> shift);
+	uint64 p2 = high.f & (one - 1u);
+	uint32 length = 0u;
+
+	// approaches w from above by decrementing the last digit while possible
+	auto round_weed = [&] (uint64 rest, uint64 ten_k)
+	{
+		while (rest < dist && delta - rest >= ten_k && (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+		{
+			--buffer[length - 1u];
+			rest += ten_k;
+		}
+	};
+
+	uint32 pow10 = 1000000000u;
+	int32 n = 10;
+	while (n > 1 && p1 < pow10)
+	{
+		pow10 /= 10u;
+		--n;
+	}
+	while (n > 0)
+	{
+		buffer[length++] = char('0' + p1 / pow10);
+		p1 %= pow10;
+		--n;
+		const uint64 rest = (uint64(p1) << shift) + p2;
+		if (rest <= delta)
+		{
+			decimal_exponent += n;
+			round_weed(rest, uint64(pow10) << shift);
+			return length;
+		}
+		pow10 /= 10u;
+	}
+	int32 m = 0;
+	for (;;)
+	{
+		p2 *= 10u;
+		buffer[length++] = char('0' + (p2 >> shift));
+		p2 &= one - 1u;
+		++m;
+		delta *= 10u;
+		dist *= 10u;
+		if (p2 <= delta)
+			break;
+	}
+	decimal_exponent -= m;
+	round_weed(p2, one);
+	return length;
+}
+
+template <typename T>
+inline char* format_floating_point(char* p, T value)
+{
+	if (std::isnan(value))
+	{
+		std::memcpy(p, "nan", 3u);
+		return p + 3;
+	}
+	if (std::signbit(value))
+	{
+		*p++ = '-';
+		value = -value;
+	}
+	if (std::isinf(value))
+	{
+		std::memcpy(p, "inf", 3u);
+		return p + 3;
+	}
+	if (value == T(0))
+	{
+		*p++ = '0';
+		return p;
+	}
+
+	char digits[20];
+	int32 decimal_exponent;
+	const int32 length = int32(grisu2(digits, decimal_exponent, value));
+	const int32 n = length + decimal_exponent; // position of the decimal point
+	if (length <= n && n <= 15)
+	{
+		// integer: digits followed by zeros
+		std::memcpy(p, digits, std::size_t(length));
+		std::memset(p + length, '0', std::size_t(n - length));
+		return p + n;
+	}
+	if (0 < n && n <= 15)
+	{
+		std::memcpy(p, digits, std::size_t(n));
+		p[n] = '.';
+		std::memcpy(p + n + 1, digits + n, std::size_t(length - n));
+		return p + length + 1;
+	}
+	if (-4 < n && n <= 0)
+	{
+		p[0] = '0';
+		p[1] = '.';
+		std::memset(p + 2, '0', std::size_t(-n));
+		std::memcpy(p + 2 - n, digits, std::size_t(length));
+		return p + 2 - n + length;
+	}
+	// scientific notation
+	*p++ = digits[0];
+	if (length > 1)
+	{
+		*p++ = '.';
+		std::memcpy(p, digits + 1, std::size_t(length - 1));
+		p += length - 1;
+	}
+	*p++ = 'e';
+	*p++ = n - 1 < 0 ? '-' : '+';
+	const int32 e = n - 1 < 0 ? 1 - n : n - 1;
+	if (e < 10)
+		*p++ = '0';
+	return format_uint(p, uint64(e));
+}
+
+} // namespace internal
+
+inline char* format_double(char* p, float64 value)
+{
+	return internal::format_floating_point(p, value);
+}
+
+inline char* format_float(char* p, float32 value)
+{
+	return internal::format_floating_point(p, value);
+}
+
 } // namespace io
 
 } // namespace cgogn
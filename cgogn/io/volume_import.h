@@ -0,0 +1,236 @@
+/*******************************************************************************
+* CGoGN: Combinatorial and Geometric modeling with Generic N-dimensional Maps  *
+* Copyright (C) 2015, IGG Group, ICube, University of Strasbourg, France       *
+*                                                                              *
+* This library is free software; you can redistribute it and/or modify it      *
+* under the terms of the GNU Lesser General Public License as published by the *
+* Free Software Foundation; either version 2.1 of the License, or (at your     *
+* option) any later version.                                                   *
+*                                                                              *
+* This library is distributed in the hope that it will be useful, but WITHOUT  *
+* ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or        *
+* FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License  *
+* for more details.                                                            *
+*                                                                              *
+* You should have received a copy of the GNU Lesser General Public License     *
+* along with this library; if not, write to the Free Software Foundation,      *
+* Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA.           *
+*                                                                              *
+* Web site: http://cgogn.unistra.fr/                                           *
+* Contact information: cgogn@unistra.fr                                        *
+*                                                                              *
+*******************************************************************************/
+
+#ifndef CGOGN_IO_VOLUME_IMPORT_H_
+#define CGOGN_IO_VOLUME_IMPORT_H_
+
+#include <cgogn/core/utils/numerics.h>
+#include <cgogn/core/types/mesh_traits.h>
+#include <cgogn/core/functions/attributes.h>
+#include <cgogn/core/functions/mesh_ops/volume_builder.h>
+#include <cgogn/core/utils/thread_pool.h>
+
+#include <libmeshb.h>
+
+#include <vector>
+#include <string>
+#include <array>
+#include <iostream>
+
+namespace cgogn
+{
+
+namespace io
+{
+
+/**
+ * \brief raw content of a volume mesh file: vertex coordinates (3 per vertex, in file order)
+ * and vertex indices of the tetrahedra (4 per volume), pyramids (5), prisms (6) and hexahedra (8),
+ * numbered as in the Medit format
+ */
+struct VolumeImportData
+{
+	std::vector<float64> vertex_position;
+	std::vector<uint32> tetrahedra;
+	std::vector<uint32> pyramids;
+	std::vector<uint32> prisms;
+	std::vector<uint32> hexahedra;
+
+	uint32 nb_vertices() const { return uint32(vertex_position.size() / 3u); }
+	uint32 nb_volumes() const
+	{
+		return uint32(tetrahedra.size() / 4u + pyramids.size() / 5u + prisms.size() / 6u + hexahedra.size() / 8u);
+	}
+};
+
+namespace internal
+{
+
+/**
+ * reorients the volumes of negative orientation (the sign of the determinant of 3 edges of a corner)
+ * by a mirror permutation of their vertices
+ */
+inline void orient_volumes(VolumeImportData& data)
+{
+	struct Type { std::vector<uint32>* indices; uint32 size; std::array<uint32, 4u> corner; std::vector<uint32> mirror; };
+	const std::array<Type, 4u> types = {
+		Type{ &data.tetrahedra, 4u, {0u, 1u, 2u, 3u}, {0u, 2u, 1u, 3u} },
+		Type{ &data.pyramids, 5u, {0u, 1u, 3u, 4u}, {0u, 3u, 2u, 1u, 4u} },
+		Type{ &data.prisms, 6u, {0u, 1u, 2u, 3u}, {3u, 4u, 5u, 0u, 1u, 2u} },
+		Type{ &data.hexahedra, 8u, {0u, 1u, 3u, 4u}, {4u, 5u, 6u, 7u, 0u, 1u, 2u, 3u} }
+	};
+	const float64* p = data.vertex_position.data();
+	for (const Type& t : types)
+	{
+		std::vector<uint32>& indices = *t.indices;
+		parallel_for(uint32(indices.size() / t.size), [&] (uint32 v)
+		{
+			uint32* vertices = &indices[std::size_t(v) * t.size];
+			const float64* o = p + 3u * vertices[t.corner[0]];
+			const float64* a = p + 3u * vertices[t.corner[1]];
+			const float64* b = p + 3u * vertices[t.corner[2]];
+			const float64* c = p + 3u * vertices[t.corner[3]];
+			const float64 u[3] = { a[0] - o[0], a[1] - o[1], a[2] - o[2] };
+			const float64 w[3] = { b[0] - o[0], b[1] - o[1], b[2] - o[2] };
+			const float64 z[3] = { c[0] - o[0], c[1] - o[1], c[2] - o[2] };
+			const float64 det =
+				u[0] * (w[1] * z[2] - w[2] * z[1]) - u[1] * (w[0] * z[2] - w[2] * z[0]) + u[2] * (w[0] * z[1] - w[1] * z[0]);
+			if (det >= 0.0)
+				return;
+			std::array<uint32, 8u> mirrored;
+			for (uint32 k = 0u; k < t.size; ++k)
+				mirrored[k] = vertices[t.mirror[k]];
+			std::copy(mirrored.begin(), mirrored.begin() + t.size, vertices);
+		});
+	}
+}
+
+} // namespace internal
+
+/**
+ * \brief builds a volume mesh in the given map from imported data: the vertices get a "position" attribute
+ */
+template <typename VEC3>
+void import_volume_data(CMap3& m, const VolumeImportData& data)
+{
+	const uint32 nb_vertices = data.nb_vertices();
+
+	auto position = get_attribute<VEC3, CMap3::Vertex>(m, "position");
+	if (!position)
+		position = add_attribute<VEC3, CMap3::Vertex>(m, "position");
+
+	uint32 first_vertex = 0u;
+	const VolumeSewingReport report =
+		build_volumes(m, nb_vertices, data.tetrahedra, data.pyramids, data.prisms, data.hexahedra, &first_vertex);
+
+	parallel_for(nb_vertices, [&] (uint32 i)
+	{
+		const float64* p = &data.vertex_position[3u * i];
+		(*position)[first_vertex + i] = VEC3{p[0], p[1], p[2]};
+	});
+	position->notify_modification();
+
+	if (report.nb_boundary_faces > 0u)
+		std::cout << report.nb_boundary_faces << " boundary faces, " << report.nb_boundary_volumes << " boundary volume(s)" << std::endl;
+	if (report.nb_non_manifold_faces > 0u)
+		std::cout << report.nb_non_manifold_faces << " non manifold faces" << std::endl;
+}
+
+namespace internal
+{
+
+// reads the vertex indices of the elements of the given keyword (without their reference) with one block read
+inline bool read_MESHB_elements(int64_t mesh, int keyword, uint32 size, uint32 nb_vertices, std::vector<uint32>& indices)
+{
+	const int64_t nb = GmfStatKwd(mesh, keyword);
+	indices.clear();
+	if (nb <= 0)
+		return true;
+
+	std::vector<int32> file_indices(std::size_t(nb) * size);
+	std::vector<int32> references(static_cast<std::size_t>(nb));
+	if (!GmfGetBlock(mesh, keyword, 1, nb, 0, nullptr, nullptr,
+		GmfIntTab, int(size), &file_indices[0], &file_indices[std::size_t(nb - 1) * size],
+		GmfInt, &references[0], &references[std::size_t(nb - 1)]))
+		return false;
+
+	// indices start at 1 in the file
+	indices.resize(file_indices.size());
+	return parallel_transform_reduce(uint32(indices.size()), true,
+		[] (bool a, bool b) { return a && b; },
+		[&] (uint32 i)
+		{
+			indices[i] = uint32(file_indices[i] - 1);
+			return file_indices[i] >= 1 && uint32(file_indices[i]) <= nb_vertices;
+		});
+}
+
+} // namespace internal
+
+/**
+ * \brief reads a Medit mesh file (ASCII .mesh or binary .meshb) into data
+ * The file is read by libMeshb: the vertices and each type of element are loaded with one block read
+ * (buffered asynchronous reads of the binary file), the references are ignored.
+ * The volumes are reoriented if needed (see internal::orient_volumes).
+ */
+inline bool parse_MESHB(const std::string& filename, VolumeImportData& data)
+{
+	int version = 0;
+	int dimension = 0;
+	const int64_t mesh = GmfOpenMesh(filename.c_str(), GmfRead, &version, &dimension);
+	if (!mesh)
+	{
+		std::cerr << "Unable to open file \"" << filename << "\"." << std::endl;
+		return false;
+	}
+	if (dimension != 3)
+	{
+		std::cerr << "File \"" << filename << "\": the dimension must be 3." << std::endl;
+		GmfCloseMesh(mesh);
+		return false;
+	}
+
+	bool success = true;
+	const int64_t nb_vertices = GmfStatKwd(mesh, GmfVertices);
+	data.vertex_position.resize(3u * std::size_t(std::max<int64_t>(nb_vertices, 0)));
+	if (nb_vertices > 0)
+	{
+		std::vector<int32> references(static_cast<std::size_t>(nb_vertices));
+		float64* p = data.vertex_position.data();
+		const std::size_t last = 3u * std::size_t(nb_vertices - 1);
+		success = GmfGetBlock(mesh, GmfVertices, 1, nb_vertices, 0, nullptr, nullptr,
+			GmfDouble, &p[0], &p[last], GmfDouble, &p[1], &p[last + 1u], GmfDouble, &p[2], &p[last + 2u],
+			GmfInt, &references[0], &references[std::size_t(nb_vertices - 1)]) != 0;
+	}
+
+	const uint32 nbv = data.nb_vertices();
+	success = success &&
+		internal::read_MESHB_elements(mesh, GmfTetrahedra, 4u, nbv, data.tetrahedra) &&
+		internal::read_MESHB_elements(mesh, GmfPyramids, 5u, nbv, data.pyramids) &&
+		internal::read_MESHB_elements(mesh, GmfPrisms, 6u, nbv, data.prisms) &&
+		internal::read_MESHB_elements(mesh, GmfHexahedra, 8u, nbv, data.hexahedra);
+	GmfCloseMesh(mesh);
+
+	if (!success)
+	{
+		std::cerr << "File \"" << filename << "\": invalid vertex or volume data." << std::endl;
+		return false;
+	}
+
+	internal::orient_volumes(data);
+	return true;
+}
+
+template <typename VEC3>
+void import_MESHB(CMap3& m, const std::string& filename)
+{
+	VolumeImportData data;
+	if (parse_MESHB(filename, data))
+		import_volume_data<VEC3>(m, data);
+}
+
+} // namespace io
+
+} // namespace cgogn
+
+#endif // CGOGN_IO_VOLUME_IMPORT_H_
@@ -12,6 +12,30 @@ set(${result}  ${FIND_MARCHNATIVE} PARENT_SCOPE)
 endfunction()
 
 
+function(check_avx512 result)
+set(CMAKE_REQUIRED_FLAGS)
+
+if(NOT MSVC)
+	set(CMAKE_REQUIRED_FLAGS "-mavx512f -mavx2 -mfma")
+elseif(NOT CMAKE_CL_64)
+	set(CMAKE_REQUIRED_FLAGS "/arch:AVX512")
+endif()
+
+check_cxx_source_runs("
+	#include <immintrin.h>
+	int main()
+	{
+		__m512d a = _mm512_set_pd(-1.0, 2.0, -3.0, 4.0, -1.0, 2.0, -3.0, 4.0);
+		__m512d b = _mm512_sqrt_pd(_mm512_mul_pd(a, a));
+		double r[8];
+		_mm512_storeu_pd(r, b);
+		return r[0] == 4.0 ? 0 : 1;
+	}" FIND_AVX_512)
+
+set(${result} ${FIND_AVX_512} PARENT_SCOPE)
+endfunction()
+
+
 function(check_avx2 result)
 set(CMAKE_REQUIRED_FLAGS)
 
@@ -202,6 +226,7 @@ macro(CGOGN_CHECK_FOR_SSE)
 	set(CMAKE_REQUIRED_FLAGS)
 
 	# check_marchnative(HAVE_MARCH_NATIVE)
+	check_avx512(HAVE_AVX512_EXTENSIONS)
 	check_avx2(HAVE_AVX2_EXTENSIONS)
 	check_avx1(HAVE_AVX1_EXTENSIONS)
 	check_sse42(HAVE_SSE4_2_EXTENSIONS)
@@ -215,7 +240,10 @@ macro(CGOGN_CHECK_FOR_SSE)
 		# 	set(CGOGN_SSE_FLAGS "${CGOGN_SSE_FLAGS} -march=native")
 		# endif()
 
-		if (HAVE_AVX2_EXTENSIONS)
+		if (HAVE_AVX512_EXTENSIONS)
+			message(STATUS "avx512 support detected.")
+			set(CGOGN_SSE_FLAGS ${CGOGN_SSE_FLAGS} -mavx512f -mavx2 -mfma -mfpmath=sse)
+		elseif (HAVE_AVX2_EXTENSIONS)
 			message(STATUS "avx2 support detected.")
 			set(CGOGN_SSE_FLAGS ${CGOGN_SSE_FLAGS} -mavx2 -mfpmath=sse)
 		elseif (HAVE_AVX1_EXTENSIONS)
@@ -241,7 +269,10 @@ macro(CGOGN_CHECK_FOR_SSE)
 			set(CGOGN_SSE_FLAGS -ffloat-store)
 		endif()
 	else(NOT MSVC)
-		if (HAVE_AVX2_EXTENSIONS)
+		if (HAVE_AVX512_EXTENSIONS)
+			message(STATUS "avx512 support detected.")
+			set(CGOGN_SSE_FLAGS ${CGOGN_SSE_FLAGS} /arch:AVX512)
+		elseif (HAVE_AVX2_EXTENSIONS)
 			message(STATUS "avx2 support detected.")
 			set(CGOGN_SSE_FLAGS ${CGOGN_SSE_FLAGS} /arch:AVX2)
 		elseif (HAVE_AVX1_EXTENSIONS)
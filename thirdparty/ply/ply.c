@@ -2737,7 +2737,8 @@ void close_ply(PlyFile *plyfile)
 
 
 /******************************************************************************
-Free the memory used by a PLY file.
+Free the memory used by a PLY file (including the descriptions of its elements,
+its comments and its object information).
 
 Entry:
   plyfile - identifier of file
@@ -2745,6 +2746,36 @@ Entry:
 
 void free_ply(PlyFile *plyfile)
 {
+	int i,j;
+	PlyElement *elem;
+
+	/* free up the element and property descriptions */
+	for (i = 0; i < plyfile->num_elem_types; i++) {
+		elem = plyfile->elems[i];
+		if (elem->nprops > 0) {
+			for (j = 0; j < elem->nprops; j++) {
+				free (elem->props[j]->name);
+				free (elem->props[j]);
+			}
+			free (elem->props);
+			free (elem->store_prop);
+		}
+		free (elem->name);
+		free (elem);
+	}
+	if (plyfile->num_elem_types > 0)
+		free (plyfile->elems);
+
+	/* free up the comments and object information */
+	for (i = 0; i < plyfile->num_comments; i++)
+		free (plyfile->comments[i]);
+	if (plyfile->num_comments > 0)
+		free (plyfile->comments);
+	for (i = 0; i < plyfile->num_obj_info; i++)
+		free (plyfile->obj_info[i]);
+	if (plyfile->num_obj_info > 0)
+		free (plyfile->obj_info);
+
 	/* free up memory associated with the PLY file */
 	free (plyfile);
 }